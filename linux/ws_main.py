@@ -138,6 +138,7 @@ cmn_src = SrcGroup(dir='src/common',
 net_src = SrcGroup(dir='src/common/Network/Packet',
         src_list=[
            'CPktCmn.cpp',
+           'CPktCsum.cpp',
            'EthernetHeader.cpp',
            'IPHeader.cpp',
            'TCPHeader.cpp',
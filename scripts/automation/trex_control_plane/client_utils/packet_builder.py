@@ -862,6 +862,7 @@ class CTRexPktBuilder(object):
                 self.init_value = 1
                 self.min_value = self.init_value
                 self.max_value = self.init_value
+                self.step = 1
 
             def set_field(self, field_name, val):
                 """
@@ -889,7 +890,7 @@ class CTRexPktBuilder(object):
                         raise CTRexPktBuilder.VMFieldTypeError("size", int)
                     elif val not in self.VALID_SIZE:
                         raise CTRexPktBuilder.VMFieldValueError("size", self.VALID_SIZE)
-                elif field_name in ["init_value", "min_value", "max_value"]:
+                elif field_name in ["init_value", "min_value", "max_value", "step"]:
                     if type(val) != int:
                         raise CTRexPktBuilder.VMFieldTypeError(field_name, int)
                 elif field_name == "operation":
@@ -920,7 +921,8 @@ class CTRexPktBuilder(object):
                         # "split_by_core": self.split_by_core,
                         "init_value": str(self.init_value),
                         "min_value": str(self.min_value),
-                        "max_value": str(self.max_value)}
+                        "max_value": str(self.max_value),
+                        "step": str(self.step)}
 
         class CTRexVMChecksumInst(CVMAbstractInstruction):
 
@@ -722,6 +722,9 @@ void CPreviewMode::Dump(FILE *fd){
     fprintf(fd," mac_ip_features : %d\n", (int)get_mac_ip_features_enable()?1:0 );
     fprintf(fd," mac_ip_map : %d\n", (int)get_mac_ip_mapping_enable()?1:0 );
     fprintf(fd," vm mode         : %d\n", (int)get_vm_one_queue_enable()?1:0 );
+    fprintf(fd," odp zero copy   : %d\n", (int)getODPZeroCopy()?1:0 );
+    fprintf(fd," l4 checksum     : %d\n", (int)getL4Checksum()?1:0 );
+    fprintf(fd," stl static mbuf : %d\n", (int)getStlStaticMbuf()?1:0 );
 }
 
 void CFlowGenStats::clear(){
@@ -1827,6 +1830,11 @@ bool CFlowPktInfo::Create(CPacketIndication  * pkt_ind){
     /* clone of the offsets */
     m_pkt_indication.Clone(pkt_ind,m_packet);
 
+    /* the generator updates the ipv4 checksum incrementally */
+    if ( m_pkt_indication.l3.m_ipv4 && !m_pkt_indication.is_ipv6() ) {
+        m_pkt_indication.l3.m_ipv4->updateCheckSum();
+    }
+
     int i;
     for (i=0; i<MAX_SOCKETS_SUPPORTED; i++) {
         m_big_mbuf[i] = NULL;
@@ -3147,10 +3155,15 @@ bool  CNodeGenerator::Create(CFlowGenListPerThread  *  parent){
    m_socket_id =0;
    m_is_realtime =CGlobalInfo::is_realtime();
    m_realtime_his.Create();
+   m_p_queue.Create((double)CGlobalInfo::m_options.m_sched_tick_usec*1e-6);
+   m_stl_burst_events = 0;
+   m_stl_burst_pkts = 0;
+   m_stl_burst_max_span = 0.0;
    return(true);
 }
 
 void  CNodeGenerator::Delete(){
+    m_p_queue.Delete();
     m_realtime_his.Delete();
 }
 
@@ -3247,7 +3260,8 @@ bool CFlowGenListPerThread::Create(uint32_t           thread_id,
 
     printf(" pool %p \n",m_node_pool);
     m_node_gen.Create(this);
-    m_flow_id_to_node_lookup.Create();
+    /* a flow waits for NAT learning while its node is alive, the node pool bounds the map */
+    m_flow_id_to_node_lookup.Create(CGlobalInfo::m_memory_cfg.get_each_core_dp_flows());
 
     /* split the clients to threads */
     CTupleGenYamlInfo * tuple_gen = &m_flow_list->m_yaml_info.m_tuple_gen;
@@ -3472,6 +3486,9 @@ void CNodeGenerator::dump_json(std::string & json){
 
     json="{\"name\":\"tx-gen\",\"type\":0,\"data\":{";
     m_realtime_his.dump_json("realtime-hist",json);
+    json+=add_json("stl_burst_events",m_stl_burst_events);
+    json+=add_json("stl_burst_pkts",m_stl_burst_pkts);
+    json+=add_json("stl_burst_max_span_usec",m_stl_burst_max_span*1e6);
     json+="\"unknown\":0}}" ;
 }
 
@@ -3482,7 +3499,11 @@ int CNodeGenerator::flush_file(dsec_t max_time,
                                CFlowGenListPerThread * thread,
                                double &old_offset){
     CGenNode * node;
-    dsec_t flush_time=now_sec(); 
+    /* the realtime loop works in hr ticks, a node time is converted once */
+    const hr_time_t flush_ticks = ptime_convert_dsec_hr(0.00001);
+    const hr_time_t early_ticks = ptime_convert_dsec_hr(0.00003);
+    const double    hr_sec      = 1.0 / (double)os_get_hr_freq();
+    hr_time_t flush_tick = os_get_hr_tick_64();
     dsec_t offset=0.0;
     dsec_t n_time;
     if (always) {
@@ -3518,19 +3539,21 @@ int CNodeGenerator::flush_file(dsec_t max_time,
 #endif*/
 
         if (  odp_likely ( m_is_realtime ) ){
-            dsec_t dt ;
+            hr_time_t n_tick = os_sec_to_hr_tick(n_time);
+            hr_time_t now;
             thread->m_cpu_dp_u.commit();
 
             while ( true ) {
-                dt = now_sec() - n_time ;
+                now = os_get_hr_tick_64();
 
-                if (dt> (-0.00003)) {
+                if ( (int64_t)(now - n_tick) > -(int64_t)early_ticks ) {
                     break;
                 }
 
                 dry_run();
             }
             thread->m_cpu_dp_u.start_work();
+            dsec_t dt = (double)(int64_t)(now - n_tick) * hr_sec;
 
             /* add offset in case of faliures more than 100usec */
             if ( odp_unlikely( dt > 0.000100 ) ) {
@@ -3541,9 +3564,9 @@ int CNodeGenerator::flush_file(dsec_t max_time,
                  m_realtime_his.Add(dt);
             }
             /* flush evey 10 usec */
-            if ( now_sec() - flush_time > 0.00001 ){
+            if ( (now - flush_tick) > flush_ticks ){
                 m_v_if->flush_tx_queue();
-                flush_time=now_sec();
+                flush_tick = os_get_hr_tick_64();
             }
         }
 
@@ -3972,33 +3995,34 @@ void CFlowGenListPerThread::check_msgs(void) {
     #ifdef  NAT_TRACE_
     printf(" %.03f got message from RX \n",now_sec());
     #endif
-    while ( true ) {
-        CGenNode * node;
-        if ( m_ring_from_rx->Dequeue(node)!=0 ){
-            break;
-        }
-        assert(node);
-        //printf ( " message: thread %d,  node->m_flow_id : %d \n", m_thread_id,node->m_flow_id);
-        /* only one message is supported right now */
-
-        CGenNodeMsgBase * msg=(CGenNodeMsgBase *)node;
+    CGenNode * nodes[MSG_DEQUEUE_BURST];
+    uint32_t cnt;
+    while ( (cnt = m_ring_from_rx->DequeueBurst(nodes, MSG_DEQUEUE_BURST)) > 0 ) {
+        uint32_t i;
+        for (i=0; i<cnt; i++) {
+            CGenNode * node = nodes[i];
+            assert(node);
+            //printf ( " message: thread %d,  node->m_flow_id : %d \n", m_thread_id,node->m_flow_id);
+
+            CGenNodeMsgBase * msg=(CGenNodeMsgBase *)node;
+
+            uint8_t   msg_type =  msg->m_msg_type;
+            switch (msg_type ) {
+            case CGenNodeMsgBase::NAT_FIRST:
+                handel_nat_msg((CGenNodeNatInfo * )msg);
+                break;
 
-        uint8_t   msg_type =  msg->m_msg_type;
-        switch (msg_type ) {
-        case CGenNodeMsgBase::NAT_FIRST:
-            handel_nat_msg((CGenNodeNatInfo * )msg);
-            break;
+            case CGenNodeMsgBase::LATENCY_PKT:
+                handel_latecy_pkt_msg((CGenNodeLatencyPktInfo *) msg);
+                break;
 
-        case CGenNodeMsgBase::LATENCY_PKT:
-            handel_latecy_pkt_msg((CGenNodeLatencyPktInfo *) msg);
-            break;
+            default:
+                printf("ERROR pkt-thread message type is not valid %d \n",msg_type);
+                assert(0);
+            }
 
-        default:
-            printf("ERROR pkt-thread message type is not valid %d \n",msg_type);
-            assert(0);
+            CGlobalInfo::free_node(node);
         }
-
-        CGlobalInfo::free_node(node);
     }
 }
 
@@ -5760,7 +5784,7 @@ int CMiniVM::mini_vm_dyn_payload( CMiniVMDynPyload * cmd){
         uint32_t *l=(uint32_t *)(p+dyn->m_pyld_offset);
         for (i=0; i<dyn->m_len; i++) {
             if ( dyn->m_type==0 ) {
-                *l=(rand() & dyn->m_pkt_mask);
+                *l=(utl_rand32(utl_rand_thread_state()) & dyn->m_pkt_mask);
             }else if (dyn->m_type==1){
                 *l=(PKT_NTOHL(cmd->m_ip.v4) & dyn->m_pkt_mask);
             }
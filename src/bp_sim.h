@@ -49,6 +49,7 @@ limitations under the License.
 #include "rx_check_header.h"
 #include "rx_check.h"
 #include "time_histogram.h"
+#include "calendar_queue.h"
 #include "utl_cpuu.h"
 #include "tuple_gen.h"
 #include "utl_jitter.h"
@@ -72,6 +73,7 @@ usec_to_sec(double usec) {
 #define FORCE_NO_INLINE __attribute__ ((noinline))
 
 #define MAX_LATENCY_PORTS 12
+#define MAX_RX_CORES 8 /* latency/rx-check RX cores */
 
 /* IP address, last 32-bits of IPv6 remaps IPv4 */
 typedef struct {
@@ -687,6 +689,34 @@ public:
         return (btGetMaskBit32(m_flags1,6,6) ? true:false);
     }
 
+    /* mbuf packet pools are backed by odp packet pools, TX hands packets to pktio without copy */
+    void setODPZeroCopy(bool enable){
+        btSetMaskBit32(m_flags1,7,7,enable?1:0);
+    }
+
+    bool getODPZeroCopy(){
+        return (btGetMaskBit32(m_flags1,7,7) ? true:false);
+    }
+
+    /* keep the tcp checksum when the tuple is replaced */
+    void setL4Checksum(bool enable){
+        btSetMaskBit32(m_flags1,8,8,enable?1:0);
+    }
+
+    bool getL4Checksum(){
+        return (btGetMaskBit32(m_flags1,8,8) ? true:false);
+    }
+
+    /* stateless streams without VM send their cached mbuf as a static buffer,
+       no refcnt update and no free per packet */
+    void setStlStaticMbuf(bool enable){
+        btSetMaskBit32(m_flags1,9,9,enable?1:0);
+    }
+
+    bool getStlStaticMbuf(){
+        return (btGetMaskBit32(m_flags1,9,9) ? true:false);
+    }
+
 
 
 public:
@@ -720,6 +750,8 @@ public:
     } u;
 } ODP_ALIGNED_CACHE; ;
 
+#define STL_MAX_BURST (64)
+
 struct CParserOption {
 
 public:
@@ -752,12 +784,17 @@ public:
         m_vlan_port[1]=100;
 		m_rx_check_sampe=0;
         m_rx_check_hops = 0;
+        m_rx_check_flows = RX_CHECK_MAX_FLOWS_DEF;
+        m_rx_cores = 1;
         m_io_mode=1;
         m_run_flags=0;
         prefix="";
         m_mac_splitter=0;
         m_run_mode = RUN_MODE_INVALID;
         m_l_pkt_mode = 0;
+        m_sched_tick_usec = 0;
+        m_stl_burst = 1;
+        m_stl_burst_thr_usec = 10;
     }
 
 
@@ -774,6 +811,8 @@ public:
     uint32_t        m_latency_prev;
     uint16_t 		m_rx_check_sampe; /* the sample rate of flows */
     uint16_t        m_rx_check_hops;
+    uint32_t        m_rx_check_flows; /* size of the rx-check flow table */
+    uint8_t         m_rx_cores; /* cores that handle the latency/rx-check RX */
     uint16_t        m_zmq_port;
     uint16_t        m_telnet_port;
     uint16_t        m_expected_portd;
@@ -781,6 +820,9 @@ public:
     uint16_t        m_run_flags;
     uint8_t         m_mac_splitter;
     uint8_t         m_l_pkt_mode;
+    uint32_t        m_sched_tick_usec; /* DP scheduler calendar queue tick, zero for the heap */
+    uint16_t        m_stl_burst;          /* packets per event of a fast continuous stream, 1 disable */
+    uint16_t        m_stl_burst_thr_usec; /* a stream is fast when its packet gap is below this */
     trex_run_mode_e    m_run_mode;
 
 
@@ -1109,7 +1151,7 @@ class CRteMemPool {
 public:
     inline rte_mbuf_t   * _rte_pktmbuf_alloc(rte_mempool_t * mp ){
         rte_mbuf_t   * m=rte_pktmbuf_alloc(mp);
-        if ( odp_likely(m>0) ) {
+        if ( odp_likely(m!=0) ) {
             return (m);
         }
         dump_in_case_of_error(stderr);
@@ -1236,6 +1278,10 @@ public:
       return ( m_options.preview.getODPGeneric());
     }
 
+    static inline bool is_odp_zero_copy(void){
+      return ( m_options.preview.getODPZeroCopy());
+    }
+
 
 
 public:
@@ -1803,6 +1849,68 @@ public:
 
 
 typedef std::priority_queue<CGenNode *, std::vector<CGenNode *>,CGenNodeCompare> pqueue_t;
+typedef CCalendarQueue<CGenNode, CGenNodeCompare> cqueue_t;
+
+
+/* node scheduler queue, the heap by default or a calendar queue ( --sched-tick ) */
+class CGenNodeQueue {
+public:
+    CGenNodeQueue(){
+        m_is_calendar=false;
+    }
+
+    void Create(double tick_sec){
+        if ( tick_sec > 0.0 ) {
+            m_calendar.Create(tick_sec);
+            m_is_calendar=true;
+        }
+    }
+
+    void Delete(){
+        m_calendar.Delete();
+        m_is_calendar=false;
+    }
+
+    bool is_calendar(){
+        return (m_is_calendar);
+    }
+
+    inline void push(CGenNode * node){
+        if ( m_is_calendar ) {
+            m_calendar.push(node);
+        }else{
+            m_heap.push(node);
+        }
+    }
+
+    inline CGenNode * top(){
+        if ( m_is_calendar ) {
+            return (m_calendar.top());
+        }
+        return (m_heap.top());
+    }
+
+    inline void pop(){
+        if ( m_is_calendar ) {
+            m_calendar.pop();
+        }else{
+            m_heap.pop();
+        }
+    }
+
+    inline size_t size(){
+        return ( m_is_calendar ? m_calendar.size() : m_heap.size() );
+    }
+
+    inline bool empty(){
+        return ( m_is_calendar ? m_calendar.empty() : m_heap.empty() );
+    }
+
+private:
+    bool        m_is_calendar;
+    pqueue_t    m_heap;
+    cqueue_t    m_calendar;
+};
 
 
 
@@ -1950,6 +2058,11 @@ public:
         fprintf(fd,"normal\n");
         fprintf(fd,"-------------\n");
         m_realtime_his.Dump(fd);
+        if (m_stl_burst_events) {
+            fprintf(fd," stl burst events   : %llu \n",(unsigned long long)m_stl_burst_events);
+            fprintf(fd," stl burst pkts     : %llu \n",(unsigned long long)m_stl_burst_pkts);
+            fprintf(fd," stl burst max span : %.3f usec \n",m_stl_burst_max_span*1e6);
+        }
     }
 
     void dump_json(std::string & json);
@@ -1970,7 +2083,7 @@ private:
 
 
 public:
-    pqueue_t                  m_p_queue;
+    CGenNodeQueue             m_p_queue;
     socket_id_t               m_socket_id;
     bool                      m_is_realtime;
     CVirtualIF *              m_v_if;
@@ -1978,6 +2091,11 @@ public:
     CPreviewMode              m_preview_mode;
     uint64_t                  m_cnt;
     CTimeHistogram            m_realtime_his;  
+
+    /* stateless burst emission, see --stl-burst */
+    uint64_t                  m_stl_burst_events;
+    uint64_t                  m_stl_burst_pkts;
+    double                    m_stl_burst_max_span; /* in sec, time between the first and the last packet */
 };
 
 
@@ -2746,17 +2864,16 @@ inline void CFlowPktInfo::update_pkt_info2(char *p,
 
     }else{
         if ( update_len ){
-            ipv4->setTotalLength((ipv4->getTotalLength() + update_len));
+            ipv4->updateTotalLength((ipv4->getTotalLength() + update_len));
         }
 
         if ( flow_info->is_init_ip_dir  ) {
-            ipv4->setSourceIp(flow_info->client_ip);
-            ipv4->setDestIp(flow_info->server_ip);
+            ipv4->updateIpSrc(flow_info->client_ip);
+            ipv4->updateIpDst(flow_info->server_ip);
         }else{
-            ipv4->setSourceIp(flow_info->server_ip);
-            ipv4->setDestIp(flow_info->client_ip);
+            ipv4->updateIpSrc(flow_info->server_ip);
+            ipv4->updateIpDst(flow_info->client_ip);
         }
-        ipv4->updateCheckSum();
     }
 
 
@@ -2818,6 +2935,22 @@ inline void CFlowPktInfo::update_pkt_info(char *p,
     pkt_dir_t ip_dir = node->cur_pkt_ip_addr_dir();
     pkt_dir_t port_dir = node->cur_pkt_port_addr_dir();
 
+    /* the tcp checksum covers the addresses (pseudo header) and the ports, 
+       they are summed before and after the update (RFC 1624) */
+    bool      l4_cs    = false;
+    uint8_t * l4_addr  = 0;
+    uint16_t  l4_alen  = 0;
+    uint32_t  l4_old   = 0;
+
+    if ( odp_unlikely( CGlobalInfo::m_options.preview.getL4Checksum() &&
+                       m_pkt_indication.m_desc.IsTcp() ) ) {
+        l4_cs   = true;
+        l4_addr = (uint8_t *)ipv4 + (m_pkt_indication.is_ipv6() ? 8 : 12);
+        l4_alen = m_pkt_indication.is_ipv6() ? 32 : 8;
+        l4_old  = pkt_SumInetChecksum(l4_addr,l4_alen) +
+                  pkt_SumInetChecksum((uint8_t *)(p + m_pkt_indication.getFastTcpOffset()),4);
+    }
+
 
     if ( odp_unlikely (m_pkt_indication.is_ipv6())) {
     
@@ -2847,6 +2980,7 @@ inline void CFlowPktInfo::update_pkt_info(char *p,
                 lpNat->set_fid(node->get_short_fid());
                 lpNat->set_thread_id(node->get_thread_id()); 
                 lpNat->set_rx_check(node->is_rx_check_enabled());
+                ipv4->updateCheckSum();
             }
             /* in call cases update the ip using the outside ip */
 
@@ -2902,8 +3036,8 @@ inline void CFlowPktInfo::update_pkt_info(char *p,
                 ipv4->updateIpDst(node->m_src_ip);
             }
         }
-
-        ipv4->updateCheckSum();
+        /* updateIpSrc/updateIpDst keep the checksum, the template checksum is 
+           valid (CFlowPktInfo::Create) */
     }
 
 
@@ -2917,6 +3051,11 @@ inline void CFlowPktInfo::update_pkt_info(char *p,
         }else{
             m_tcp->setDestPort(src_port);
         }
+        if ( odp_unlikely(l4_cs) ) {
+            uint32_t l4_new = pkt_SumInetChecksum(l4_addr,l4_alen) +
+                              pkt_SumInetChecksum((uint8_t *)m_tcp,4);
+            m_tcp->updateCheckSum(pkt_DeltaInetChecksum(l4_old,l4_new));
+        }
     }else {
         if ( m_pkt_indication.m_desc.IsUdp() ){
             UDPHeader * m_udp =(UDPHeader *)(p +m_pkt_indication.getFastTcpOffset() );
@@ -3432,7 +3571,7 @@ public:
     friend class CPluginCallbackSimple;
     friend class CCapFileFlowInfo;
     
-    typedef  CGenericMap<flow_id_t,CGenNode> flow_id_node_t;
+    typedef  CGenericHashMap<flow_id_t,CGenNode> flow_id_node_t;
 
     bool Create(uint32_t           thread_id,
                 uint32_t           core_id,
@@ -3499,6 +3638,10 @@ public:
     bool  set_stateless_next_node( CGenNodeStateless * cur_node,
                                    CGenNodeStateless * next_node);
 
+    /* per stream tx counters of this core, read by the CP */
+    const TrexStreamsTxStats * get_stream_tx_stats() const {
+        return (m_stateless_dp_info.get_tx_stats());
+    }
 
     void Dump(FILE *fd);
     void DumpCsv(FILE *fd);
@@ -0,0 +1,334 @@
+#ifndef CALENDAR_QUEUE_H
+#define CALENDAR_QUEUE_H
+/*
+ Hanoh Haim
+ Cisco Systems, Inc.
+*/
+
+/*
+Copyright (c) 2015-2015 Cisco Systems, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <stdint.h>
+#include <assert.h>
+#include <vector>
+#include <queue>
+#include <algorithm>
+
+
+/**
+ * calendar queue keyed on T::m_time (seconds), a drop-in for
+ * std::priority_queue<T *> with push/top/pop/size/empty
+ *
+ * two level timing wheel. level 0 has a bucket per tick for the ticks of
+ * the current page, level 1 has a bucket per page ( 2^log2_l0 ticks ) for
+ * the next 2^log2_l1 pages. nodes beyond that wait in a heap. a level 1
+ * bucket is cascaded into level 0 when the scheduler reaches its page, so
+ * each node is moved at most twice.
+ *
+ * a level 0 bucket is unsorted, when the scheduler reaches it the whole
+ * bucket becomes the current list and is sorted once, so nodes that fall
+ * in the same tick are drained as a batch. bitmaps of the non-empty
+ * buckets are used to skip idle ticks and pages.
+ *
+ * the order is the same as the heap : ticks are visited in order, nodes in
+ * a tick are sorted by the exact time
+ */
+template <class T, class CMP>
+class CCalendarQueue {
+
+public:
+    enum {
+        DEFAULT_LOG2_L0 = 12,
+        DEFAULT_LOG2_L1 = 12
+    };
+
+    CCalendarQueue(){
+        m_tick_inv   = 0.0;
+        m_page_shift = DEFAULT_LOG2_L0;
+        m_cur_tick = 0;
+        m_cur_page = 0;
+        m_cur_pos  = 0;
+        m_count    = 0;
+    }
+
+    ~CCalendarQueue(){
+        Delete();
+    }
+
+    /* tick_sec is the resolution of a level 0 bucket, e.g. 1e-6 */
+    bool Create(double tick_sec,
+                uint8_t log2_l0 = DEFAULT_LOG2_L0,
+                uint8_t log2_l1 = DEFAULT_LOG2_L1){
+        assert(tick_sec > 0.0);
+        Delete();
+        m_tick_inv = 1.0 / tick_sec;
+        m_l0.Create(log2_l0);
+        m_l1.Create(log2_l1);
+        m_page_shift = log2_l0;
+        m_cur.reserve(64);
+        return (true);
+    }
+
+    void Delete(){
+        m_l0.Delete();
+        m_l1.Delete();
+        m_cur.clear();
+        m_cur_pos = 0;
+        m_count   = 0;
+        while (!m_overflow.empty()) {
+            m_overflow.pop();
+        }
+    }
+
+public:
+    inline size_t size() const {
+        return (m_count);
+    }
+
+    inline bool empty() const {
+        return (m_count == 0);
+    }
+
+    inline void push(T * node){
+        int64_t tick = to_tick(node->m_time);
+
+        if ( m_count == 0 ) {
+            /* restart the wheel at this node */
+            m_cur_tick = tick;
+            m_cur_page = page_of(tick);
+            m_cur.clear();
+            m_cur_pos = 0;
+        }
+        m_count++;
+
+        if ( tick <= m_cur_tick ) {
+            insert_cur(node);
+        } else {
+            insert_wheel(tick, node);
+        }
+    }
+
+    inline T * top(){
+        if ( m_cur_pos == m_cur.size() ) {
+            advance();
+        }
+        return (m_cur[m_cur_pos]);
+    }
+
+    inline void pop(){
+        if ( m_cur_pos == m_cur.size() ) {
+            advance();
+        }
+        m_cur_pos++;
+        m_count--;
+    }
+
+private:
+    /* one level, buckets plus a bitmap of the non empty ones */
+    struct CLevel {
+        CLevel(){
+            m_buckets  = 0;
+            m_bitmap   = 0;
+            m_mask     = 0;
+            m_nb_words = 0;
+            m_cnt      = 0;
+        }
+
+        void Create(uint8_t log2_buckets){
+            assert(log2_buckets >= 6 && log2_buckets < 32);
+            uint32_t nb = (1U << log2_buckets);
+            m_mask     = nb - 1;
+            m_nb_words = nb >> 6;
+            m_buckets  = new std::vector<T *>[nb];
+            m_bitmap   = new uint64_t[m_nb_words];
+            std::fill(m_bitmap, m_bitmap + m_nb_words, 0);
+            m_cnt      = 0;
+        }
+
+        void Delete(){
+            if (m_buckets) {
+                delete [] m_buckets;
+                m_buckets = 0;
+            }
+            if (m_bitmap) {
+                delete [] m_bitmap;
+                m_bitmap = 0;
+            }
+            m_cnt = 0;
+        }
+
+        inline void insert(int64_t slot, T * node){
+            uint32_t idx = (uint32_t)slot & m_mask;
+            m_buckets[idx].push_back(node);
+            m_bitmap[idx >> 6] |= (1ULL << (idx & 63));
+            m_cnt++;
+        }
+
+        /* give the bucket to the caller, its old storage is reused */
+        inline void take(uint32_t idx, std::vector<T *> & to){
+            to.clear();
+            to.swap(m_buckets[idx]);
+            m_bitmap[idx >> 6] &= ~(1ULL << (idx & 63));
+            m_cnt -= to.size();
+        }
+
+        /* first non empty index >= start, when wrap is set the search
+           continues from zero up to start */
+        bool find(uint32_t start, bool wrap, uint32_t & idx) const {
+            uint32_t w    = start >> 6;
+            uint64_t bits = m_bitmap[w] & (~0ULL << (start & 63));
+            uint32_t last = wrap ? m_nb_words : (m_nb_words - 1 - w);
+            uint32_t i;
+
+            for (i = 0; ; i++) {
+                if ( bits ) {
+                    idx = (w << 6) + __builtin_ctzll(bits);
+                    return (true);
+                }
+                if ( i == last ) {
+                    return (false);
+                }
+                w = (w + 1) & (m_nb_words - 1);
+                bits = m_bitmap[w];
+                if ( i + 1 == m_nb_words ) {
+                    /* wrapped back to the first word, only the bits before start */
+                    bits &= ~(~0ULL << (start & 63));
+                }
+            }
+        }
+
+        std::vector<T *> *  m_buckets;
+        uint64_t *          m_bitmap;
+        uint32_t            m_mask;
+        uint32_t            m_nb_words;
+        size_t              m_cnt;
+    };
+
+    struct CTimeLess {
+        bool operator() (const T * lhs, const T * rhs) const {
+            return (lhs->m_time < rhs->m_time);
+        }
+    };
+
+    inline int64_t to_tick(double time) const {
+        return ((int64_t)(time * m_tick_inv));
+    }
+
+    inline int64_t page_of(int64_t tick) const {
+        return (tick >> m_page_shift);
+    }
+
+    /* tick is after the current tick */
+    inline void insert_wheel(int64_t tick, T * node){
+        int64_t page = page_of(tick);
+
+        if ( page == m_cur_page ) {
+            m_l0.insert(tick, node);
+        } else if ( (page - m_cur_page) <= (int64_t)m_l1.m_mask ) {
+            m_l1.insert(page, node);
+        } else {
+            m_overflow.push(node);
+        }
+    }
+
+    /* node is due in the tick being drained, keep the current list sorted */
+    void insert_cur(T * node){
+        typename std::vector<T *>::iterator it;
+        it = std::upper_bound(m_cur.begin() + m_cur_pos, m_cur.end(), node, CTimeLess());
+        m_cur.insert(it, node);
+    }
+
+    /* move to the next page that has nodes and cascade it into level 0 */
+    void next_page(){
+        int64_t page  = 0;
+        bool    found = false;
+        uint32_t idx;
+
+        if ( m_l1.m_cnt &&
+             m_l1.find((uint32_t)(m_cur_page + 1) & m_l1.m_mask, true, idx) ) {
+            page  = m_cur_page + 1 + ((idx - (uint32_t)(m_cur_page + 1)) & m_l1.m_mask);
+            found = true;
+        }
+        if ( !m_overflow.empty() ) {
+            int64_t o_page = page_of(to_tick(m_overflow.top()->m_time));
+            if ( !found || (o_page < page) ) {
+                page  = o_page;
+                found = true;
+            }
+        }
+        assert(found);
+        m_cur_page = page;
+        m_cur_tick = (page << m_page_shift) - 1;
+
+        /* pull nodes that are now inside the horizon */
+        while ( !m_overflow.empty() ) {
+            T * node = m_overflow.top();
+            int64_t tick = to_tick(node->m_time);
+            if ( (page_of(tick) - m_cur_page) > (int64_t)m_l1.m_mask ) {
+                break;
+            }
+            m_overflow.pop();
+            insert_wheel(tick, node);
+        }
+
+        m_l1.take((uint32_t)m_cur_page & m_l1.m_mask, m_cascade);
+        typename std::vector<T *>::iterator it;
+        for (it = m_cascade.begin(); it != m_cascade.end(); ++it) {
+            m_l0.insert(to_tick((*it)->m_time), *it);
+        }
+    }
+
+    /* move to the next tick that has nodes and make it the current list */
+    void advance(){
+        assert(m_count > 0);
+        uint32_t idx;
+        uint32_t page_mask = m_l0.m_mask;
+
+        while ( true ) {
+            if ( m_l0.m_cnt ) {
+                /* level 0 holds only ticks of the current page after the current tick */
+                uint32_t start = (uint32_t)(m_cur_tick + 1) & page_mask;
+                if ( m_l0.find(start, false, idx) ) {
+                    break;
+                }
+                assert(0);
+            }
+            next_page();
+        }
+
+        m_cur_tick = (m_cur_page << m_page_shift) + idx;
+        m_l0.take(idx, m_cur);
+        m_cur_pos = 0;
+        if ( m_cur.size() > 1 ) {
+            std::sort(m_cur.begin(), m_cur.end(), CTimeLess());
+        }
+    }
+
+private:
+    double                                              m_tick_inv;
+    uint8_t                                             m_page_shift;
+    int64_t                                             m_cur_tick;  /* tick of m_cur */
+    int64_t                                             m_cur_page;  /* page of level 0 */
+    std::vector<T *>                                    m_cur;       /* sorted, being drained */
+    size_t                                              m_cur_pos;
+    size_t                                              m_count;     /* all nodes */
+    CLevel                                              m_l0;
+    CLevel                                              m_l1;
+    std::vector<T *>                                    m_cascade;
+    std::priority_queue<T *, std::vector<T *>, CMP>     m_overflow;  /* beyond level 1 */
+};
+
+#endif
@@ -16,61 +16,18 @@ limitations under the License.
 */
 
 
-
-#define TouchCacheLine(a)
-
 uint16_t pkt_InetChecksum(uint8_t* data , 
                         uint16_t len, uint8_t* data2 , uint16_t len2){
 
-    TouchCacheLine(data2);
-    TouchCacheLine(data2+32);
-    TouchCacheLine(data2+64);
-
-    int sum = 0;
-    while(len>1){
-        TouchCacheLine(data+96); //three lines ahead !
-        sum += PKT_NTOHS(*((uint16_t*)data));
-        data += 2;
-        len -= 2;
-    }
-
-    while(len2>1){
-        TouchCacheLine(data2+96); //three lines ahead !
-        sum += PKT_NTOHS(*((uint16_t*)data2));
-        data2 += 2;
-        len2 -= 2;
-    }
-
-    if(len2){
-        sum += (PKT_NTOHS(*((uint16_t*)data2)) & 0xff00);
-    }
-
-    while(sum >> 16){
-        sum = (sum & 0xffff) + (sum >> 16);
-    }
+    uint32_t sum = pkt_CsumPartial(data,len);
+    sum += pkt_CsumPartial(data2,len2);
 
-    return PKT_NTOHS((uint16_t)(~sum));
+    return ((uint16_t)~pkt_FoldInetChecksum(sum));
 }
 
 uint16_t pkt_InetChecksum(uint8_t* data , uint16_t len){
 
-    int sum = 0;
-    while(len>1){
-        TouchCacheLine(data+96); //three line ahead !
-        sum += PKT_NTOHS(*((uint16_t*)data));
-        data += 2;
-        len -= 2;
-    }
-
-    if(len){
-        sum += (PKT_NTOHS(*((uint16_t*)data)) & 0xff00);
-    }
-
-    while(sum >> 16){
-        sum = (sum & 0xffff) + (sum >> 16);
-    }
-
-    return PKT_NTOHS((uint16_t)(~sum));
+    return ((uint16_t)~pkt_CsumPartial(data,len));
 }
 
 uint16_t pkt_UpdateInetChecksum(uint16_t csFieldFromPacket, uint16_t oldVal, uint16_t newVal){
@@ -112,6 +69,11 @@ uint16_t pkt_AddInetChecksum(uint16_t checksum, uint16_t csToAdd){
     return PKT_NTOHS((uint16_t)(~newCS));
 }
 
+uint32_t pkt_SumInetChecksum(uint8_t* data , uint16_t len){
+    return (pkt_CsumPartial(data,len));
+}
+
+
 
 extern "C" void pkt_ChecksumTest(){
 
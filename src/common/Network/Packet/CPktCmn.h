@@ -24,6 +24,7 @@ limitations under the License.
 #include <string.h>
 #include <stdlib.h>
 #include "pal_utl.h"
+#include "CPktCsum.h"
 
 
 #define PKT_HTONL(x) (PAL_NTOHL(x))
@@ -33,7 +34,7 @@ limitations under the License.
 #define PKT_NTOHS(x) (PAL_NTOHS(x))
 
 
-// returns cs in NETWROK order
+// returns cs in NETWROK order, the sum is done by pkt_CsumPartial
 uint16_t pkt_InetChecksum(uint8_t* data , uint16_t len);
 
 // len MUST be an even number !!!
@@ -54,6 +55,34 @@ uint16_t pkt_SubtractInetChecksum(uint16_t checksum, uint16_t csToSubtract);
 // checksum and csToAdd are two uint16_t cs fields AS THEY APPEAR INSIDE A PACKET !
 uint16_t pkt_AddInetChecksum(uint16_t checksum, uint16_t csToAdd);
 
+// RFC 1624 incremental update. a sum is a one's complement sum of 16 bit
+// words AS THEY APPEAR INSIDE A PACKET kept in 32 bits, the sum of a changed
+// field is ~sum(old words) + sum(new words) and it is added to the cs in O(1)
+
+// sum of the words of data, an odd last byte is padded with zero.
+// data must be word aligned relative to the start of the checksummed area
+uint32_t pkt_SumInetChecksum(uint8_t* data , uint16_t len);
+
+// fold a sum into 16 bits
+static inline uint16_t pkt_FoldInetChecksum(uint32_t sum){
+    sum = (sum & 0xffff) + (sum >> 16);
+    sum = (sum & 0xffff) + (sum >> 16);
+    return ((uint16_t)sum);
+}
+
+// the sum of a field that changed from the words summed to oldSum to the
+// words summed to newSum
+static inline uint32_t pkt_DeltaInetChecksum(uint32_t oldSum, uint32_t newSum){
+    return ((uint16_t)~pkt_FoldInetChecksum(oldSum) + newSum);
+}
+
+// HC' = ~(~HC + delta), the cs field AS IS from the packet
+static inline uint16_t pkt_ApplyInetChecksumDelta(uint16_t csFieldFromPacket, uint32_t delta){
+    uint32_t sum = (uint16_t)~csFieldFromPacket;
+    sum += pkt_FoldInetChecksum(delta);
+    return ((uint16_t)~pkt_FoldInetChecksum(sum));
+}
+
 
 struct Tunnels
 {
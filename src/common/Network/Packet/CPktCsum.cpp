@@ -0,0 +1,269 @@
+/*
+Copyright (c) 2015-2015 Cisco Systems, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include "CPktCmn.h"
+#include <assert.h>
+#include "mbuf.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define PKT_CSUM_X86
+#include <immintrin.h>
+#endif
+
+/* the vector kernels add 16 bit words into 32 bit lanes, the lanes are
+   flushed into the 64 bit sum every block so they can't overflow */
+#define PKT_CSUM_BLOCK  (16*1024)
+
+typedef uint64_t (*pkt_csum_func_t)(const uint8_t* data , uint32_t len);
+
+static inline uint16_t pkt_csum_fold64(uint64_t sum){
+    sum = (sum & 0xffffffffULL) + (sum >> 32);
+    sum = (sum & 0xffffffffULL) + (sum >> 32);
+    return (pkt_FoldInetChecksum((uint32_t)sum));
+}
+
+/* 32 bit words, the folded one's complement sum is the same as with 16 bit words */
+static uint64_t pkt_csum_scalar(const uint8_t* data , uint32_t len){
+    uint64_t sum = 0;
+    uint32_t w[4];
+
+    while (len >= 16) {
+        memcpy(w, data, 16);
+        sum += (uint64_t)w[0] + w[1] + w[2] + w[3];
+        data += 16;
+        len  -= 16;
+    }
+    while (len >= 4) {
+        memcpy(w, data, 4);
+        sum  += w[0];
+        data += 4;
+        len  -= 4;
+    }
+    if (len >= 2) {
+        sum  += *((uint16_t*)data);
+        data += 2;
+        len  -= 2;
+    }
+    if (len) {
+        uint16_t last = 0;
+        *((uint8_t*)&last) = *data;
+        sum += last;
+    }
+    return (sum);
+}
+
+#ifdef PKT_CSUM_X86
+
+__attribute__((target("sse4.2")))
+static uint64_t pkt_csum_sse42(const uint8_t* data , uint32_t len){
+    const __m128i zero = _mm_setzero_si128();
+    uint64_t sum = 0;
+    uint32_t w[8];
+
+    while (len >= 32) {
+        uint32_t blk = len & ~31U;
+        if (blk > PKT_CSUM_BLOCK) {
+            blk = PKT_CSUM_BLOCK;
+        }
+        const uint8_t* end = data + blk;
+        __m128i a0 = zero;
+        __m128i a1 = zero;
+
+        for (; data < end; data += 32) {
+            __m128i v0 = _mm_loadu_si128((const __m128i*)data);
+            __m128i v1 = _mm_loadu_si128((const __m128i*)(data + 16));
+            a0 = _mm_add_epi32(a0, _mm_unpacklo_epi16(v0, zero));
+            a1 = _mm_add_epi32(a1, _mm_unpackhi_epi16(v0, zero));
+            a0 = _mm_add_epi32(a0, _mm_unpacklo_epi16(v1, zero));
+            a1 = _mm_add_epi32(a1, _mm_unpackhi_epi16(v1, zero));
+        }
+        len -= blk;
+
+        _mm_storeu_si128((__m128i*)&w[0], a0);
+        _mm_storeu_si128((__m128i*)&w[4], a1);
+        for (int i = 0; i < 8; i++) {
+            sum += w[i];
+        }
+    }
+    return (sum + pkt_csum_scalar(data, len));
+}
+
+__attribute__((target("avx2")))
+static uint64_t pkt_csum_avx2(const uint8_t* data , uint32_t len){
+    const __m256i zero = _mm256_setzero_si256();
+    uint64_t sum = 0;
+    uint32_t w[16];
+
+    while (len >= 64) {
+        uint32_t blk = len & ~63U;
+        if (blk > PKT_CSUM_BLOCK) {
+            blk = PKT_CSUM_BLOCK;
+        }
+        const uint8_t* end = data + blk;
+        __m256i a0 = zero;
+        __m256i a1 = zero;
+
+        for (; data < end; data += 64) {
+            __m256i v0 = _mm256_loadu_si256((const __m256i*)data);
+            __m256i v1 = _mm256_loadu_si256((const __m256i*)(data + 32));
+            a0 = _mm256_add_epi32(a0, _mm256_unpacklo_epi16(v0, zero));
+            a1 = _mm256_add_epi32(a1, _mm256_unpackhi_epi16(v0, zero));
+            a0 = _mm256_add_epi32(a0, _mm256_unpacklo_epi16(v1, zero));
+            a1 = _mm256_add_epi32(a1, _mm256_unpackhi_epi16(v1, zero));
+        }
+        len -= blk;
+
+        _mm256_storeu_si256((__m256i*)&w[0], a0);
+        _mm256_storeu_si256((__m256i*)&w[8], a1);
+        for (int i = 0; i < 16; i++) {
+            sum += w[i];
+        }
+    }
+    return (sum + pkt_csum_scalar(data, len));
+}
+
+static pkt_csum_func_t pkt_csum_kernels[] = {
+    pkt_csum_scalar,
+    pkt_csum_sse42,
+    pkt_csum_avx2
+};
+
+#else
+
+static pkt_csum_func_t pkt_csum_kernels[] = {
+    pkt_csum_scalar,
+    pkt_csum_scalar,
+    pkt_csum_scalar
+};
+
+#endif
+
+static const char * pkt_csum_names[] = {
+    "scalar",
+    "sse4.2",
+    "avx2",
+    "auto"
+};
+
+/* resolved on the first call, a race sets the same value */
+static pkt_csum_func_t  pkt_csum_func   = 0;
+static CsumKernel::Type pkt_csum_kernel = CsumKernel::SCALAR;
+
+bool pkt_CsumKernelSupported(CsumKernel::Type kernel){
+    switch (kernel) {
+    case CsumKernel::SCALAR:
+    case CsumKernel::AUTO:
+        return (true);
+#ifdef PKT_CSUM_X86
+    case CsumKernel::SSE42:
+        __builtin_cpu_init();
+        return (__builtin_cpu_supports("sse4.2") ? true : false);
+    case CsumKernel::AVX2:
+        __builtin_cpu_init();
+        return (__builtin_cpu_supports("avx2") ? true : false);
+#endif
+    default:
+        return (false);
+    }
+}
+
+const char * pkt_CsumKernelName(CsumKernel::Type kernel){
+    if ( (uint32_t)kernel > CsumKernel::AUTO ) {
+        return ("unknown");
+    }
+    return (pkt_csum_names[kernel]);
+}
+
+bool pkt_CsumSetKernel(CsumKernel::Type kernel){
+    if ( kernel == CsumKernel::AUTO ) {
+        if ( pkt_CsumKernelSupported(CsumKernel::AVX2) ) {
+            kernel = CsumKernel::AVX2;
+        } else if ( pkt_CsumKernelSupported(CsumKernel::SSE42) ) {
+            kernel = CsumKernel::SSE42;
+        } else {
+            kernel = CsumKernel::SCALAR;
+        }
+    }
+    if ( !pkt_CsumKernelSupported(kernel) ) {
+        return (false);
+    }
+    pkt_csum_kernel = kernel;
+    pkt_csum_func   = pkt_csum_kernels[kernel];
+    return (true);
+}
+
+CsumKernel::Type pkt_CsumGetKernel(){
+    if ( pkt_csum_func == 0 ) {
+        pkt_CsumSetKernel(CsumKernel::AUTO);
+    }
+    return (pkt_csum_kernel);
+}
+
+uint16_t pkt_CsumPartial(const uint8_t* data , uint32_t len){
+    if ( len < PKT_CSUM_SIMD_MIN ) {
+        return (pkt_csum_fold64(pkt_csum_scalar(data, len)));
+    }
+    if ( pkt_csum_func == 0 ) {
+        pkt_CsumSetKernel(CsumKernel::AUTO);
+    }
+    return (pkt_csum_fold64(pkt_csum_func(data, len)));
+}
+
+uint16_t pkt_CsumPartialKernel(CsumKernel::Type kernel, const uint8_t* data , uint32_t len){
+    if ( kernel == CsumKernel::AUTO ) {
+        return (pkt_CsumPartial(data, len));
+    }
+    assert(pkt_CsumKernelSupported(kernel));
+    return (pkt_csum_fold64(pkt_csum_kernels[kernel](data, len)));
+}
+
+uint16_t pkt_CsumPartialMbuf(struct rte_mbuf* m, uint32_t offset, uint32_t len){
+    uint32_t sum = 0;
+    bool     odd = false;
+
+    while ( m && (offset >= m->data_len) ) {
+        offset -= m->data_len;
+        m = m->next;
+    }
+    while ( m && len ) {
+        uint32_t seg = m->data_len - offset;
+        if ( seg > len ) {
+            seg = len;
+        }
+        uint16_t s = pkt_CsumPartial(rte_pktmbuf_mtod(m, uint8_t*) + offset, seg);
+        /* a segment that starts at an odd offset has its bytes in the other half of the words */
+        if ( odd ) {
+            s = (uint16_t)((s << 8) | (s >> 8));
+        }
+        sum += s;
+        if ( seg & 1 ) {
+            odd = !odd;
+        }
+        len   -= seg;
+        offset = 0;
+        m      = m->next;
+    }
+    return (pkt_FoldInetChecksum(sum));
+}
+
+uint16_t pkt_L4InetChecksum(const uint8_t* addrs, uint16_t addrs_len,
+                            uint8_t proto,
+                            const uint8_t* l4 , uint16_t l4_len){
+    uint32_t sum = pkt_CsumPartial(addrs, addrs_len);
+    sum += PKT_HTONS((uint16_t)proto);
+    sum += PKT_HTONS(l4_len);
+    sum += pkt_CsumPartial(l4, l4_len);
+    return ((uint16_t)~pkt_FoldInetChecksum(sum));
+}
@@ -0,0 +1,73 @@
+#ifndef PKT_CSUM_H
+#define PKT_CSUM_H
+/*
+Copyright (c) 2015-2015 Cisco Systems, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <stdint.h>
+
+struct rte_mbuf;
+
+// Internet checksum kernels. The one's complement sum does not depend on
+// the byte order, so the words are summed AS THEY APPEAR INSIDE A PACKET
+// and the folded sum is already in NETWORK order, no swap is needed.
+//
+// the sum is computed by a scalar, SSE4.2 or AVX2 kernel, the best one the
+// cpu supports is picked on the first call. short buffers always use the
+// scalar kernel.
+
+struct CsumKernel
+{
+    enum Type
+    {
+        SCALAR  = 0,
+        SSE42   = 1,
+        AVX2    = 2,
+        AUTO    = 3  // best supported kernel
+    };
+};
+
+// below this length the vector kernels do not pay off
+#define PKT_CSUM_SIMD_MIN   (256)
+
+// folded (not inverted) sum of the words of data, an odd last byte is
+// padded with zero. data must be word aligned relative to the start of
+// the checksummed area
+uint16_t pkt_CsumPartial(const uint8_t* data , uint32_t len);
+
+// the same, with a specific kernel. the kernel must be supported
+uint16_t pkt_CsumPartialKernel(CsumKernel::Type kernel, const uint8_t* data , uint32_t len);
+
+// folded sum of len bytes of a segment chain, starting offset bytes
+// into the first segment. segments can have an odd length
+uint16_t pkt_CsumPartialMbuf(struct rte_mbuf* m, uint32_t offset, uint32_t len);
+
+bool             pkt_CsumKernelSupported(CsumKernel::Type kernel);
+const char *     pkt_CsumKernelName(CsumKernel::Type kernel);
+CsumKernel::Type pkt_CsumGetKernel();
+
+// force a kernel for all the callers (tests/benchmarks), AUTO picks the
+// best one again. returns false if the cpu does not support it
+bool             pkt_CsumSetKernel(CsumKernel::Type kernel);
+
+// TCP/UDP checksum with the pseudo header. addrs points to the source and
+// destination addresses of the IP header ( 8 bytes for ipv4, 32 for ipv6 ),
+// the cs field of the segment must be zero when building the cs.
+// returns cs in NETWROK order, zero when checking a valid segment
+uint16_t pkt_L4InetChecksum(const uint8_t* addrs, uint16_t addrs_len,
+                            uint8_t proto,
+                            const uint8_t* l4 , uint16_t l4_len);
+
+#endif
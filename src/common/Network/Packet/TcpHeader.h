@@ -86,6 +86,8 @@ public:
 
     void    setChecksum     (uint16_t);
     uint16_t  getChecksum     ();
+    // RFC 1624, delta is the sum of the changed words (see CPktCmn.h)
+    void    updateCheckSum  (uint32_t delta);
 
     void    setUrgentOffset (uint16_t);
     uint16_t  getUrgentOffset ();
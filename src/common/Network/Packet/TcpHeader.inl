@@ -199,6 +199,11 @@ inline	uint16_t TCPHeader::getChecksum()
     return PKT_NTOHS(myChecksum);
 }
 
+inline void   TCPHeader::updateCheckSum(uint32_t delta)
+{
+    myChecksum = pkt_ApplyInetChecksumDelta(myChecksum,delta);
+}
+
 inline void   TCPHeader::setUrgentOffset(uint16_t argUrgentOffset)
 {
     myUrgentPtr = argUrgentOffset;
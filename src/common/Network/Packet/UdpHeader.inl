@@ -70,25 +70,11 @@ bool UDPHeader::isCheckSumOk(IPHeader  *ipHeader)
 
 uint16_t UDPHeader::calcCheckSum(IPHeader  *ipHeader)
 {
-	IPPseudoHeader pseudo;
-
     uint16_t length= ipHeader->getTotalLength() - ipHeader->getHeaderLength();
 
-	pseudo.m_source_ip = PKT_NTOHL(ipHeader->getSourceIp());
-
-	pseudo.m_dest_ip   = PKT_NTOHL(ipHeader->getDestIp());
-
-	pseudo.m_zero      = 0;
-
-	pseudo.m_protocol  = ipHeader->getProtocol();
-
-	pseudo.m_length    = PKT_NTOHS(length);
-
-	uint16_t theChecksum = pkt_InetChecksum((uint8_t*)this,length);
-
-	theChecksum = pkt_AddInetChecksum(theChecksum,pseudo.inetChecksum());
-
-	return(theChecksum);
+	return(pkt_L4InetChecksum((uint8_t*)&ipHeader->mySource,8,
+                              ipHeader->getProtocol(),
+                              (uint8_t*)this,length));
 }
 
 void UDPHeader::swapSrcDest()
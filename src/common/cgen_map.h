@@ -18,8 +18,11 @@ limitations under the License.
 
 
 #include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <map>
 #include <string>
+#include <type_traits>
 
 template<class KEY, class VAL>
 class CGenericMap   {
@@ -93,4 +96,213 @@ public:
     gen_map_t  m_map;
 };
 
+
+/**
+ * fixed capacity open addressing hash with the interface of CGenericMap,
+ * for integer keys. the slots are allocated once in Create, add/remove
+ * do not allocate.
+ *
+ * linear probing, a slot with a NULL value is empty. remove shifts the
+ * next entries of the cluster back ( no tombstones ) so a lookup never
+ * scans more than the cluster of its key. the table is twice the
+ * max_size so the clusters stay short
+ */
+template<class KEY, class VAL>
+class CGenericHashMap   {
+    static_assert(std::is_integral<KEY>::value, "CGenericHashMap key should be an integer");
+
+public:
+    typedef void (free_map_object_func_t)(VAL *p);
+
+    enum {
+        MIN_SIZE = 16
+    };
+
+    CGenericHashMap(){
+        m_slots = 0;
+        m_mask  = 0;
+        m_shift = 0;
+        m_count = 0;
+        clear_stats();
+    }
+
+    /* max_size is the number of objects that the map should hold */
+    bool Create(uint32_t max_size=(64*1024)){
+        uint64_t size = MIN_SIZE;
+        m_shift = 64 - 4;
+        while ( size < 2 * (uint64_t)max_size ) {
+            size *= 2;
+            m_shift--;
+        }
+        m_mask  = size - 1;
+        m_count = 0;
+        clear_stats();
+        /* calloc, the pages of a large table are touched only when used */
+        m_slots = (slot_t *)calloc(size, sizeof(slot_t));
+        return ( m_slots ? true : false );
+    }
+
+    void Delete(){
+        if ( m_slots ) {
+            free(m_slots);
+            m_slots = 0;
+        }
+        m_count = 0;
+    }
+
+    VAL * remove(KEY  key ){
+        uint32_t i = find(key);
+        if ( m_slots[i].m_val == 0 ) {
+            return (0);
+        }
+        VAL * lp = m_slots[i].m_val;
+        shift_back(i);
+        m_count--;
+        return (lp);
+    }
+
+    void remove_no_lookup(KEY  key ){
+        remove(key);
+    }
+
+    inline VAL * lookup(KEY  key ){
+        return ( m_slots[find(key)].m_val );
+    }
+
+    /* false if the key exists ( it is not replaced ) or the map is full */
+    bool add(KEY  key,VAL * val){
+        uint32_t i    = hash(key);
+        uint32_t dist = 0;
+        while ( m_slots[i].m_val ) {
+            if ( m_slots[i].m_key == key ) {
+                return (false);
+            }
+            i = (i + 1) & m_mask;
+            dist++;
+        }
+        if ( m_count >= m_mask ) {
+            /* keep one empty slot, the probes stop on it */
+            m_stats.m_full++;
+            return (false);
+        }
+        m_slots[i].m_key = key;
+        m_slots[i].m_val = val;
+        m_count++;
+        if ( m_count > m_stats.m_max_count ) {
+            m_stats.m_max_count = m_count;
+        }
+        if ( dist > m_stats.m_max_probe ) {
+            m_stats.m_max_probe = dist;
+        }
+        return (true);
+    }
+
+    void remove_all(free_map_object_func_t func){
+        if ( m_count == 0 ) 
+            return;
+
+        uint64_t i;
+        for (i=0; i<=m_mask; i++) {
+            if ( m_slots[i].m_val ) {
+                func(m_slots[i].m_val);
+                m_slots[i].m_val = 0;
+            }
+        }
+        m_count = 0;
+    }
+
+    void dump_all(FILE *fd){
+        uint64_t i;
+        for (i=0; i<=m_mask; i++) {
+            if ( m_slots[i].m_val ) {
+                m_slots[i].m_val->Dump(fd);
+            }
+        }
+    }
+
+    uint64_t count(void){
+        return ( m_count );
+    }
+
+    /* occupancy */
+    uint64_t get_capacity(void){
+        return ( m_mask + 1 );
+    }
+
+    uint64_t get_max_count(void){
+        return ( m_stats.m_max_count );
+    }
+
+    uint32_t get_max_probe(void){
+        return ( m_stats.m_max_probe );
+    }
+
+    uint64_t get_full(void){
+        return ( m_stats.m_full );
+    }
+
+    void dump_stats(FILE *fd){
+        fprintf(fd," count     : %llu \n",(unsigned long long)m_count);
+        fprintf(fd," capacity  : %llu \n",(unsigned long long)get_capacity());
+        fprintf(fd," max_count : %llu \n",(unsigned long long)m_stats.m_max_count);
+        fprintf(fd," max_probe : %lu \n",(unsigned long)m_stats.m_max_probe);
+        fprintf(fd," full      : %llu \n",(unsigned long long)m_stats.m_full);
+    }
+
+private:
+    struct slot_t {
+        KEY   m_key;
+        VAL * m_val;   /* NULL for an empty slot */
+    };
+
+    /* fibonacci hash, the high bits of the product are the index */
+    inline uint32_t hash(KEY key){
+        return ( (uint32_t)(((uint64_t)key * 0x9e3779b97f4a7c15ULL) >> m_shift) );
+    }
+
+    /* the slot of the key or the empty slot that ends its cluster */
+    inline uint32_t find(KEY key){
+        uint32_t i = hash(key);
+        while ( m_slots[i].m_val && (m_slots[i].m_key != key) ) {
+            i = (i + 1) & m_mask;
+        }
+        return (i);
+    }
+
+    /* empty slot i, an entry of the cluster moves into it if it is not before its hash slot */
+    void shift_back(uint32_t i){
+        uint32_t j = i;
+        while ( true ) {
+            j = (j + 1) & m_mask;
+            if ( m_slots[j].m_val == 0 ) {
+                break;
+            }
+            uint32_t h = hash(m_slots[j].m_key);
+            if ( ((j - h) & m_mask) >= ((j - i) & m_mask) ) {
+                m_slots[i] = m_slots[j];
+                i = j;
+            }
+        }
+        m_slots[i].m_val = 0;
+    }
+
+    void clear_stats(){
+        m_stats.m_max_count = 0;
+        m_stats.m_max_probe = 0;
+        m_stats.m_full      = 0;
+    }
+
+private:
+    slot_t *    m_slots;
+    uint64_t    m_mask;    /* size - 1 */
+    uint32_t    m_shift;   /* 64 - log2(size) */
+    uint64_t    m_count;
+
+    struct {
+        uint64_t m_max_count;  /* high water mark of count */
+        uint32_t m_max_probe;  /* longest probe of an add */
+        uint64_t m_full;       /* add failed, the map was full */
+    } m_stats;
+};
+
 #endif
@@ -31,6 +31,7 @@ limitations under the License.
 #include <trex_rpc_server_api.h>
 #include <iostream>
 #include <vector>
+#include <set>
 
 
 
@@ -257,7 +258,7 @@ TEST_F(basic_vm, vm2) {
                  2, 
                  3}; 
 
-    uint32_t random_per_thread=0;
+    uint64_t random_per_thread=0;
     int i;
     for (i=0; i<20; i++) {
         runner.run(&random_per_thread,
@@ -336,7 +337,7 @@ TEST_F(basic_vm, vm3) {
                  2, 
                  3}; 
 
-    uint32_t random_per_thread=0;
+    uint64_t random_per_thread=0;
 
     int i;
     for (i=0; i<20; i++) {
@@ -422,7 +423,7 @@ TEST_F(basic_vm, vm4) {
                  2, 
                  3}; 
 
-    uint32_t random_per_thread=0;
+    uint64_t random_per_thread=0;
 
     int i;
     for (i=0; i<20; i++) {
@@ -566,7 +567,7 @@ TEST_F(basic_vm, vm5) {
             0x17, 
          }; 
 
-    uint32_t random_per_thread=0;
+    uint64_t random_per_thread=0;
 
     int i;
     for (i=0; i<20; i++) {
@@ -634,7 +635,7 @@ TEST_F(basic_vm, vm6) {
 
     StreamDPVmInstructionsRunner runner;
 
-    uint32_t random_per_thread=0;
+    uint64_t random_per_thread=0;
 
     int i;
     for (i=0; i<20; i++) {
@@ -702,7 +703,7 @@ TEST_F(basic_vm, vm7) {
 
     StreamDPVmInstructionsRunner runner;
 
-    uint32_t random_per_thread=0;
+    uint64_t random_per_thread=0;
 
     int i;
     for (i=0; i<20; i++) {
@@ -769,7 +770,7 @@ TEST_F(basic_vm, vm8) {
 
     StreamDPVmInstructionsRunner runner;
 
-    uint32_t random_per_thread=0;
+    uint64_t random_per_thread=0;
 
     int i;
     for (i=0; i<20; i++) {
@@ -847,7 +848,7 @@ TEST_F(basic_vm, vm9) {
 
     StreamDPVmInstructionsRunner runner;
 
-    uint32_t random_per_thread=0;
+    uint64_t random_per_thread=0;
 
     int i;
     for (i=0; i<30; i++) {
@@ -902,7 +903,7 @@ TEST_F(basic_vm, vm10) {
 
     StreamDPVmInstructionsRunner runner;
 
-    uint32_t random_per_thread=0;
+    uint64_t random_per_thread=0;
 
     int i;
     for (i=0; i<30; i++) {
@@ -930,7 +931,7 @@ TEST_F(basic_vm, vm10) {
 TEST_F(basic_vm, vm_syn_attack) {
 
     StreamVm vm;
-    srand(0x1234);
+    utl_rand_set_seed(0x1234);
 
     vm.add_instruction( new StreamVmInstructionFlowMan( "ip_src",
                                                         4,
@@ -1003,7 +1004,8 @@ TEST_F(basic_vm, vm_syn_attack) {
 
     StreamDPVmInstructionsRunner runner;
 
-    uint32_t random_per_thread=0;
+    uint64_t random_per_thread;
+    vm_srand(&random_per_thread,0);
 
     int i;
     for (i=0; i<30; i++) {
@@ -1030,6 +1032,273 @@ TEST_F(basic_vm, vm_syn_attack) {
 
 
 
+/* programs for the fused kernels, same programs compiled with and without fusion */
+static void vm_fused_prog(StreamVm & vm, int prog){
+    switch (prog) {
+    case 0:
+        /* vm1 : inc8 + write + ipv4 fix */
+        vm.add_instruction( new StreamVmInstructionFlowMan( "var1",1,
+                                                            StreamVmInstructionFlowMan::FLOW_VAR_OP_INC,0,1,7 ) );
+        vm.add_instruction( new StreamVmInstructionWriteToPkt( "var1",26, 0,true) );
+        vm.add_instruction( new StreamVmInstructionFixChecksumIpv4(14) );
+        break;
+    case 1:
+        /* vars first, then the writes, all sizes and endians */
+        vm.add_instruction( new StreamVmInstructionFlowMan( "ip_src",4,
+                                                            StreamVmInstructionFlowMan::FLOW_VAR_OP_INC,0x10000001,0x10000001,0x100000ff ) );
+        vm.add_instruction( new StreamVmInstructionFlowMan( "port",2,
+                                                            StreamVmInstructionFlowMan::FLOW_VAR_OP_DEC,5,1,9 ) );
+        vm.add_instruction( new StreamVmInstructionFlowMan( "rnd",2,
+                                                            StreamVmInstructionFlowMan::FLOW_VAR_OP_RANDOM,0,10,1000 ) );
+        vm.add_instruction( new StreamVmInstructionFlowMan( "tos",1,
+                                                            StreamVmInstructionFlowMan::FLOW_VAR_OP_DEC,1,0,255 ) );
+        vm.add_instruction( new StreamVmInstructionFlowMan( "big",8,
+                                                            StreamVmInstructionFlowMan::FLOW_VAR_OP_INC,7,7,9 ) );
+        vm.add_instruction( new StreamVmInstructionWriteToPkt( "tos",15, 3,true) );
+        vm.add_instruction( new StreamVmInstructionWriteToPkt( "ip_src",26, 0,true) );
+        vm.add_instruction( new StreamVmInstructionWriteToPkt( "ip_src",30, -1,false) );
+        vm.add_instruction( new StreamVmInstructionFixChecksumIpv4(14) );
+        vm.add_instruction( new StreamVmInstructionWriteToPkt( "port",34, 100,false) );
+        vm.add_instruction( new StreamVmInstructionWriteToPkt( "rnd",36, 0,true) );
+        vm.add_instruction( new StreamVmInstructionWriteToPkt( "big",40, 1,true) );
+        break;
+    case 2:
+        /* client var, ip/port written back to back */
+        vm.add_instruction( new StreamVmInstructionFlowClient( "cl",
+                                                               0x10000001,0x10000007,
+                                                               1025,1027,
+                                                               20,0 ) );
+        vm.add_instruction( new StreamVmInstructionWriteToPkt( "cl.ip",26, 0,true) );
+        vm.add_instruction( new StreamVmInstructionWriteToPkt( "cl.port",34, 0,true) );
+        vm.add_instruction( new StreamVmInstructionFixChecksumIpv4(14) );
+        break;
+    default:
+        /* unlimited client var, port first and the ip later */
+        vm.add_instruction( new StreamVmInstructionFlowClient( "cl",
+                                                               0x10000001,0x10000003,
+                                                               0,0,
+                                                               0,StreamVmInstructionFlowClient::CLIENT_F_UNLIMITED_FLOWS ) );
+        vm.add_instruction( new StreamVmInstructionWriteToPkt( "cl.port",34, 1,false) );
+        vm.add_instruction( new StreamVmInstructionFixChecksumIpv4(14) );
+        vm.add_instruction( new StreamVmInstructionWriteToPkt( "cl.ip",26, 0,true) );
+        break;
+    }
+}
+
+#define VM_FUSED_PROGS 4
+
+static int vm_ins_count(StreamVm & vm){
+    uint8_t * p   = vm.get_dp_instruction_buffer()->get_program();
+    uint8_t * end = p + vm.get_dp_instruction_buffer()->get_program_size();
+    int cnt=0;
+    while (p < end) {
+        p += StreamDPVmInstructions::get_ins_size(*p);
+        cnt++;
+    }
+    return (cnt);
+}
+
+/* the fused program writes the same packets as the interpreted one */
+TEST_F(basic_vm, vm_fused) {
+    int prog;
+    for (prog=0; prog<VM_FUSED_PROGS; prog++) {
+        StreamVm vm_ref;
+        StreamVm vm_fused;
+        vm_fused_prog(vm_ref,prog);
+        vm_fused_prog(vm_fused,prog);
+        utl_rand_set_seed(0x1234);
+        vm_ref.compile(128,false);
+        utl_rand_set_seed(0x1234);
+        vm_fused.compile(128);
+
+        EXPECT_LT(vm_ins_count(vm_fused), vm_ins_count(vm_ref));
+
+        uint8_t pkt_ref[128];
+        uint8_t pkt_fused[128];
+        int i;
+        for (i=0; i<128; i++) {
+            pkt_ref[i] = (uint8_t)i;
+        }
+        pkt_ref[14] = 0x45;
+        memcpy(pkt_fused,pkt_ref,sizeof(pkt_ref));
+
+        StreamDPVmInstructionsRunner runner;
+        uint64_t rnd_ref;
+        uint64_t rnd_fused;
+        vm_srand(&rnd_ref,prog);
+        vm_srand(&rnd_fused,prog);
+        for (i=0; i<1000; i++) {
+            runner.run(&rnd_ref,
+                       vm_ref.get_dp_instruction_buffer()->get_program_size(),
+                       vm_ref.get_dp_instruction_buffer()->get_program(),
+                       vm_ref.get_bss_ptr(),
+                       pkt_ref);
+            runner.run(&rnd_fused,
+                       vm_fused.get_dp_instruction_buffer()->get_program_size(),
+                       vm_fused.get_dp_instruction_buffer()->get_program(),
+                       vm_fused.get_bss_ptr(),
+                       pkt_fused);
+            ASSERT_EQ(0, memcmp(pkt_ref,pkt_fused,sizeof(pkt_ref))) << "prog " << prog << " pkt " << i;
+        }
+        EXPECT_EQ(0, memcmp(vm_ref.get_bss_ptr(),vm_fused.get_bss_ptr(),vm_ref.get_bss_size()));
+    }
+}
+
+/* eth/ipv4/udp or tcp packet with valid checksums */
+static void vm_cs_pkt(uint8_t * pkt,uint16_t len,uint8_t proto){
+    int i;
+    memset(pkt,0,len);
+    for (i=34; i<len; i++) {
+        pkt[i] = (uint8_t)(i*7);
+    }
+    pkt[12] = 0x08;
+    pkt[14] = 0x45;
+    *(uint16_t *)(pkt+16) = PKT_HTONS(len-14);
+    pkt[22] = 64;
+    pkt[23] = proto;
+    *(uint32_t *)(pkt+26) = PKT_HTONL(0x10000001);
+    *(uint32_t *)(pkt+30) = PKT_HTONL(0x30000001);
+    ((IPHeader *)(pkt+14))->updateCheckSum();
+
+    uint16_t l4_len = len - 34;
+    uint16_t cs_of  = (proto == IPHeader::Protocol::UDP) ? 34+6 : 34+16;
+    if ( proto == IPHeader::Protocol::UDP ) {
+        *(uint16_t *)(pkt+34+4) = PKT_HTONS(l4_len);
+    }
+    *(uint16_t *)(pkt+cs_of) = 0;
+    uint32_t sum = pkt_SumInetChecksum(pkt+26,8) + PKT_HTONS((uint16_t)proto) +
+                   PKT_HTONS(l4_len) + pkt_SumInetChecksum(pkt+34,l4_len);
+    *(uint16_t *)(pkt+cs_of) = (uint16_t)~pkt_FoldInetChecksum(sum);
+}
+
+static bool vm_cs_l4_valid(uint8_t * pkt,uint16_t len){
+    uint16_t l4_len = len - 34;
+    uint32_t sum = pkt_SumInetChecksum(pkt+26,8) + PKT_HTONS((uint16_t)pkt[23]) +
+                   PKT_HTONS(l4_len) + pkt_SumInetChecksum(pkt+34,l4_len);
+    return (pkt_FoldInetChecksum(sum) == 0xffff);
+}
+
+static bool vm_has_op(StreamVm & vm,uint8_t op_code){
+    uint8_t * p   = vm.get_dp_instruction_buffer()->get_program();
+    uint8_t * end = p + vm.get_dp_instruction_buffer()->get_program_size();
+    while (p < end) {
+        if (*p == op_code) {
+            return (true);
+        }
+        p += StreamDPVmInstructions::get_ins_size(*p);
+    }
+    return (false);
+}
+
+static void vm_cs_prog(StreamVm & vm,bool wr_after_fix){
+    vm.add_instruction( new StreamVmInstructionFlowMan( "ip_src",4,
+                                                        StreamVmInstructionFlowMan::FLOW_VAR_OP_INC,0x10000001,0x10000001,0x100000ff ) );
+    vm.add_instruction( new StreamVmInstructionFlowMan( "port",2,
+                                                        StreamVmInstructionFlowMan::FLOW_VAR_OP_DEC,5,1,9 ) );
+    vm.add_instruction( new StreamVmInstructionFlowMan( "tos",1,
+                                                        StreamVmInstructionFlowMan::FLOW_VAR_OP_RANDOM,0,0,255 ) );
+    vm.add_instruction( new StreamVmInstructionFlowMan( "pay",1,
+                                                        StreamVmInstructionFlowMan::FLOW_VAR_OP_INC,0,0,200 ) );
+    vm.add_instruction( new StreamVmInstructionWriteToPkt( "ip_src",26, 0,true) );
+    vm.add_instruction( new StreamVmInstructionWriteToPkt( "port",34, 1000,false) );
+    vm.add_instruction( new StreamVmInstructionWriteToPkt( "tos",15, 0,true) );
+    vm.add_instruction( new StreamVmInstructionWriteToPkt( "pay",47, 0,true) );
+    if ( wr_after_fix ) {
+        vm.add_instruction( new StreamVmInstructionFixChecksumIpv4(14) );
+        vm.add_instruction( new StreamVmInstructionWriteToPkt( "ip_src",30, 3,true) );
+    }else{
+        vm.add_instruction( new StreamVmInstructionWriteToPkt( "pay",56, 1,true) );
+        vm.add_instruction( new StreamVmInstructionFixChecksumIpv4(14) );
+    }
+}
+
+/* checksums kept by the writes give the same packets as the ipv4 fix, 
+   and a valid tcp/udp checksum */
+TEST_F(basic_vm, vm_cs_incremental) {
+    uint8_t protos[2] = { IPHeader::Protocol::UDP, IPHeader::Protocol::TCP };
+    const uint16_t len = 64;
+    int k;
+
+    for (k=0; k<4; k++) {
+        uint8_t proto        = protos[k & 1];
+        bool    wr_after_fix = (k >= 2);
+        uint16_t cs_of       = (proto == IPHeader::Protocol::UDP) ? 34+6 : 34+16;
+
+        uint8_t tmpl[len];
+        vm_cs_pkt(tmpl,len,proto);
+
+        StreamVm vm_ref;
+        StreamVm vm_cs;
+        vm_cs_prog(vm_ref,wr_after_fix);
+        vm_cs_prog(vm_cs,wr_after_fix);
+        utl_rand_set_seed(0x1234);
+        vm_ref.compile(len,false);
+        utl_rand_set_seed(0x1234);
+        vm_cs.compile(len,tmpl);
+
+        EXPECT_TRUE(vm_has_op(vm_ref,StreamDPVmInstructions::ditFIX_IPV4_CS));
+        EXPECT_FALSE(vm_has_op(vm_cs,StreamDPVmInstructions::ditFIX_IPV4_CS));
+
+        StreamDPVmInstructionsRunner runner;
+        uint64_t rnd_ref;
+        uint64_t rnd_cs;
+        vm_srand(&rnd_ref,k);
+        vm_srand(&rnd_cs,k);
+        int i;
+        for (i=0; i<1000; i++) {
+            uint8_t pkt_ref[len];
+            uint8_t pkt_cs[len];
+            memcpy(pkt_ref,tmpl,len);
+            memcpy(pkt_cs,tmpl,len);
+            runner.run(&rnd_ref,
+                       vm_ref.get_dp_instruction_buffer()->get_program_size(),
+                       vm_ref.get_dp_instruction_buffer()->get_program(),
+                       vm_ref.get_bss_ptr(),
+                       pkt_ref);
+            runner.run(&rnd_cs,
+                       vm_cs.get_dp_instruction_buffer()->get_program_size(),
+                       vm_cs.get_dp_instruction_buffer()->get_program(),
+                       vm_cs.get_bss_ptr(),
+                       pkt_cs);
+
+            /* the fix does not touch the l4 checksum */
+            ASSERT_EQ(0, memcmp(pkt_ref,pkt_cs,cs_of)) << "prog " << k << " pkt " << i;
+            ASSERT_EQ(0, memcmp(pkt_ref+cs_of+2,pkt_cs+cs_of+2,len-cs_of-2)) << "prog " << k << " pkt " << i;
+            ASSERT_TRUE(vm_cs_l4_valid(pkt_cs,len)) << "prog " << k << " pkt " << i;
+            if ( !wr_after_fix ) {
+                ASSERT_EQ(0, pkt_InetChecksum(pkt_cs+14,20)) << "prog " << k << " pkt " << i;
+            }
+        }
+    }
+}
+
+/* a packet with a wrong ipv4 checksum is repaired by the fix */
+TEST_F(basic_vm, vm_cs_bad_template) {
+    const uint16_t len = 64;
+    uint8_t tmpl[len];
+    vm_cs_pkt(tmpl,len,IPHeader::Protocol::UDP);
+    tmpl[24] ^= 0x55;
+
+    StreamVm vm;
+    vm_cs_prog(vm,false);
+    vm.compile(len,tmpl);
+
+    EXPECT_TRUE(vm_has_op(vm,StreamDPVmInstructions::ditFIX_IPV4_CS));
+
+    StreamDPVmInstructionsRunner runner;
+    uint64_t rnd;
+    vm_srand(&rnd,0);
+    uint8_t pkt[len];
+    memcpy(pkt,tmpl,len);
+    runner.run(&rnd,
+               vm.get_dp_instruction_buffer()->get_program_size(),
+               vm.get_dp_instruction_buffer()->get_program(),
+               vm.get_bss_ptr(),
+               pkt);
+    EXPECT_EQ(0, pkt_InetChecksum(pkt+14,20));
+}
+
+
 //////////////////////////////////////////////////////
 
                                            
@@ -2021,6 +2290,320 @@ TEST_F(basic_stl, single_pkt_burst1) {
 }
 
 
+/* same output with the cached mbuf sent as a static buffer */
+TEST_F(basic_stl, single_pkt_burst1_static_mbuf) {
+
+    CBasicStl t1;
+    CParserOption * po =&CGlobalInfo::m_options;
+    po->preview.setVMode(7);
+    po->preview.setFileWrite(true);
+    po->preview.setStlStaticMbuf(true);
+    po->out_file ="exp/stl_single_pkt_burst1_static";
+
+     TrexStreamsCompiler compile;
+
+
+     std::vector<TrexStream *> streams;
+
+     TrexStream * stream1 = new TrexStream(TrexStream::stSINGLE_BURST, 0,0);
+     stream1->set_pps(1.0);
+     stream1->set_single_burst(5);
+     stream1->m_enabled = true;
+     stream1->m_self_start = true;
+
+     CPcapLoader pcap;
+     pcap.load_pcap_file("cap2/udp_64B.pcap",0);
+     pcap.update_ip_src(0x10000001);
+     pcap.clone_packet_into_stream(stream1);
+
+     streams.push_back(stream1);
+
+     uint8_t port_id = 0;
+     std::vector<TrexStreamsCompiledObj *>objs;
+     assert(compile.compile(port_id, streams, objs));
+     TrexStatelessDpStart *lpstart = new TrexStatelessDpStart(port_id, 0, objs[0], 10.0 /*sec */ );
+
+     t1.m_msg = lpstart;
+
+     bool res=t1.init();
+
+     delete stream1 ;
+     po->preview.setStlStaticMbuf(false);
+
+     EXPECT_EQ_UINT32(1, res?1:0)<< "pass";
+}
+
+
+
+
+/* check the per stream tx counters of the DP core after the run */
+class CBBStreamTxStats: public CBasicStlSink {
+public:
+
+    virtual void call_after_init(CBasicStl * m_obj){
+    };
+    virtual void call_after_run(CBasicStl * m_obj){
+        std::vector<TrexStreamTxCounters> counters;
+        TrexStreamTxCounters others;
+        const TrexStreamsTxStats * tx_stats = m_core->get_stream_tx_stats();
+
+        /* another run of the port */
+        EXPECT_FALSE(tx_stats->snapshot(m_port_id, m_event_id + 1, counters, others));
+
+        ASSERT_TRUE(tx_stats->snapshot(m_port_id, m_event_id, counters, others));
+        EXPECT_EQ(0, others.m_pkts);
+        EXPECT_EQ(0, others.m_bytes);
+        ASSERT_EQ(m_expected.size(), counters.size());
+        for (int i = 0; i < (int)counters.size(); i++) {
+            EXPECT_EQ(m_expected[i].m_pkts, counters[i].m_pkts) << "stream " << i;
+            EXPECT_EQ(m_expected[i].m_bytes, counters[i].m_bytes) << "stream " << i;
+        }
+    };
+
+    uint8_t                           m_port_id;
+    int                               m_event_id;
+    std::vector<TrexStreamTxCounters> m_expected;
+};
+
+TEST_F(basic_stl, stream_tx_stats) {
+
+    CBasicStl t1;
+    CParserOption * po =&CGlobalInfo::m_options;
+    po->preview.setVMode(7);
+    po->preview.setFileWrite(true);
+    po->out_file ="exp/stl_single_pkt_burst1";
+
+     TrexStreamsCompiler compile;
+
+
+     std::vector<TrexStream *> streams;
+
+     TrexStream * stream1 = new TrexStream(TrexStream::stSINGLE_BURST, 0,0);
+     stream1->set_pps(1.0);
+     stream1->set_single_burst(5);
+     stream1->m_enabled = true;
+     stream1->m_self_start = true;
+
+     CPcapLoader pcap;
+     pcap.load_pcap_file("cap2/udp_64B.pcap",0);
+     pcap.update_ip_src(0x10000001);
+     pcap.clone_packet_into_stream(stream1);
+
+     streams.push_back(stream1);
+
+     uint8_t port_id = 0;
+     std::vector<TrexStreamsCompiledObj *>objs;
+     assert(compile.compile(port_id, streams, objs));
+     TrexStatelessDpStart *lpstart = new TrexStatelessDpStart(port_id, 0, objs[0], 10.0 /*sec */ );
+
+     CBBStreamTxStats sink;
+     TrexStreamTxCounters expected;
+     expected.m_pkts  = 5;
+     expected.m_bytes = 5 * stream1->m_pkt.len;
+     sink.m_port_id  = port_id;
+     sink.m_event_id = 0;
+     sink.m_expected.push_back(expected);
+
+     t1.m_msg = lpstart;
+     t1.m_sink = &sink;
+
+     bool res=t1.init();
+
+     delete stream1 ;
+
+     EXPECT_EQ_UINT32(1, res?1:0)<< "pass";
+}
+
+/* the streams past MAX_STREAMS don't share the counter of the last one */
+TEST_F(basic_stl, stream_tx_stats_others) {
+    void *p;
+    ASSERT_EQ(0, posix_memalign(&p, 64, sizeof(TrexStreamsTxStats)));
+    TrexStreamsTxStats * tx_stats = (TrexStreamsTxStats *)p;
+    const uint32_t max = TrexStreamsTxStats::MAX_STREAMS;
+    std::vector<TrexStreamTxCounters> counters;
+    TrexStreamTxCounters others;
+
+    tx_stats->create();
+    tx_stats->start_port(1, 7, max + 10);
+    tx_stats->get_counters(1, max - 1)->m_pkts += 1;
+    tx_stats->get_counters(1, max)->m_pkts     += 2;
+    tx_stats->get_counters(1, max + 9)->m_pkts += 3;
+    tx_stats->publish();
+
+    ASSERT_TRUE(tx_stats->snapshot(1, 7, counters, others));
+    ASSERT_EQ(max, counters.size());
+    EXPECT_EQ(1, counters[max - 1].m_pkts);
+    EXPECT_EQ(5, others.m_pkts);
+
+    free(p);
+}
+
+
+/* feed the packets of the run to the rx side, the 2nd and 3rd packets are swapped on a second rx */
+class CBBStreamRxStats: public CBasicStlSink {
+public:
+
+    virtual void call_after_init(CBasicStl * m_obj){
+    };
+    virtual void call_after_run(CBasicStl * m_obj){
+        TrexStreamsRxStats * rx = new TrexStreamsRxStats();
+        TrexStreamsRxStats * rx_ooo = new TrexStreamsRxStats();
+        rx->create(TrexStreamRxSig::SIM_TICK_HZ);
+        rx_ooo->create(TrexStreamRxSig::SIM_TICK_HZ);
+
+        std::vector<CCapPktRaw *> pkts;
+        CCapReaderBase * lp=CCapReaderFactory::CreateReader((char *)m_file.c_str(),0);
+        ASSERT_TRUE(lp != NULL);
+        while ( true ) {
+            CCapPktRaw * pkt = new CCapPktRaw();
+            if ( lp->ReadPacket(pkt) ==false ){
+                delete pkt;
+                break;
+            }
+            pkts.push_back(pkt);
+        }
+        delete lp;
+        ASSERT_EQ(m_pkts, pkts.size());
+
+        /* each packet is received 10 usec after it was sent, the erf length has the crc */
+        for (int i = 0; i < (int)pkts.size(); i++) {
+            CCapPktRaw * pkt = pkts[i];
+            hr_time_t now = (hr_time_t)((pkt->get_time() + 10e-6) * (double)TrexStreamRxSig::SIM_TICK_HZ);
+            rx->handle_pkt((uint8_t *)pkt->raw, m_pkt_len, now);
+
+            pkt = pkts[ (i == 1) ? 2 : (i == 2) ? 1 : i ];
+            rx_ooo->handle_pkt((uint8_t *)pkt->raw, m_pkt_len, now);
+        }
+
+        TrexStreamRxCounters c;
+        rx->get_counters(m_rx_id, c);
+        EXPECT_EQ(m_pkts, c.m_pkts);
+        EXPECT_EQ(m_pkts * m_pkt_len, c.m_bytes);
+        EXPECT_EQ(0, c.m_seq_drop);
+        EXPECT_EQ(0, c.m_seq_ooo);
+        EXPECT_EQ(0, c.m_seq_dup);
+        EXPECT_EQ(0, rx->get_no_sig());
+
+        const CHdrHistogram & h = rx->get_latency(m_rx_id);
+        EXPECT_EQ(m_pkts, h.get_cnt());
+        EXPECT_NEAR(10000.0, (double)h.get_percentile(50.0), 1000.0);
+        EXPECT_NEAR(10000.0, (double)h.get_max(), 1000.0);
+
+        rx_ooo->get_counters(m_rx_id, c);
+        EXPECT_EQ(m_pkts, c.m_pkts);
+        EXPECT_EQ(0, c.m_seq_drop);
+        EXPECT_EQ(1, c.m_seq_ooo);
+        EXPECT_EQ(0, c.m_seq_dup);
+
+        /* the udp checksum follows the signature, the sum of the udp header and payload is as the stream */
+        uint16_t sig_off;
+        uint16_t csum_off;
+        ASSERT_TRUE(TrexStreamRxSig::get_offset(m_ref, m_pkt_len, sig_off, csum_off));
+        ASSERT_NE(0, csum_off);
+        uint16_t l4_off = csum_off - 6;
+        uint16_t l4_len = (m_ref[l4_off + 4] << 8) | m_ref[l4_off + 5];
+        uint16_t ref_sum = pkt_FoldInetChecksum(pkt_SumInetChecksum((uint8_t *)m_ref + l4_off, l4_len));
+        for (auto pkt : pkts) {
+            EXPECT_EQ(ref_sum, pkt_FoldInetChecksum(pkt_SumInetChecksum((uint8_t *)pkt->raw + l4_off, l4_len)));
+        }
+
+        for (auto pkt : pkts) {
+            delete pkt;
+        }
+        delete rx;
+        delete rx_ooo;
+    };
+
+    std::string m_file;
+    uint16_t    m_rx_id;
+    uint64_t    m_pkts;
+    uint64_t    m_pkt_len;
+    const uint8_t * m_ref; /* the packet of the stream */
+};
+
+TEST_F(basic_stl, stream_rx_sig) {
+
+    CBasicStl t1;
+    CParserOption * po =&CGlobalInfo::m_options;
+    po->preview.setVMode(7);
+    po->preview.setFileWrite(true);
+    po->out_file ="exp/stl_rx_sig";
+
+     TrexStreamsCompiler compile;
+
+
+     std::vector<TrexStream *> streams;
+
+     TrexStream * stream1 = new TrexStream(TrexStream::stSINGLE_BURST, 0,0);
+     stream1->set_pps(1.0);
+     stream1->set_single_burst(5);
+     stream1->m_enabled = true;
+     stream1->m_self_start = true;
+
+     stream1->m_rx_check.m_enable      = true;
+     stream1->m_rx_check.m_stream_id   = 5;
+     stream1->m_rx_check.m_seq_enabled = true;
+     stream1->m_rx_check.m_latency     = true;
+
+     CPcapLoader pcap;
+     pcap.load_pcap_file("cap2/udp_64B.pcap",0);
+     pcap.update_ip_src(0x10000001);
+     pcap.clone_packet_into_stream(stream1);
+
+     streams.push_back(stream1);
+
+     uint8_t port_id = 0;
+     std::vector<TrexStreamsCompiledObj *>objs;
+     assert(compile.compile(port_id, streams, objs));
+     TrexStatelessDpStart *lpstart = new TrexStatelessDpStart(port_id, 0, objs[0], 10.0 /*sec */ );
+
+     CBBStreamRxStats sink;
+     sink.m_file    = po->out_file + "-0.erf";
+     sink.m_rx_id   = 5;
+     sink.m_pkts    = 5;
+     sink.m_pkt_len = stream1->m_pkt.len;
+     sink.m_ref     = stream1->m_pkt.binary;
+
+     t1.m_msg = lpstart;
+     t1.m_sink = &sink;
+
+     bool res=t1.init();
+
+     delete stream1 ;
+
+     EXPECT_EQ_UINT32(1, res?1:0)<< "pass";
+}
+
+/* a late packet takes back its drop, a duplicate is counted apart */
+TEST_F(basic_stl, stream_rx_seq_dup) {
+    TrexStreamsRxStats * rx = new TrexStreamsRxStats();
+    TrexStreamRxSig sig;
+    TrexStreamRxCounters c;
+    const uint32_t seqs[] = { 0, 1, 3, 2, 2, 1, 4, 100, 50, 50, 3 };
+    int i;
+
+    rx->create(TrexStreamRxSig::SIM_TICK_HZ);
+    memset(&sig, 0, sizeof(sig));
+    sig.m_magic = TrexStreamRxSig::MAGIC;
+    sig.m_flags = TrexStreamRxSig::F_SEQ | 5;
+    sig.m_rx_id = 7;
+    for (i=0; i<(int)(sizeof(seqs)/sizeof(seqs[0])); i++) {
+        sig.m_seq = seqs[i];
+        rx->handle_sig(&sig, 64, 0);
+    }
+
+    rx->get_counters(7, c);
+    EXPECT_EQ(11, c.m_pkts);
+    /* 2 and 5..99 were dropped, 2 and 50 came late. 3 is too old to
+       tell from a late packet */
+    EXPECT_EQ(93, c.m_seq_drop);
+    EXPECT_EQ(3, c.m_seq_ooo);
+    /* 2, 1 and 50 again */
+    EXPECT_EQ(3, c.m_seq_dup);
+
+    delete rx;
+}
+
 
 
 TEST_F(basic_stl, single_pkt) {
@@ -2070,6 +2653,74 @@ TEST_F(basic_stl, single_pkt) {
 }
 
 
+class CBurstStats: public CBasicStlSink {
+public:
+
+    virtual void call_after_init(CBasicStl * m_obj){
+    };
+    virtual void call_after_run(CBasicStl * m_obj){
+        m_events = m_core->m_node_gen.m_stl_burst_events;
+        m_pkts   = m_core->m_node_gen.m_stl_burst_pkts;
+        m_span   = m_core->m_node_gen.m_stl_burst_max_span;
+    };
+    uint64_t m_events;
+    uint64_t m_pkts;
+    double   m_span;
+};
+
+/* 100Kpps continues stream sent 8 packets per event, same packets and times as one per event */
+TEST_F(basic_stl, single_pkt_fast_burst) {
+
+    CBasicStl t1;
+    CParserOption * po =&CGlobalInfo::m_options;
+    po->preview.setVMode(7);
+    po->preview.setFileWrite(true);
+    po->out_file ="exp/stl_single_pkt_fast_burst";
+    po->m_stl_burst = 8;
+    po->m_stl_burst_thr_usec = 20;
+
+     TrexStreamsCompiler compile;
+
+     uint8_t port_id=0;
+
+     std::vector<TrexStream *> streams;
+
+     TrexStream * stream1 = new TrexStream(TrexStream::stCONTINUOUS,0,0);
+     stream1->set_pps(100000.0);
+
+     stream1->m_enabled = true;
+     stream1->m_self_start = true;
+     stream1->m_port_id= port_id;
+
+     CPcapLoader pcap;
+     pcap.load_pcap_file("cap2/udp_64B.pcap",0);
+     pcap.update_ip_src(0x10000001);
+     pcap.clone_packet_into_stream(stream1);
+                                    
+     streams.push_back(stream1);
+
+     std::vector<TrexStreamsCompiledObj *>objs;
+     assert(compile.compile(port_id, streams, objs));
+     TrexStatelessDpStart *lpstart = new TrexStatelessDpStart(port_id, 0, objs[0], 0.007995 /*sec */ );
+
+     CBurstStats sink;
+     t1.m_sink = &sink;
+     t1.m_time_diff = 0.0000001;
+     t1.m_msg = lpstart;
+
+     bool res=t1.init();
+
+     delete stream1 ;
+
+     po->m_stl_burst = 1;
+     po->m_stl_burst_thr_usec = 10;
+
+     EXPECT_EQ_UINT32(1, res?1:0)<< "pass";
+     EXPECT_EQ(100, sink.m_events);
+     EXPECT_EQ(800, sink.m_pkts);
+     EXPECT_NEAR(70.0e-6, sink.m_span, 1e-9);
+}
+
 TEST_F(basic_stl, multi_pkt1) {
 
     CBasicStl t1;
@@ -2940,4 +3591,342 @@ TEST_F(basic_stl, vm_split_client_var) {
 
 }
 
+/**
+ * compiles a stream for N cores, runs the VM of every core and 
+ * collects the value that a var writes to the packet 
+ */
+class VmSplitCoverage {
+
+public:
+
+    VmSplitCoverage(uint8_t dp_core_count, StreamVm::split_mode_e mode) {
+        m_dp_core_count = dp_core_count;
+
+        m_stream = new TrexStream(TrexStream::stCONTINUOUS, 0, 0);
+        m_stream->set_pps(1000);
+        m_stream->m_enabled = true;
+        m_stream->m_self_start = true;
+        m_stream->m_vm.set_split_mode(mode);
+
+        CPcapLoader pcap;
+        pcap.load_pcap_file("cap2/udp_64B.pcap",0);
+        pcap.clone_packet_into_stream(m_stream);
+    }
+
+    ~VmSplitCoverage() {
+        delete m_stream;
+    }
+
+    StreamVm & vm() {
+        return m_stream->m_vm;
+    }
+
+    /* values[core][pkt] of the big endian field at offset */
+    void run(int pkts, std::vector<uint16_t> offsets, std::vector<uint8_t> sizes) {
+        TrexStreamsCompiler compile;
+        std::vector<TrexStreamsCompiledObj *> objs;
+        std::vector<TrexStream *> streams;
+
+        streams.push_back(m_stream);
+        assert(compile.compile(0, streams, objs, m_dp_core_count));
+
+        m_values.clear();
+        m_values.resize(offsets.size());
+
+        for (uint8_t core = 0; core < m_dp_core_count; core++) {
+            StreamVmDp *dp = objs[core]->get_objects()[0].m_stream->getDpVm();
+            assert(dp);
+
+            uint8_t *bss = dp->clone_bss();
+            uint8_t pkt[2048];
+            memcpy(pkt, m_stream->m_pkt.binary, m_stream->m_pkt.len);
+            uint64_t random_per_thread;
+            vm_srand(&random_per_thread, core + 1);
+            StreamDPVmInstructionsRunner runner;
+
+            for (int v = 0; v < (int)offsets.size(); v++) {
+                m_values[v].push_back(std::vector<uint64_t>());
+            }
+
+            for (int i = 0; i < pkts; i++) {
+                runner.run(&random_per_thread, dp->get_program_size(), dp->get_program(), bss, pkt);
+                for (int v = 0; v < (int)offsets.size(); v++) {
+                    uint64_t val = 0;
+                    for (int b = 0; b < sizes[v]; b++) {
+                        val = (val << 8) | pkt[offsets[v] + b];
+                    }
+                    m_values[v][core].push_back(val);
+                }
+            }
+            free(bss);
+        }
+
+        for (auto obj : objs) {
+            delete obj;
+        }
+    }
+
+    /* the cores never share a value and together they have all the expected ones */
+    void check_cover(int var, std::set<uint64_t> expected) {
+        std::set<uint64_t> all;
+
+        for (uint8_t core = 0; core < m_dp_core_count; core++) {
+            std::set<uint64_t> core_values(m_values[var][core].begin(), m_values[var][core].end());
+            for (uint64_t val : core_values) {
+                EXPECT_EQ(1, expected.count(val)) << "var " << var << " core " << (int)core << " value " << val;
+                EXPECT_EQ(0, all.count(val)) << "var " << var << " core " << (int)core << " value " << val << " is generated by another core";
+                all.insert(val);
+            }
+        }
+        EXPECT_EQ(expected.size(), all.size()) << "var " << var;
+    }
+
+    /* round r of the cores is the next N values of the original sequence */
+    void check_order(int var, const std::vector<uint64_t> &sequence, int rounds) {
+        for (int r = 0; r < rounds; r++) {
+            std::set<uint64_t> round;
+            std::set<uint64_t> expected;
+            for (uint8_t core = 0; core < m_dp_core_count; core++) {
+                round.insert(m_values[var][core][r]);
+                expected.insert(sequence[r * m_dp_core_count + core]);
+            }
+            EXPECT_TRUE(round == expected) << "var " << var << " round " << r;
+        }
+    }
+
+    static std::set<uint64_t> range(uint64_t min, uint64_t max, uint64_t step = 1) {
+        std::set<uint64_t> s;
+        for (uint64_t v = min; v <= max; v += step) {
+            s.insert(v);
+        }
+        return s;
+    }
+
+    std::vector<std::vector<std::vector<uint64_t> > > m_values;
+
+private:
+    uint8_t      m_dp_core_count;
+    TrexStream  *m_stream;
+};
+
+/* no split instruction, every var is split */
+TEST_F(basic_stl, vm_split_all_vars_block) {
+    VmSplitCoverage t(4, StreamVm::SPLIT_BY_BLOCK);
+
+    t.vm().add_instruction(new StreamVmInstructionFlowMan("a", 2, StreamVmInstructionFlowMan::FLOW_VAR_OP_INC, 1000, 1000, 1999));
+    t.vm().add_instruction(new StreamVmInstructionFlowMan("b", 4, StreamVmInstructionFlowMan::FLOW_VAR_OP_DEC, 70000, 10000, 70001));
+    t.vm().add_instruction(new StreamVmInstructionFlowMan("c", 2, StreamVmInstructionFlowMan::FLOW_VAR_OP_RANDOM, 0, 0, 99));
+    t.vm().add_instruction(new StreamVmInstructionWriteToPkt("a", 42));
+    t.vm().add_instruction(new StreamVmInstructionWriteToPkt("b", 44));
+    t.vm().add_instruction(new StreamVmInstructionWriteToPkt("c", 48));
+
+    /* b has 60002 values, core 0 has the 2 left over */
+    t.run(15002, {42, 44, 48}, {2, 4, 2});
+
+    t.check_cover(0, VmSplitCoverage::range(1000, 1999));
+    t.check_cover(1, VmSplitCoverage::range(10000, 70001));
+    t.check_cover(2, VmSplitCoverage::range(0, 99));
+}
+
+/* by stride, the cores together keep the order of the original sequence */
+TEST_F(basic_stl, vm_split_all_vars_stride) {
+    VmSplitCoverage t(4, StreamVm::SPLIT_BY_STRIDE);
+
+    t.vm().add_instruction(new StreamVmInstructionFlowMan("a", 2, StreamVmInstructionFlowMan::FLOW_VAR_OP_INC, 1005, 1000, 1999));
+    t.vm().add_instruction(new StreamVmInstructionFlowMan("b", 1, StreamVmInstructionFlowMan::FLOW_VAR_OP_DEC, 18, 0, 199));
+    t.vm().add_instruction(new StreamVmInstructionFlowMan("c", 2, StreamVmInstructionFlowMan::FLOW_VAR_OP_RANDOM, 0, 0, 99));
+    t.vm().add_instruction(new StreamVmInstructionWriteToPkt("a", 42));
+    t.vm().add_instruction(new StreamVmInstructionWriteToPkt("b", 44));
+    t.vm().add_instruction(new StreamVmInstructionWriteToPkt("c", 48));
+
+    t.run(250, {42, 44, 48}, {2, 1, 2});
+
+    t.check_cover(0, VmSplitCoverage::range(1000, 1999));
+    t.check_cover(1, VmSplitCoverage::range(0, 199));
+    t.check_cover(2, VmSplitCoverage::range(0, 99));
+
+    std::vector<uint64_t> seq_a;
+    std::vector<uint64_t> seq_b;
+    for (int i = 0; i < 1000; i++) {
+        seq_a.push_back(1000 + (5 + i) % 1000);
+        seq_b.push_back((18 + 200 - (i % 200)) % 200);
+    }
+    t.check_order(0, seq_a, 250);
+    t.check_order(1, seq_b, 50);
+}
+
+/* a var with a step, max is not on the step */
+TEST_F(basic_stl, vm_split_step) {
+    VmSplitCoverage block(3, StreamVm::SPLIT_BY_BLOCK);
+    VmSplitCoverage stride(3, StreamVm::SPLIT_BY_STRIDE);
+    VmSplitCoverage *tests[] = { &block, &stride };
+
+    for (VmSplitCoverage *t : tests) {
+        t->vm().add_instruction(new StreamVmInstructionFlowMan("a", 4, StreamVmInstructionFlowMan::FLOW_VAR_OP_INC, 10, 10, 10 + 7 * 299 + 5, 7));
+        t->vm().add_instruction(new StreamVmInstructionFlowMan("b", 2, StreamVmInstructionFlowMan::FLOW_VAR_OP_RANDOM, 3, 3, 3 + 5 * 59, 5));
+        t->vm().add_instruction(new StreamVmInstructionWriteToPkt("a", 42));
+        t->vm().add_instruction(new StreamVmInstructionWriteToPkt("b", 46));
+
+        t->run(1000, {42, 46}, {4, 2});
+        t->check_cover(0, VmSplitCoverage::range(10, 10 + 7 * 299, 7));
+        t->check_cover(1, VmSplitCoverage::range(3, 3 + 5 * 59, 5));
+    }
+
+    std::vector<uint64_t> seq;
+    for (int i = 0; i < 300; i++) {
+        seq.push_back(10 + 7 * i);
+    }
+    stride.check_order(0, seq, 100);
+}
+
+TEST_F(basic_stl, vm_split_client_var_stride) {
+    VmSplitCoverage t(4, StreamVm::SPLIT_BY_STRIDE);
+
+    StreamVmInstructionVar *client = new StreamVmInstructionFlowClient("cl", 0x10000001, 0x10000064, 5000, 5001, 0, 0);
+    t.vm().add_instruction(client);
+    t.vm().add_instruction(new StreamVmInstructionWriteToPkt("cl.ip", 26));
+    t.vm().add_instruction(new StreamVmInstructionWriteToPkt("cl.port", 34));
+    t.vm().set_split_instruction(client);
+
+    /* two rounds of the ips, the second one on the next port */
+    t.run(50, {26, 34}, {4, 2});
+
+    std::set<uint64_t> ips = VmSplitCoverage::range(0x10000001, 0x10000064);
+    t.check_cover(0, ips);
+
+    std::vector<uint64_t> seq(ips.begin(), ips.end());
+    t.check_order(0, seq, 25);
+
+    for (int core = 0; core < 4; core++) {
+        EXPECT_EQ(5000, t.m_values[1][core][0]);
+        EXPECT_EQ(5000, t.m_values[1][core][24]);
+        EXPECT_EQ(5001, t.m_values[1][core][25]);
+    }
+}
+
 /********************************************* Itay Tests End *************************************/
+
+
+/* builds the packets of the streams like the tx path does, nothing is written */
+class CBenchIFStl : public CErfIFStl {
+
+public:
+    CBenchIFStl(){
+        m_pkts  = 0;
+        m_bytes = 0;
+    }
+
+    virtual int send_node(CGenNode * no){
+        CGenNodeStateless * node_sl = (CGenNodeStateless *)no;
+
+        rte_mbuf_t * m = node_sl->get_cache_mbuf();
+        if (m) {
+            m_bytes += m->pkt_len;
+        }else{
+            m = node_sl->alloc_node_with_vm();
+            assert(m);
+            m_bytes += m->pkt_len;
+            rte_pktmbuf_free(m);
+        }
+        m_pkts++;
+        return (0);
+    }
+
+    uint64_t m_pkts;
+    uint64_t m_bytes;
+};
+
+/**
+ * runs the streams on one DP core for duration (sim) seconds as fast 
+ * as possible and reports the packet rate of the core
+ */
+static void stl_vm_tx_bench(const char *name,
+                            std::vector<TrexStream *> &streams,
+                            double duration){
+
+    TrexStreamsCompiler compile;
+    std::vector<TrexStreamsCompiledObj *> objs;
+
+    assert(compile.compile(0, streams, objs, 1));
+    for (auto stream : streams) {
+        delete stream;
+    }
+
+    TrexStatelessDpStart *lpStartCmd = new TrexStatelessDpStart(0, 0, objs[0], duration);
+
+    CParserOption * po =&CGlobalInfo::m_options;
+    po->preview.setVMode(0);
+    po->preview.setFileWrite(true);
+    po->out_file = "exp/stl_vm_tx_bench";
+
+    CFlowGenList fl;
+    CBenchIFStl  bench_vif;
+    fl.Create();
+    fl.generate_p_thread_info(1);
+    CFlowGenListPerThread * lpt = fl.m_threads_info[0];
+    lpt->set_vif(&bench_vif);
+
+    char buf[100];
+    sprintf(buf,"%s-%d.erf",po->out_file.c_str(),0);
+    lpt->start_stateless_simulation_file(buf,po->preview);
+
+    CMessagingManager * cp_dp = CMsgIns::Ins()->getCpDp();
+    assert(cp_dp->getRingCpToDp(0)->Enqueue((CGenNode *)lpStartCmd)==0);
+
+    hr_time_t start = os_get_hr_tick_64();
+    lpt->start_stateless_daemon_simulation();
+    dsec_t d = ptime_convert_hr_dsec(os_get_hr_tick_64() - start);
+
+    /* drop the DP events */
+    CNodeRing *ring = cp_dp->getRingDpToCp(0);
+    CGenNode * node;
+    while ( ring->Dequeue(node) == 0 ) {
+        delete (TrexStatelessDpToCpMsgBase *)node;
+    }
+    fl.Delete();
+
+    printf(" %-8s : %9lu pkts in %5.3f sec, %6.2f Mpps %6.2f Gbps per core \n",
+           name,
+           (ulong)bench_vif.m_pkts,
+           d,
+           (double)bench_vif.m_pkts / d / 1e6,
+           (double)bench_vif.m_bytes * 8.0 / d / 1e9);
+
+    EXPECT_GT(bench_vif.m_pkts, (uint64_t)0);
+}
+
+static TrexStream * stl_vm_bench_stream(const char *pcap_file, uint32_t stream_id, double pps){
+    CPcapLoader pcap;
+    pcap.load_pcap_file(pcap_file,0);
+
+    TrexStream * stream = new TrexStream(TrexStream::stCONTINUOUS, 0, stream_id);
+    stream->set_pps(pps);
+    stream->m_enabled = true;
+    stream->m_self_start = true;
+    pcap.clone_packet_into_stream(stream);
+
+    /* src ip and port, the usual range stream */
+    StreamVm &vm = stream->m_vm;
+    vm.add_instruction(new StreamVmInstructionFlowMan("ip_src", 4, StreamVmInstructionFlowMan::FLOW_VAR_OP_INC,
+                                                      0x10000001, 0x10000001, 0x100000fe));
+    vm.add_instruction(new StreamVmInstructionFlowMan("port", 2, StreamVmInstructionFlowMan::FLOW_VAR_OP_RANDOM,
+                                                      1025, 1025, 65000));
+    vm.add_instruction(new StreamVmInstructionWriteToPkt("ip_src", 26));
+    vm.add_instruction(new StreamVmInstructionWriteToPkt("port", 34));
+    vm.add_instruction(new StreamVmInstructionFixChecksumIpv4(14));
+    return (stream);
+}
+
+TEST_F(basic_stl, vm_tx_bench) {
+    std::vector<TrexStream *> streams;
+
+    streams.push_back(stl_vm_bench_stream("cap2/udp_64B.pcap", 0, 4000000.0));
+    stl_vm_tx_bench("64B", streams, 0.5);
+
+    /* 7:4:1 */
+    streams.clear();
+    streams.push_back(stl_vm_bench_stream("cap2/udp_64B.pcap", 0, 2800000.0));
+    streams.push_back(stl_vm_bench_stream("cap2/udp_594B.pcap", 1, 1600000.0));
+    streams.push_back(stl_vm_bench_stream("cap2/udp_1518B.pcap", 2, 400000.0));
+    stl_vm_tx_bench("imix", streams, 0.5);
+}
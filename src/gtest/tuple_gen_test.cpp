@@ -519,6 +519,107 @@ TEST(tuple_gen,try_to_free) {
 }
 
 
+/* CClientPortAlloc, window slide, promotion to a bitmap block and back */
+TEST(tuple_gen,port_alloc_window) {
+    CClientPortAlloc pa;
+    pa.Create(2, true);
+    int i;
+
+    /* in order return keeps the client in the window */
+    for (i=0; i<1000; i++) {
+        uint16_t port = pa.get_new_free_port(1);
+        EXPECT_EQ(MIN_PORT+i, port);
+        pa.return_port(1, port);
+    }
+    EXPECT_EQ(0, pa.get_blocks());
+
+    /* hold the first port, the 65th port needs a block */
+    uint16_t first = pa.get_new_free_port(0);
+    for (i=1; i<200; i++) {
+        EXPECT_EQ(first+i, pa.get_new_free_port(0));
+    }
+    EXPECT_EQ(1, pa.get_blocks());
+    EXPECT_EQ(200, pa.get_ports_in_use(0));
+    for (i=0; i<200; i++) {
+        pa.return_port(0, first+i);
+    }
+    EXPECT_EQ(1, pa.get_free_blocks());
+    EXPECT_EQ(first+200, pa.get_new_free_port(0));
+    pa.Delete();
+}
+
+/* all the ports of a client, then the allocator reports ILLEGAL_PORT */
+TEST(tuple_gen,port_alloc_full) {
+    CClientPortAlloc pa;
+    pa.Create(1, true);
+    int i;
+    for (i=0; i<MAX_PORT-MIN_PORT; i++) {
+        EXPECT_EQ(MIN_PORT+i, pa.get_new_free_port(0));
+    }
+    EXPECT_EQ(ILLEGAL_PORT, pa.get_new_free_port(0));
+    pa.return_port(0, 5000);
+    pa.return_port(0, 3000);
+    EXPECT_EQ(3000, pa.get_new_free_port(0));
+    EXPECT_EQ(5000, pa.get_new_free_port(0));
+    EXPECT_EQ(ILLEGAL_PORT, pa.get_new_free_port(0));
+    pa.return_all_ports();
+    EXPECT_EQ(MIN_PORT, pa.get_new_free_port(0));
+    pa.Delete();
+}
+
+/* random alloc/free against a bitset */
+TEST(tuple_gen,port_alloc_random) {
+    CClientPortAlloc pa;
+    std::bitset<MAX_PORT> ref[4];
+    std::vector<uint16_t> held[4];
+    pa.Create(4, true);
+    srand(7);
+
+    int i;
+    for (i=0; i<400000; i++) {
+        uint32_t c = rand() % 4;
+        /* clients hold a few ports, client 3 holds many */
+        uint32_t limit = (c == 3) ? 30000 : 40;
+        if ( held[c].size() && ((rand() % 2) || (held[c].size() >= limit)) ) {
+            uint32_t j = (c == 3) ? (rand() % held[c].size()) : 0;
+            uint16_t port = held[c][j];
+            held[c].erase(held[c].begin() + j);
+            ASSERT_TRUE(ref[c][port]);
+            ref[c][port] = 0;
+            pa.return_port(c, port);
+        } else {
+            uint16_t port = pa.get_new_free_port(c);
+            ASSERT_TRUE(pa.is_port_legal(port));
+            ASSERT_FALSE(ref[c][port]);
+            ref[c][port] = 1;
+            held[c].push_back(port);
+        }
+        ASSERT_EQ(held[c].size(), pa.get_ports_in_use(c));
+    }
+    EXPECT_LE(pa.get_blocks(), 4);
+    pa.Delete();
+}
+
+/* 1M clients keep a few bytes each */
+TEST(tuple_gen,clientPoolCompact) {
+    CClientPool gen;
+    gen.Create(cdSEQ_DIST, 
+               0x10000000, 0x100fffff, 64000,2000000,NULL,false, 
+               0,0);
+    EXPECT_EQ(0x100000, gen.get_total_ips());
+    CTupleBase result;
+    int i;
+    for (i=0; i<3*0x100000; i++) {
+        gen.GenerateTuple(result);
+        EXPECT_EQ(MIN_PORT+(i>>20), result.getClientPort());
+    }
+    EXPECT_EQ(0x10000000+5, gen.get_ip(5));
+    EXPECT_EQ(0, gen.get_port_alloc()->get_blocks());
+    EXPECT_EQ(0, gen.m_port_allocation_error);
+    gen.Delete();
+}
+
+
 
 /* tuple generator using CClientInfoL*/
 TEST(tuple_gen_2,GenerateTuple) {
@@ -705,6 +806,22 @@ TEST(tuple_gen_yaml,yam_is_valid) {
 
     EXPECT_EQ(fi.is_valid(8,true)?1:0, 1);
 
+    /* 10M clients, servers are still limited to 1M */
+    fi.m_client_pool[0].m_ip_start = 0x10000000;
+    fi.m_client_pool[0].m_ip_end   = 0x10000000 + MAX_CLIENTS - 1;
+
+    EXPECT_EQ(fi.is_valid(8,true)?1:0, 1);
+
+    fi.m_client_pool[0].m_ip_end   = 0x10000000 + MAX_CLIENTS;
+
+    EXPECT_EQ(fi.is_valid(8,true)?1:0, 0);
+
+    fi.m_client_pool[0].m_ip_end   = 0x100000ff;
+    fi.m_server_pool[0].m_ip_start = 0x10000000;
+    fi.m_server_pool[0].m_ip_end   = 0x10000000 + MAX_SERVERS;
+
+    EXPECT_EQ(fi.is_valid(8,true)?1:0, 0);
+
 }
 
 
@@ -26,6 +26,9 @@ limitations under the License.
 #include <vector>
 #include <string>
 
+class TrexStreamsTxStats;
+class TrexStreamsRxStats;
+
 /**
  * Global stats
  * 
@@ -110,6 +113,9 @@ public:
     virtual void get_global_stats(TrexPlatformGlobalStats &stats) const = 0;
     virtual void get_interface_stats(uint8_t interface_id, TrexPlatformInterfaceStats &stats) const = 0;
     virtual uint8_t get_dp_core_count() const = 0;
+    virtual const TrexStreamsTxStats * get_stream_tx_stats(uint8_t core_id) const = 0;
+    /* rx_stats of the streams received by a DP core, NULL if the core does not poll RX */
+    virtual const TrexStreamsRxStats * get_stream_rx_stats(uint8_t core_id) const = 0;
     
     virtual ~TrexPlatformApi() {}
 };
@@ -126,6 +132,8 @@ public:
     void get_global_stats(TrexPlatformGlobalStats &stats) const;
     void get_interface_stats(uint8_t interface_id, TrexPlatformInterfaceStats &stats) const;
     uint8_t get_dp_core_count() const;
+    const TrexStreamsTxStats * get_stream_tx_stats(uint8_t core_id) const;
+    const TrexStreamsRxStats * get_stream_rx_stats(uint8_t core_id) const;
     
 };
 
@@ -141,6 +149,12 @@ public:
     void get_interface_stats(uint8_t interface_id, TrexPlatformInterfaceStats &stats) const;
 
     uint8_t get_dp_core_count() const;
+    const TrexStreamsTxStats * get_stream_tx_stats(uint8_t core_id) const {
+        return (NULL);
+    }
+    const TrexStreamsRxStats * get_stream_rx_stats(uint8_t core_id) const {
+        return (NULL);
+    }
 };
 
 #endif /* __TREX_PLATFORM_API_H__ */
@@ -489,13 +489,24 @@ bool CCPortLatency::check_packet(rte_mbuf_t * m,CRx_check_header * & rx_p) {
 void CLatencyManager::Delete(){
     m_pkt_gen.Delete();
 
+    int i;
+    for (i=0; i<m_rx_cores; i++) {
+        CLatencyRxWorker * w=&m_rx[i];
+        if ( get_is_rx_check_mode() ) {
+            w->m_rx_check_manager.Delete();
+        }
+        w->m_cpu_cp_u.Delete();
+        int j;
+        for (j=0; j<m_rx_cores; j++) {
+            w->m_ring[j].Delete();
+        }
+    }
     if ( get_is_rx_check_mode() ) {
-        m_rx_check_manager.Delete();
+        m_rx_check_sum.m_hist.Delete();
     }
     if ( CGlobalInfo::is_learn_mode() ){
         m_nat_check_manager.Delete();
     }
-    m_cpu_cp_u.Delete();
 }
 
 /* 0->1
@@ -547,15 +558,36 @@ bool CLatencyManager::Create(CLatencyManagerCfg * cfg){
     m_d_time =ptime_convert_dsec_hr((1.0/m_cps));
     m_delta_sec =(1.0/m_cps);
 
-        
+    m_rx_cores = cfg->m_rx_cores;
+    assert( (m_rx_cores>0) && (m_rx_cores<=MAX_RX_CORES) );
+    m_rx_active = m_rx_cores;
+
+    for (i=0; i<m_rx_cores; i++) {
+        CLatencyRxWorker * w=&m_rx[i];
+        w->m_id = i;
+        if ( get_is_rx_check_mode() ) {
+            /* each core holds its part of the flows */
+            uint32_t flows = (CGlobalInfo::m_options.m_rx_check_flows + m_rx_cores-1)/m_rx_cores;
+            assert(w->m_rx_check_manager.Create(flows));
+            w->m_rx_check_manager.m_cur_time= now_sec();
+        }
+        w->m_cpu_cp_u.Create(&w->m_cpu_dp_u);
+        if ( m_rx_cores>1 ) {
+            int j;
+            for (j=0; j<m_rx_cores; j++) {
+                if ( j != i ) {
+                    char name[100];
+                    sprintf(name,"rx_check_%d_%d",j,i);
+                    w->m_ring[j].Create(std::string(name),1024,0);
+                }
+            }
+        }
+    }
     if ( get_is_rx_check_mode() ) {
-        assert(m_rx_check_manager.Create());
-        m_rx_check_manager.m_cur_time= now_sec();
-     }
-
+        m_rx_check_sum.create_stats();
+    }
 
     m_pkt_gen.set_ip(cfg->m_client_ip.v4,cfg->m_server_ip.v4,cfg->m_dual_port_mask);
-    m_cpu_cp_u.Create(&m_cpu_dp_u);
     if ( CGlobalInfo::is_learn_mode() ){
         m_nat_check_manager.Create();
     }
@@ -612,18 +644,69 @@ void  CLatencyManager::wait_for_rx_dump(){
 }
 
 
-void CLatencyManager::handle_rx_pkt(CLatencyManagerPerPort * lp,
+void CLatencyManager::handle_rx_pkt(CLatencyRxWorker * w,
+                                    CLatencyManagerPerPort * lp,
                                     rte_mbuf_t * m){
     CRx_check_header *rxc = NULL;
 
     lp->m_port.check_packet(m,rxc);
     if ( odp_unlikely(rxc!=NULL) ){
-        m_rx_check_manager.handle_packet(rxc);
+        handle_rx_check(w->m_id,rxc);
     }
 
     rte_pktmbuf_free(m);
 }
 
+void CLatencyManager::handle_rx_check(uint8_t id,CRx_check_header * rxh){
+    CLatencyRxWorker * w=&m_rx[id];
+    uint8_t owner = flow_rx_core(rxh->m_flow_id);
+    if ( odp_likely(owner == id) ){
+        w->m_rx_check_manager.handle_packet(rxh);
+        return;
+    }
+
+    /* the header is copied, the packet is freed here */
+    CGenNodeRxCheckPktInfo * node=(CGenNodeRxCheckPktInfo *)CGlobalInfo::create_node();
+    node->m_msg_type = CGenNodeMsgBase::RX_CHECK_PKT;
+    memcpy(&node->m_rxh,rxh,sizeof(CRx_check_header));
+    if ( m_rx[owner].m_ring[id].Enqueue((CGenNode *)node)!=0 ){
+        /* don't block the RX core, count it */
+        w->m_rx_check_manager.m_stats.m_err_queue_full++;
+        CGlobalInfo::free_node((CGenNode *)node);
+    }
+}
+
+void CLatencyManager::run_rx_ring(uint8_t id){
+    CLatencyRxWorker * w=&m_rx[id];
+    int i;
+    for (i=0; i<m_rx_active; i++) {
+        if ( i == id ) {
+            continue;
+        }
+        CNodeRing * r=&w->m_ring[i];
+        CGenNode * nodes[MSG_DEQUEUE_BURST];
+        uint32_t cnt;
+        while ( (cnt = r->DequeueBurst(nodes, MSG_DEQUEUE_BURST)) > 0 ) {
+            uint32_t j;
+            for (j=0; j<cnt; j++) {
+                CGenNodeRxCheckPktInfo * msg=(CGenNodeRxCheckPktInfo *)nodes[j];
+                assert(msg->m_msg_type==CGenNodeMsgBase::RX_CHECK_PKT);
+                w->m_rx_check_manager.handle_packet(&msg->m_rxh);
+                CGlobalInfo::free_node(nodes[j]);
+            }
+        }
+    }
+}
+
+RxCheckManager * CLatencyManager::get_rx_check_sum(){
+    m_rx_check_sum.clear_stats();
+    int i;
+    for (i=0; i<m_rx_cores; i++) {
+        m_rx_check_sum.add_stats(&m_rx[i].m_rx_check_manager);
+    }
+    return (&m_rx_check_sum);
+}
+
 void CLatencyManager::handle_latency_pkt_msg(uint8_t thread_id,
                                             CGenNodeLatencyPktInfo * msg){
 
@@ -632,33 +715,35 @@ void CLatencyManager::handle_latency_pkt_msg(uint8_t thread_id,
     uint8_t rx_port_index=(thread_id<<1)+(msg->m_dir&1);
     assert( rx_port_index <m_max_ports ) ;
     CLatencyManagerPerPort * lp=&m_ports[rx_port_index];
-    handle_rx_pkt(lp,(rte_mbuf_t *)msg->m_pkt);
+    handle_rx_pkt(&m_rx[0],lp,(rte_mbuf_t *)msg->m_pkt);
 }
 
 
 void  CLatencyManager::run_rx_queue_msgs(uint8_t thread_id,
                                          CNodeRing * r){
 
-    while ( true ) {
-        CGenNode * node;
-        if ( r->Dequeue(node)!=0 ){
-            break;
-        }
-        assert(node);
+    CGenNode * nodes[MSG_DEQUEUE_BURST];
+    uint32_t cnt;
+    while ( (cnt = r->DequeueBurst(nodes, MSG_DEQUEUE_BURST)) > 0 ) {
+        uint32_t i;
+        for (i=0; i<cnt; i++) {
+            CGenNode * node = nodes[i];
+            assert(node);
 
-        CGenNodeMsgBase * msg=(CGenNodeMsgBase *)node;
+            CGenNodeMsgBase * msg=(CGenNodeMsgBase *)node;
 
-        uint8_t   msg_type =  msg->m_msg_type;
-        switch (msg_type ) {
-        case CGenNodeMsgBase::LATENCY_PKT:
-            handle_latency_pkt_msg(thread_id,(CGenNodeLatencyPktInfo *) msg);
-            break;
-        default:
-            printf("ERROR latency-thread message type is not valid %d \n",msg_type);
-            assert(0);
-        }
+            uint8_t   msg_type =  msg->m_msg_type;
+            switch (msg_type ) {
+            case CGenNodeMsgBase::LATENCY_PKT:
+                handle_latency_pkt_msg(thread_id,(CGenNodeLatencyPktInfo *) msg);
+                break;
+            default:
+                printf("ERROR latency-thread message type is not valid %d \n",msg_type);
+                assert(0);
+            }
 
-        CGlobalInfo::free_node(node);
+            CGlobalInfo::free_node(node);
+        }
     }
 }
 
@@ -676,23 +761,28 @@ void  CLatencyManager::try_rx_queues(){
 }
 
 
-void  CLatencyManager::try_rx(){
+/* the ports of this RX core */
+void  CLatencyManager::try_rx(CLatencyRxWorker * w){
     rte_mbuf_t * rx_pkts[64];
+    uint8_t port_cores=rx_port_cores();
     int i;
-    for (i=0; i<m_max_ports; i++) {
+    if ( w->m_id >= port_cores ) {
+        return;
+    }
+    for (i=w->m_id; i<m_max_ports; i+=port_cores) {
         CLatencyManagerPerPort * lp=&m_ports[i];
         rte_mbuf_t * m;
-        m_cpu_dp_u.start_work();
+        w->m_cpu_dp_u.start_work();
         /* try to read 64 packets clean up the queue */
         uint16_t cnt_p = lp->m_io->rx_burst(rx_pkts, 64);
         if (cnt_p) {
             int j;
             for (j=0; j<cnt_p; j++) {
                 m=rx_pkts[j] ;
-                handle_rx_pkt(lp,m);
+                handle_rx_pkt(w,lp,m);
             }
             /* commit only if there was work to do ! */
-            m_cpu_dp_u.commit();
+            w->m_cpu_dp_u.commit();
           }/* if work */
       }// all ports
 }
@@ -712,6 +802,9 @@ void  CLatencyManager::start(int iter){
     m_do_stop =false;
     m_is_active =false;
     int cnt=0;
+    /* a limited run ( before the test ) has no other RX core */
+    m_rx_active = (iter>0) ? 1 : m_rx_cores;
+    CLatencyRxWorker * w=&m_rx[0];
 
     double n_time;
     CGenNode * node = new CGenNode();
@@ -739,7 +832,10 @@ void  CLatencyManager::start(int iter){
             if (do_try_rx_queue){
                 try_rx_queues();
             }
-            try_rx();
+            try_rx(w);
+            if ( m_rx_active>1 ) {
+                run_rx_ring(0);
+            }
             dry_run();
         }
 
@@ -755,12 +851,12 @@ void  CLatencyManager::start(int iter){
 
             break;
         case CGenNode::FLOW_PKT:
-            m_cpu_dp_u.start_work();
+            w->m_cpu_dp_u.start_work();
             send_pkt_all_ports();
             m_p_queue.pop();
             node->m_time += m_delta_sec;
             m_p_queue.push(node);
-            m_cpu_dp_u.commit();
+            w->m_cpu_dp_u.commit();
             break;
         }
 
@@ -786,9 +882,25 @@ void  CLatencyManager::start(int iter){
 
     printf(" latency daemon has stopped\n");
     if ( get_is_rx_check_mode() ) {
-        m_rx_check_manager.tw_drain();
+        w->m_rx_check_manager.tw_drain();
+    }
+    m_rx_active = m_rx_cores;
+}
+
+void  CLatencyManager::start_rx(uint8_t id){
+    assert( (id>0) && (id<m_rx_cores) );
+    CLatencyRxWorker * w=&m_rx[id];
+
+    while ( !m_do_stop ) {
+        try_rx(w);
+        run_rx_ring(id);
+        dry_run();
     }
 
+    printf(" rx core %d has stopped\n",id);
+    if ( get_is_rx_check_mode() ) {
+        w->m_rx_check_manager.tw_drain();
+    }
 }
 
 void  CLatencyManager::stop(){
@@ -872,9 +984,14 @@ void CLatencyManager::dump_json(std::string & json ){
 
 void CLatencyManager::dump_json_v2(std::string & json ){
     json="{\"name\":\"trex-latecny-v2\",\"type\":0,\"data\":{";
-    json+=add_json("cpu_util",m_cpu_cp_u.GetVal());
+    json+=add_json("cpu_util",m_rx[0].m_cpu_cp_u.GetVal());
 
     int i;
+    for (i=1; i<m_rx_cores; i++) {
+        char buff[100];
+        sprintf(buff,"rx_cpu_util-%d",i);
+        json+=add_json(buff,m_rx[i].m_cpu_cp_u.GetVal());
+    }
     for (i=0; i<m_max_ports; i++) {
         CLatencyManagerPerPort * lp=&m_ports[i];
         lp->m_port.dump_json_v2(json);
@@ -887,25 +1004,28 @@ void CLatencyManager::dump_json_v2(std::string & json ){
 void CLatencyManager::DumpRxCheck(FILE *fd){
     if ( get_is_rx_check_mode() ) {
         fprintf(fd," rx checker : \n");
-        m_rx_check_manager.DumpShort(fd);
-        m_rx_check_manager.Dump(fd);
+        RxCheckManager * lp=get_rx_check_sum();
+        lp->DumpShort(fd);
+        lp->Dump(fd);
     }
 }
 
 void CLatencyManager::DumpShortRxCheck(FILE *fd){
     if ( get_is_rx_check_mode() ) {
-        m_rx_check_manager.DumpShort(fd);
+        get_rx_check_sum()->DumpShort(fd);
     }
 }
 
 void CLatencyManager::rx_check_dump_json(std::string & json){
     if ( get_is_rx_check_mode() ) {
-        m_rx_check_manager.dump_json(json );
+        get_rx_check_sum()->dump_json(json );
     }
 }
 
 void CLatencyManager::update(){
-    m_cpu_cp_u.Update() ;
+    for (int i=0; i<m_rx_cores; i++) {
+        m_rx[i].m_cpu_cp_u.Update() ;
+    }
     for (int i=0; i<m_max_ports; i++) {
         CLatencyManagerPerPort * lp=&m_ports[i];
         lp->m_port.m_hist.update();
@@ -914,7 +1034,10 @@ void CLatencyManager::update(){
 
 void CLatencyManager::DumpShort(FILE *fd){
     int i;
-    fprintf(fd," Cpu Utilization : %2.1f %%  \n",m_cpu_cp_u.GetVal());
+    fprintf(fd," Cpu Utilization : %2.1f %%  \n",m_rx[0].m_cpu_cp_u.GetVal());
+    for (i=1; i<m_rx_cores; i++) {
+        fprintf(fd," Rx core %d Utilization : %2.1f %%  \n",i,m_rx[i].m_cpu_cp_u.GetVal());
+    }
     CCPortLatency::DumpShortHeader(fd);
     for (i=0; i<m_max_ports; i++) {
         fprintf(fd," %d | ",i);
@@ -928,7 +1051,7 @@ void CLatencyManager::DumpShort(FILE *fd){
 
 void CLatencyManager::Dump(FILE *fd){
     int i;
-    fprintf(fd," cpu : %2.1f  %% \n",m_cpu_cp_u.GetVal());
+    fprintf(fd," cpu : %2.1f  %% \n",m_rx[0].m_cpu_cp_u.GetVal());
     for (i=0; i<m_max_ports; i++) {
         fprintf(fd," port   %d \n",i);
         fprintf(fd," -----------------\n");
@@ -943,10 +1066,11 @@ void CLatencyManager::DumpRxCheckVerification(FILE *fd,
         fprintf(fd," rx_checker is disabled  \n");
         return;
     }
+    uint64_t total_rx=get_rx_check_sum()->getTotalRx();
     fprintf(fd," rx_check Tx : %llu \n", (unsigned long long)total_tx_rx_check);
-    fprintf(fd," rx_check Rx : %llu \n", (unsigned long long)m_rx_check_manager.getTotalRx() );
+    fprintf(fd," rx_check Rx : %llu \n", (unsigned long long)total_rx );
     fprintf(fd," rx_check verification :" );
-    if (m_rx_check_manager.getTotalRx() == total_tx_rx_check) {
+    if (total_rx == total_tx_rx_check) {
         fprintf(fd," OK \n" );
     }else{
         fprintf(fd," FAIL \n" );
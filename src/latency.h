@@ -22,6 +22,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 #include <bp_sim.h>
+#include "utl_rand.h"
 
 #define L_PKT_SUBMODE_NO_REPLY 1
 #define L_PKT_SUBMODE_REPLY 2
@@ -251,8 +252,10 @@ public:
         m_client_ip.v4=0x10000000;
         m_server_ip.v4=0x20000000;
         m_dual_port_mask=0x01000000;
+        m_rx_cores=1;
     }
     uint32_t             m_max_ports;
+    uint8_t              m_rx_cores;
     double               m_cps;// CPS
     CPortLatencyHWBase * m_ports[MAX_LATENCY_PORTS];
     ipaddr_t             m_client_ip;
@@ -271,6 +274,26 @@ public:
 };
 
 
+/* rx-check header that was received by the RX core of the port, handled
+   by the RX core that owns the flow */
+struct CGenNodeRxCheckPktInfo : public CGenNodeMsgBase  {
+    uint8_t           m_pad[7];
+    CRx_check_header  m_rxh;
+};
+
+
+/* one RX core. owns the ports (port % rx cores)==id and the rx-check flows
+   that hash to it, with its own flow table and aging timer wheel */
+class CLatencyRxWorker {
+public:
+    uint8_t          m_id;
+    RxCheckManager   m_rx_check_manager;
+    CCpuUtlDp        m_cpu_dp_u;
+    CCpuUtlCp        m_cpu_cp_u;
+    CNodeRing        m_ring[MAX_RX_CORES]; /* rx-check from RX core i, one producer each */
+};
+
+
 class CLatencyPktMode {
  public:
     uint8_t m_submode;
@@ -318,7 +341,10 @@ public:
     bool Create(CLatencyManagerCfg * cfg);
     void Delete();
     void  reset();
+    /* clocked thread: latency probes and the RX of core 0 */
     void  start(int iter);
+    /* RX core 1..rx_cores-1, until stop */
+    void  start_rx(uint8_t id);
     void  stop();
     bool  is_active();
     void set_ip(uint32_t client_ip,
@@ -350,16 +376,38 @@ public:
     CNatRxManager * get_nat_manager(){
         return ( &m_nat_check_manager );
     }
+    uint8_t get_rx_cores(){
+        return (m_rx_cores);
+    }
+    /* rx-check header seen by RX core id, handled there or passed to the owner */
+    void  handle_rx_check(uint8_t id,CRx_check_header * rxh);
+    /* handle the rx-check headers passed to RX core id */
+    void  run_rx_ring(uint8_t id);
+    /* CP side, the rx-check stats of all the RX cores */
+    RxCheckManager * get_rx_check_sum();
     CLatencyPktMode *c_l_pkt_mode;
 
 private:
+    /* RX cores that split the ports. The ICMP rx/tx sequence is shared with
+       the TX of core 0, so in ICMP mode core 0 reads all the ports and the
+       other cores only get their rx-check flows from the rings */
+    inline uint8_t rx_port_cores(){
+        return ( (CGlobalInfo::m_options.get_l_pkt_mode()==0) ? m_rx_active : 1 );
+    }
+
+    /* RX core of a flow, not the bits of the flow table bucket */
+    inline uint8_t flow_rx_core(uint64_t fid){
+        return ( (uint8_t)(((uint64_t)(uint32_t)(utl_rand_mix64(fid)>>32) * m_rx_active)>>32) );
+    }
+
     void  send_pkt_all_ports();
-    void  try_rx();
+    void  try_rx(CLatencyRxWorker * w);
     void  try_rx_queues();
     void  run_rx_queue_msgs(uint8_t thread_id,
                                              CNodeRing * r);
 	void  wait_for_rx_dump();
-    void  handle_rx_pkt(CLatencyManagerPerPort * lp,
+    void  handle_rx_pkt(CLatencyRxWorker * w,
+                        CLatencyManagerPerPort * lp,
                         rte_mbuf_t * m);
     /* messages handlers */
     void handle_latency_pkt_msg(uint8_t thread_id,
@@ -375,10 +423,11 @@ private:
      uint64_t                m_start_time; // calc tick betwen sending 
      uint32_t                m_port_mask;
      uint32_t                m_max_ports;
-     RxCheckManager 	     m_rx_check_manager;
+     uint8_t                 m_rx_cores;
+     uint8_t                 m_rx_active; /* RX cores that split the ports/flows now */
+     CLatencyRxWorker        m_rx[MAX_RX_CORES];
+     RxCheckManager          m_rx_check_sum;
      CNatRxManager           m_nat_check_manager;
-     CCpuUtlDp               m_cpu_dp_u;
-     CCpuUtlCp               m_cpu_cp_u;
      volatile bool           m_do_stop ODP_ALIGNED_CACHE ;
 };
 
@@ -31,7 +31,7 @@ limitations under the License.
 
 // An enum for all the option types
 enum { OPT_HELP, OPT_CFG, OPT_NODE_DUMP, OP_STATS,
-          OPT_FILE_OUT, OPT_UT, OPT_PCAP, OPT_IPV6, OPT_MAC_FILE};
+          OPT_FILE_OUT, OPT_UT, OPT_PCAP, OPT_IPV6, OPT_MAC_FILE, OPT_SCHED_TICK, OPT_SEED};
       
 
 /* these are the argument types:
@@ -52,6 +52,8 @@ static CSimpleOpt::SOption parser_options[] =
     { OPT_NODE_DUMP , "-v",         SO_REQ_SEP },
     { OPT_PCAP,       "--pcap",       SO_NONE   },
     { OPT_IPV6,       "--ipv6",       SO_NONE   },
+    { OPT_SCHED_TICK, "--sched-tick", SO_REQ_SEP},
+    { OPT_SEED,       "--seed",       SO_REQ_SEP},
 
     
     SO_END_OF_OPTIONS
@@ -75,6 +77,8 @@ static int usage(){
     printf("  Warning : This program can generate huge-files (TB ) watch out! try this only on local drive \n");
     printf(" \n");
     printf(" --pcap  export the file in pcap mode \n");
+    printf(" --sched-tick [usec]  schedule the nodes with a calendar queue of this tick instead of a heap \n");
+    printf(" --seed [n]  seed of all the random generators, the same seed gives the same output ( give it before --ut ) \n");
     printf(" Examples: ");
     printf("  1) preview show csv stats \n");
     printf("  #>bp_sim -f cfg.yaml -v 1 \n");
@@ -134,6 +138,12 @@ static int parse_options(int argc, char *argv[], CParserOption* po, bool & is_gt
             case OPT_PCAP:
                 po->preview.set_pcap_mode_enable(true);
                 break;
+            case OPT_SCHED_TICK:
+                po->m_sched_tick_usec = atoi(args.OptionArg());
+                break;
+            case OPT_SEED:
+                utl_rand_set_seed(strtoull(args.OptionArg(), NULL, 0));
+                break;
             default:
                 usage();
                 return -1;
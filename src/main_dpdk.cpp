@@ -72,6 +72,7 @@ limitations under the License.
 #define BP_MAX_PORTS (MAX_LATENCY_PORTS)
 #define BP_MAX_CORES 32
 #define BP_MAX_TX_QUEUE 16
+#define BP_MAX_RX_QUEUE 2   /* 0 - drop/default, 1 - latency */
 #define BP_MASTER_AND_LATENCY 2
 
 #define RTE_TEST_RX_DESC_DEFAULT 64
@@ -155,6 +156,15 @@ enum { OPT_HELP,
     OPT_PREFIX,
     OPT_MAC_SPLIT,
     OPT_ODP_GENERIC,
+    OPT_ODP_ZERO_COPY,
+    OPT_SCHED_TICK,
+    OPT_RX_CHECK_FLOWS,
+    OPT_STL_BURST,
+    OPT_STL_BURST_THR,
+    OPT_L4_CSUM,
+    OPT_STL_STATIC_MBUF,
+    OPT_SEED,
+    OPT_RX_CORES,
 
 };
 
@@ -215,6 +225,15 @@ static CSimpleOpt::SOption parser_options[] =
     { OPT_PREFIX, "--prefix", SO_REQ_SEP }, 
     { OPT_MAC_SPLIT, "--mac-spread", SO_REQ_SEP },
     { OPT_ODP_GENERIC ,             "--odp-generic",                SO_NONE  },
+    { OPT_ODP_ZERO_COPY ,           "--odp-zero-copy",              SO_NONE  },
+    { OPT_SCHED_TICK ,              "--sched-tick",                 SO_REQ_SEP },
+    { OPT_RX_CHECK_FLOWS,           "--rx-check-flows",             SO_REQ_SEP },
+    { OPT_STL_BURST,                "--stl-burst",                  SO_REQ_SEP },
+    { OPT_STL_BURST_THR,            "--stl-burst-thr",              SO_REQ_SEP },
+    { OPT_L4_CSUM,                  "--l4-csum",                    SO_NONE   },
+    { OPT_STL_STATIC_MBUF,          "--stl-static-mbuf",            SO_NONE   },
+    { OPT_SEED,                     "--seed",                       SO_REQ_SEP },
+    { OPT_RX_CORES,                 "--rx-cores",                   SO_REQ_SEP },
     
     SO_END_OF_OPTIONS
 };
@@ -299,6 +318,9 @@ static int usage(){
 	printf("                              this feature consume another thread  \n");
     printf("  \n");
     printf(" --hops [hops]              :  If rx check is enabled, the hop number can be assigned. The default number of hops is 1\n");
+    printf(" --rx-check-flows [flows]   :  size of the rx check flow table, the default is %d flows \n",RX_CHECK_MAX_FLOWS_DEF);
+    printf(" --rx-cores [n]             :  split the latency/rx-check RX between n cores ( ports and rx-check flows ), default 1, max %d \n",MAX_RX_CORES);
+    printf("                              with ICMP latency packets the ports stay on the latency core \n");
     printf(" --iom  [mode]              :  io mode for interactive mode [0- silent, 1- normal , 2- short]   \n");
     printf("                              this feature consume another thread  \n");
     printf("  \n");
@@ -307,6 +329,14 @@ static int usage(){
     printf(" --prefix                   : for multi trex, each instance should have a different name \n");
     printf(" --mac-spread               : Spread the destination mac-order by this factor. e.g 2 will generate the traffic to 2 devices DEST-MAC ,DEST-MAC+1  \n");
     printf("                             maximum is up to 128 devices   \n");
+    printf(" --odp-zero-copy            : back the mbuf packet pools with odp packet pools and transmit without copy \n");
+    printf(" --sched-tick [usec]        : schedule the DP nodes with a calendar queue of this tick instead of a heap, e.g. 1 \n");
+    printf(" --stl-burst [pkts]         : stateless continuous streams faster than --stl-burst-thr send this number of packets per event, default 1 \n");
+    printf(" --stl-burst-thr [usec]     : packet gap below which a stream is sent in bursts, default 10 \n");
+    printf(" --l4-csum                  : keep the TCP checksum valid when the flow tuple is replaced \n");
+    printf(" --stl-static-mbuf          : stateless streams without VM keep a pre-built packet that is never freed, no mbuf refcnt per packet \n");
+    printf("                             the ODP pktio still sends a copy of it \n");
+    printf(" --seed [n]                 : seed of the random generators ( VM random vars, random client/server pools ), the same seed repeats the run \n");
     
     
     printf("\n simulation mode : \n");
@@ -552,6 +582,46 @@ static int parse_options(int argc, char *argv[], CParserOption* po, bool first_t
                 printf("set odp generic");
                 po->preview.setODPGeneric(true);
                 break;
+            case OPT_ODP_ZERO_COPY :
+                po->preview.setODPZeroCopy(true);
+                break;
+            case OPT_SCHED_TICK :
+                sscanf(args.OptionArg(),"%d", &tmp_data);
+                po->m_sched_tick_usec = (uint32_t)tmp_data;
+                break;
+            case OPT_RX_CHECK_FLOWS :
+                sscanf(args.OptionArg(),"%d", &tmp_data);
+                po->m_rx_check_flows = (uint32_t)tmp_data;
+                break;
+            case OPT_STL_BURST :
+                sscanf(args.OptionArg(),"%d", &tmp_data);
+                if ( (tmp_data < 1) || (tmp_data > STL_MAX_BURST) ) {
+                    printf(" --stl-burst should be between 1 and %d \n",STL_MAX_BURST);
+                    return -1;
+                }
+                po->m_stl_burst = (uint16_t)tmp_data;
+                break;
+            case OPT_STL_BURST_THR :
+                sscanf(args.OptionArg(),"%d", &tmp_data);
+                po->m_stl_burst_thr_usec = (uint16_t)tmp_data;
+                break;
+            case OPT_L4_CSUM :
+                po->preview.setL4Checksum(true);
+                break;
+            case OPT_STL_STATIC_MBUF :
+                po->preview.setStlStaticMbuf(true);
+                break;
+            case OPT_SEED :
+                utl_rand_set_seed(strtoull(args.OptionArg(), NULL, 0));
+                break;
+            case OPT_RX_CORES :
+                sscanf(args.OptionArg(),"%d", &tmp_data);
+                if ( (tmp_data < 1) || (tmp_data > MAX_RX_CORES) ) {
+                    printf(" --rx-cores should be between 1 and %d \n",MAX_RX_CORES);
+                    return -1;
+                }
+                po->m_rx_cores = (uint8_t)tmp_data;
+                break;
 		
 
             default:
@@ -593,6 +663,17 @@ static int parse_options(int argc, char *argv[], CParserOption* po, bool first_t
         return -1;
     }
 
+    if ( po->m_rx_cores > 1 ) {
+        if ( po->is_latency_disabled() ) {
+            po->m_rx_cores = 1;
+        }
+        /* the NAT messages to each DP core have one producer */
+        if ( po->preview.get_learn_mode_enable() ) {
+            printf(" WARNING --rx-cores is not supported with --learn, using one RX core \n");
+            po->m_rx_cores = 1;
+        }
+    }
+
     if ( node_dump ){
         po->preview.setVMode(a);
     }
@@ -784,6 +865,18 @@ public:
     CPhyEthIF (){
         m_port_id=0;
         m_rx_queue=0;
+        m_pkt_io=ODP_PKTIO_INVALID;
+        m_rx_queues_num=0;
+        m_tx_queues_num=0;
+        m_rx_drop_cos=ODP_COS_INVALID;
+        m_rx_drop_queue=ODP_QUEUE_INVALID;
+        m_rx_latency_cos=ODP_COS_INVALID;
+        m_rx_latency_queue=ODP_QUEUE_INVALID;
+        m_rx_stats_cos=ODP_COS_INVALID;
+        m_rx_stats_queue=ODP_QUEUE_INVALID;
+        m_rx_drop_default=false;
+        m_rx_cls_drop_pkt=0;
+        m_rx_stats_drop_pkt=0;
     }
     bool Create(uint8_t portid){
         m_port_id      = portid;
@@ -794,12 +887,16 @@ public:
     }
     void Delete();
 
-//    void set_rx_queue(uint8_t rx_queue){
-//        m_rx_queue=rx_queue;
-//    }
+    void set_rx_queue(uint8_t rx_queue){
+        m_rx_queue=rx_queue;
+    }
     
     odp_pktio_t create_pktio(odp_pool_t pool);
 
+    void rx_queue_setup(uint16_t nb_rx_queue);
+
+    void tx_queue_setup(uint16_t nb_tx_queue);
+
     void configure(void);
 
     void macaddr_get(odph_ethaddr_t *mac_addr);
@@ -817,9 +914,11 @@ public:
 //                        unsigned int socket_id,
 //                        const struct rte_eth_txconf *tx_conf);
 
-//    void configure_rx_drop_queue();
+    void configure_rx_drop_queue();
+
+    void configure_rx_duplicate_rules();
 
- //   void configure_rx_duplicate_rules();
+    void configure_rx_stats_queue();
 
     void start();
 
@@ -878,7 +977,8 @@ public:
 
 public:
 
-    inline uint16_t  tx_burst(struct rte_mbuf **tx_pkts, 
+    inline uint16_t  tx_burst(uint16_t queue_id,
+                              struct rte_mbuf **tx_pkts, 
                               uint16_t nb_pkts);
 
     inline uint16_t  rx_burst(uint16_t queue_id,
@@ -890,6 +990,22 @@ public:
     uint8_t                  get_rte_port_id(void){
                     return ( m_port_id );
     }
+private:
+    uint16_t  rx_burst_classified(struct rte_mbuf **rx_pkts, 
+                                  uint16_t nb_pkts);
+
+    uint16_t  rx_default_pkts(odp_packet_t * odp_pkts,
+                              int cnt,
+                              struct rte_mbuf **rx_pkts);
+
+    uint16_t  rx_burst_stats(struct rte_mbuf **rx_pkts, 
+                             uint16_t nb_pkts);
+
+    bool add_rx_pmr(odp_pmr_term_t term,
+                    const void * val,
+                    const void * mask,
+                    uint32_t val_sz,
+                    uint32_t offset);
 private:
     uint8_t                  m_port_id;
     uint8_t                  m_rx_queue;
@@ -908,6 +1024,23 @@ private:
     float                    m_last_rx_pps;
 public:
     odp_pktio_t              m_pkt_io;
+    /* rx queue id -> odp pktin queue, each queue is read by one thread only */
+    odp_pktin_queue_t        m_rx_queues[BP_MAX_RX_QUEUE];
+    uint16_t                 m_rx_queues_num;
+    /* tx queue id -> odp pktout queue, each id is used by one thread only */
+    odp_pktout_queue_t       m_tx_queues[BP_MAX_TX_QUEUE+1];
+    uint16_t                 m_tx_queues_num; /* real odp queues, could be less than the ids */
+
+    /* odp classification, replaces the hardware drop queue and latency filters */
+    odp_cos_t                m_rx_drop_cos;      /* pktio default CoS, bulk traffic */
+    odp_queue_t              m_rx_drop_queue;    /* queue of m_rx_drop_cos, software check only */
+    odp_cos_t                m_rx_latency_cos;   /* latency/rx-check/nat packets */
+    odp_queue_t              m_rx_latency_queue; /* queue of m_rx_latency_cos, rx queue id 1 */
+    odp_cos_t                m_rx_stats_cos;     /* stateless pktio default CoS, rx_stats packets */
+    odp_queue_t              m_rx_stats_queue;   /* queue of m_rx_stats_cos, rx queue id 1 */
+    bool                     m_rx_drop_default;  /* the default CoS drops, it has no queue */
+    uint64_t                 m_rx_cls_drop_pkt;
+    uint64_t                 m_rx_stats_drop_pkt; /* the ring to the DP core was full */
 };
 
 
@@ -967,33 +1100,154 @@ rx-queue 1 - Latency measurement packets will go here
 
 */
 
-//void CPhyEthIF::configure_rx_duplicate_rules(){
-//
-//    if ( get_is_rx_filter_enable() ){
-//
-//        if ( get_ex_drv()->is_hardware_filter_is_supported()==false ){
-//            printf(" ERROR this feature is not supported with current hardware \n");
-//            exit(1);
-//        }
-//        get_ex_drv()->configure_rx_filter_rules(this);
-//    }
-//}
-//
+bool CPhyEthIF::add_rx_pmr(odp_pmr_term_t term,
+                           const void * val,
+                           const void * mask,
+                           uint32_t val_sz,
+                           uint32_t offset){
+    odp_pmr_match_t match;
 
-//void CPhyEthIF::configure_rx_drop_queue(){
-//
-//    if ( get_vm_one_queue_enable() ) {
-//        return;
-//    }
-//    if ( CGlobalInfo::m_options.is_latency_disabled()==false ) {
-//        if ( (!get_ex_drv()->is_hardware_support_drop_queue())  ) {
-//            printf(" ERROR latency feature is not supported with current hardware  \n");
-//            exit(1);
-//        }
-//    }
-//    get_ex_drv()->configure_drop_queue(this);
-//}
-//
+    if ( (odp_pmr_terms_cap() & (1ULL << term))==0 ) {
+        return (false);
+    }
+    match.term   = term;
+    match.val    = val;
+    match.mask   = mask;
+    match.val_sz = val_sz;
+    match.offset = offset;
+    odp_pmr_t pmr = odp_pmr_create(&match);
+    if ( pmr == ODP_PMR_INVAL ) {
+        return (false);
+    }
+    if ( odp_pktio_pmr_cos(pmr, m_pkt_io, m_rx_latency_cos) != 0 ) {
+        odp_pmr_destroy(pmr);
+        return (false);
+    }
+    return (true);
+}
+
+/* latency packets (protocol of CLatencyPktMode) and packets with the
+ * rx-check/nat IPv4 option go to rx queue 1 */
+void CPhyEthIF::configure_rx_duplicate_rules(){
+    char name[ODP_QUEUE_NAME_LEN];
+    odp_queue_param_t qparam;
+    odp_cls_cos_param_t cparam;
+
+    if ( get_vm_one_queue_enable() ) {
+        return;
+    }
+
+    snprintf(name, sizeof(name), "rx-latency-%d", m_port_id);
+    odp_queue_param_init(&qparam);
+    qparam.type = ODP_QUEUE_TYPE_PLAIN;
+    m_rx_latency_queue = odp_queue_create(name, &qparam);
+    if ( m_rx_latency_queue == ODP_QUEUE_INVALID ) {
+        rte_exit(EXIT_FAILURE, "odp_queue_create: port=%u\n", m_port_id);
+    }
+
+    odp_cls_cos_param_init(&cparam);
+    cparam.queue       = m_rx_latency_queue;
+    cparam.pool        = get_odp_packet_pool(CGlobalInfo::m_socket.port_to_socket((port_id_t)m_port_id));
+    cparam.drop_policy = ODP_COS_DROP_NEVER;
+    m_rx_latency_cos = odp_cls_cos_create(name, &cparam);
+    if ( m_rx_latency_cos == ODP_COS_INVALID ) {
+        rte_exit(EXIT_FAILURE, "odp_cls_cos_create: port=%u\n", m_port_id);
+    }
+
+    /* same selection as CLatencyManager::Create */
+    static const uint8_t mask8 = 0xff;
+    static const uint8_t proto_sctp = 0x84;
+    static const uint8_t proto_icmp = 0x01;
+    const uint8_t * proto = (CGlobalInfo::m_options.get_l_pkt_mode()==0) ? &proto_sctp : &proto_icmp;
+    if ( !add_rx_pmr(ODP_PMR_IPPROTO, proto, &mask8, 1, 0) ) {
+        rte_exit(EXIT_FAILURE, " ERROR can't classify latency packets on port %u \n", m_port_id);
+    }
+
+    bool sw_check = false;
+    if ( get_is_rx_check_mode() || CGlobalInfo::is_learn_mode() ) {
+        /* first IPv4 option, just after a 20 bytes IPv4 header */
+        static const uint8_t opt_rx_check = RX_CHECK_V4_OPT_TYPE;
+        static const uint8_t opt_nat      = CNatOption::noIPV4_OPTION;
+        uint32_t offset = 14 + 20;
+        if ( CGlobalInfo::m_options.preview.get_vlan_mode_enable() ) {
+            offset += 4;
+        }
+        if ( CGlobalInfo::m_options.preview.get_ipv6_mode_enable() ||
+             !add_rx_pmr(ODP_PMR_CUSTOM_FRAME, &opt_rx_check, &mask8, 1, offset) ||
+             !add_rx_pmr(ODP_PMR_CUSTOM_FRAME, &opt_nat, &mask8, 1, offset) ) {
+            printf(" WARNING port %d can't classify rx-check/nat packets, checking all packets in software \n",
+                   m_port_id);
+            sw_check = true;
+        }
+    }
+    m_rx_drop_default = !sw_check;
+}
+
+/* the default CoS gets all the packets not matched by configure_rx_duplicate_rules(),
+ * which must run first. When the rules cover everything the latency thread wants
+ * the CoS has no queue and the classifier drops the bulk traffic. Only the
+ * software check queues it, rx_burst_classified() hands it to the check */
+void CPhyEthIF::configure_rx_drop_queue(){
+    char name[ODP_COS_NAME_LEN];
+    odp_queue_param_t qparam;
+    odp_cls_cos_param_t cparam;
+
+    if ( get_vm_one_queue_enable() ) {
+        return;
+    }
+
+    snprintf(name, sizeof(name), "rx-drop-%d", m_port_id);
+    odp_cls_cos_param_init(&cparam);
+    cparam.pool        = get_odp_packet_pool(CGlobalInfo::m_socket.port_to_socket((port_id_t)m_port_id));
+    if ( m_rx_drop_default ) {
+        cparam.queue       = ODP_QUEUE_INVALID;
+        cparam.drop_policy = ODP_COS_DROP_POOL;
+    }else{
+        odp_queue_param_init(&qparam);
+        qparam.type = ODP_QUEUE_TYPE_PLAIN;
+        m_rx_drop_queue = odp_queue_create(name, &qparam);
+        if ( m_rx_drop_queue == ODP_QUEUE_INVALID ) {
+            rte_exit(EXIT_FAILURE, "odp_queue_create: port=%u\n", m_port_id);
+        }
+        cparam.queue       = m_rx_drop_queue;
+        cparam.drop_policy = ODP_COS_DROP_NEVER;
+    }
+    m_rx_drop_cos = odp_cls_cos_create(name, &cparam);
+    if ( (m_rx_drop_cos == ODP_COS_INVALID) ||
+         (odp_pktio_default_cos_set(m_pkt_io, m_rx_drop_cos) != 0) ) {
+        rte_exit(EXIT_FAILURE, "odp drop CoS: port=%u\n", m_port_id);
+    }
+}
+
+/* stateless has no latency, the default CoS gets all the packets and the
+ * stateless RX thread reads them with rx_burst_stats() */
+void CPhyEthIF::configure_rx_stats_queue(){
+    char name[ODP_COS_NAME_LEN];
+    odp_queue_param_t qparam;
+    odp_cls_cos_param_t cparam;
+
+    if ( get_vm_one_queue_enable() ) {
+        return;
+    }
+
+    snprintf(name, sizeof(name), "rx-stats-%d", m_port_id);
+    odp_queue_param_init(&qparam);
+    qparam.type = ODP_QUEUE_TYPE_PLAIN;
+    m_rx_stats_queue = odp_queue_create(name, &qparam);
+    if ( m_rx_stats_queue == ODP_QUEUE_INVALID ) {
+        rte_exit(EXIT_FAILURE, "odp_queue_create: port=%u\n", m_port_id);
+    }
+
+    odp_cls_cos_param_init(&cparam);
+    cparam.queue       = m_rx_stats_queue;
+    cparam.pool        = get_odp_packet_pool(CGlobalInfo::m_socket.port_to_socket((port_id_t)m_port_id));
+    cparam.drop_policy = ODP_COS_DROP_NEVER;
+    m_rx_stats_cos = odp_cls_cos_create(name, &cparam);
+    if ( (m_rx_stats_cos == ODP_COS_INVALID) ||
+         (odp_pktio_default_cos_set(m_pkt_io, m_rx_stats_cos) != 0) ) {
+        rte_exit(EXIT_FAILURE, "odp rx_stats CoS: port=%u\n", m_port_id);
+    }
+}
 
 //void CPhyEthIF::rx_queue_setup(uint16_t rx_queue_id,
 //                               uint16_t nb_rx_desc, 
@@ -1232,6 +1486,10 @@ void CPhyEthIF::dump_stats(FILE *fd){
     fprintf(fd,"------------\n");
     m_stats.DumpAll(fd);
     //m_stats.Dump(fd);
+    fprintf(fd," rx classifier drop : %llu \n",(unsigned long long)m_rx_cls_drop_pkt);
+    if ( m_rx_stats_queue != ODP_QUEUE_INVALID ) {
+        fprintf(fd," rx_stats ring drop : %llu \n",(unsigned long long)m_rx_stats_drop_pkt);
+    }
     printf (" Tx : %.1fMb/sec  \n",m_last_tx_rate);
     //printf (" Rx : %.1fMb/sec  \n",m_last_rx_rate);
 }
@@ -1241,23 +1499,127 @@ void CPhyEthIF::stats_clear(){
     m_stats.Clear();
 }
 
-inline uint16_t  CPhyEthIF::tx_burst(rte_mbuf **tx_pkts, 
+/* same contract as rte_eth_tx_burst, sent mbufs are consumed and the rest are left to the caller */
+inline uint16_t  CPhyEthIF::tx_burst(uint16_t queue_id,
+                                     rte_mbuf **tx_pkts, 
                                      uint16_t nb_pkts){
     int cnt=0;
     odp_packet_t odp_pkts[nb_pkts];
-    cnt = mbuf_to_odp_packet_tbl(tx_pkts, odp_pkts, nb_pkts); 
-    assert (cnt==nb_pkts);
-    uint16_t ret = odp_pktio_send(m_pkt_io, odp_pkts, nb_pkts); 
-    return (ret);
+    uint8_t      zc[nb_pkts];
+    cnt = mbuf_to_odp_packet_tbl(tx_pkts, odp_pkts, zc, nb_pkts); 
+    int ret = odp_pktio_send_queue(m_tx_queues[queue_id], odp_pkts, cnt); 
+    if ( odp_unlikely(ret < 0) ) {
+        ret = 0;
+    }
+    mbuf_odp_tx_done_tbl(tx_pkts, odp_pkts, zc, (uint16_t)ret, (uint16_t)cnt);
+    return ((uint16_t)ret);
 }
 
 
+/* as rte_eth_rx_burst, the mbufs are views of the received odp packets (no copy) */
 inline uint16_t  CPhyEthIF::rx_burst(uint16_t queue_id,
                                 struct rte_mbuf **rx_pkts, 
                                 uint16_t nb_pkts){
-//   return (rte_eth_rx_burst(m_port_id, queue_id,
-//                                     rx_pkts, nb_pkts));
-    return 0;
+    if ( (queue_id == 1) && (m_rx_latency_queue != ODP_QUEUE_INVALID) ) {
+        return (rx_burst_classified(rx_pkts, nb_pkts));
+    }
+    if ( (queue_id == 1) && (m_rx_stats_queue != ODP_QUEUE_INVALID) ) {
+        return (rx_burst_stats(rx_pkts, nb_pkts));
+    }
+    odp_packet_t odp_pkts[nb_pkts];
+    int cnt = odp_pktio_recv_queue(m_rx_queues[queue_id], odp_pkts, nb_pkts);
+    if ( odp_unlikely(cnt <= 0) ) {
+        return (0);
+    }
+    return (odp_packet_to_mbuf_tbl(odp_pkts, rx_pkts, (uint16_t)cnt, m_port_id));
+}
+
+/* packets of the default CoS, or that the classifier did not take. They are
+ * dropped in one call unless they must be checked in software
+ */
+uint16_t  CPhyEthIF::rx_default_pkts(odp_packet_t * odp_pkts,
+                                     int cnt,
+                                     struct rte_mbuf **rx_pkts){
+    if ( odp_likely(m_rx_drop_default) ) {
+        odp_packet_free_multi(odp_pkts, cnt);
+        m_rx_cls_drop_pkt += cnt;
+        return (0);
+    }
+    return (odp_packet_to_mbuf_tbl(odp_pkts, rx_pkts, (uint16_t)cnt, m_port_id));
+}
+
+/* the latency queue. Polling the pktin queue runs the classifier: matching
+ * packets are moved to m_rx_latency_queue, the rest is dropped by the default
+ * CoS. In software check mode it goes to m_rx_drop_queue instead and is
+ * drained here so it does not hold the packet pool
+ */
+uint16_t  CPhyEthIF::rx_burst_classified(struct rte_mbuf **rx_pkts, 
+                                         uint16_t nb_pkts){
+    odp_packet_t odp_pkts[nb_pkts];
+    odp_event_t  ev[nb_pkts];
+    uint16_t     res=0;
+    int          cnt;
+    int          i;
+
+    cnt = odp_pktio_recv_queue(m_rx_queues[0], odp_pkts, nb_pkts);
+    if ( cnt > 0 ) {
+        res = rx_default_pkts(odp_pkts, cnt, rx_pkts);
+    }
+
+    if ( m_rx_drop_queue != ODP_QUEUE_INVALID ) {
+        int j=0;
+        while ( res < nb_pkts ) {
+            cnt = odp_queue_deq_multi(m_rx_drop_queue, ev, nb_pkts - res);
+            if ( cnt <= 0 ) {
+                break;
+            }
+            for (i=0; i<cnt; i++) {
+                odp_pkts[i] = odp_packet_from_event(ev[i]);
+            }
+            res += rx_default_pkts(odp_pkts, cnt, &rx_pkts[res]);
+            /* bounded, the latency queue is next */
+            if ( ++j > 16 ) {
+                break;
+            }
+        }
+    }
+
+    if ( res < nb_pkts ) {
+        cnt = odp_queue_deq_multi(m_rx_latency_queue, ev, nb_pkts - res);
+        if ( cnt > 0 ) {
+            for (i=0; i<cnt; i++) {
+                odp_pkts[i] = odp_packet_from_event(ev[i]);
+            }
+            res += odp_packet_to_mbuf_tbl(odp_pkts, &rx_pkts[res], (uint16_t)cnt, m_port_id);
+        }
+    }
+    return (res);
+}
+
+/* stateless, the packets the classifier did not take and the rx_stats queue */
+uint16_t  CPhyEthIF::rx_burst_stats(struct rte_mbuf **rx_pkts, 
+                                    uint16_t nb_pkts){
+    odp_packet_t odp_pkts[nb_pkts];
+    odp_event_t  ev[nb_pkts];
+    uint16_t     res=0;
+    int          cnt;
+    int          i;
+
+    cnt = odp_pktio_recv_queue(m_rx_queues[0], odp_pkts, nb_pkts);
+    if ( cnt > 0 ) {
+        res = odp_packet_to_mbuf_tbl(odp_pkts, rx_pkts, (uint16_t)cnt, m_port_id);
+    }
+
+    if ( res < nb_pkts ) {
+        cnt = odp_queue_deq_multi(m_rx_stats_queue, ev, nb_pkts - res);
+        if ( cnt > 0 ) {
+            for (i=0; i<cnt; i++) {
+                odp_pkts[i] = odp_packet_from_event(ev[i]);
+            }
+            res += odp_packet_to_mbuf_tbl(odp_pkts, &rx_pkts[res], (uint16_t)cnt, m_port_id);
+        }
+    }
+    return (res);
 }
 
 
@@ -1358,9 +1720,58 @@ protected:
 
 } ODP_ALIGNED_CACHE; ;
 
+/* signatures of the rx_stats packets of one DP core, from the stateless RX
+   thread. allocated as a CGenNode, see CGenNodeNatInfo */
+struct CGenNodeRxStatsPktInfo : public CGenNodeMsgBase  {
+    enum {
+        MAX_SIGS = 5
+    };
+
+    uint8_t       m_cnt;
+    uint16_t      m_pad;
+    uint32_t      m_no_sig; /* packets without a signature */
+    hr_time_t     m_time;   /* hr tick of the RX, the signatures are of one rx burst */
+    struct {
+        TrexStreamRxSig m_sig;
+        uint32_t        m_len;
+    } __attribute__((packed)) m_data[MAX_SIGS];
+
+public:
+    bool is_full(){
+        return (m_cnt==MAX_SIGS?true:false);
+    }
+};
+
+static_assert(sizeof(CGenNodeRxStatsPktInfo) <= sizeof(CGenNode), "sizeof(CGenNodeRxStatsPktInfo) > sizeof(CGenNode)" );
+
 class CCoreEthIFStateless : public CCoreEthIF {
 public:
+    CCoreEthIFStateless(){
+        m_rx_stats = NULL;
+    }
+
     virtual int send_node(CGenNode * node);
+
+    /* after Create(), the counters of the packets the core sends */
+    void create_rx_stats();
+
+    virtual int flush_tx_queue(void);
+
+    const TrexStreamsRxStats * get_stream_rx_stats() const {
+        return (m_rx_stats);
+    }
+
+    /* the stateless RX thread is the only producer */
+    CNodeRing * get_rx_stats_ring(){
+        return (&m_rx_stats_ring);
+    }
+
+private:
+    void handle_rx_stats_ring();
+
+private:
+    TrexStreamsRxStats * m_rx_stats;
+    CNodeRing            m_rx_stats_ring; /* CGenNodeRxStatsPktInfo of the RX thread */
 };
 
 bool CCoreEthIF::Create(uint8_t             core_id,
@@ -1383,36 +1794,36 @@ bool CCoreEthIF::Create(uint8_t             core_id,
 }
 
 void CCoreEthIF::flush_rx_queue(void){
-//    pkt_dir_t   dir ;
-//    bool is_latency=get_is_latency_thread_enable();
-//    for (dir=CLIENT_SIDE; dir<CS_NUM; dir++) {
-//        CCorePerPort * lp_port=&m_ports[dir];
-//        CPhyEthIF * lp=lp_port->m_port;
-//
-//        rte_mbuf_t * rx_pkts[32];
-//        int j=0;
-
-//        while (true) {
-//            j++;
-//            uint16_t cnt =lp->rx_burst(0,rx_pkts,32);
-//            if ( cnt ) {
-//                int i;
-//                for (i=0; i<(int)cnt;i++) {
-//                    rte_mbuf_t * m=rx_pkts[i];
-//                    if ( is_latency ){
-//                        if (!process_rx_pkt(dir,m)){
-//                            rte_pktmbuf_free(m);
-//                        }
-//                    }else{
-//                        rte_pktmbuf_free(m);
-//                    }
-//                }
-//            }
-//            if ((cnt<5) || j>10 ) {
-//                break;
-//            }
-//        }
-//    }
+    pkt_dir_t   dir ;
+    bool is_latency=get_is_latency_thread_enable();
+    for (dir=CLIENT_SIDE; dir<CS_NUM; dir++) {
+        CCorePerPort * lp_port=&m_ports[dir];
+        CPhyEthIF * lp=lp_port->m_port;
+
+        rte_mbuf_t * rx_pkts[32];
+        int j=0;
+
+        while (true) {
+            j++;
+            uint16_t cnt =lp->rx_burst(0,rx_pkts,32);
+            if ( cnt ) {
+                int i;
+                for (i=0; i<(int)cnt;i++) {
+                    rte_mbuf_t * m=rx_pkts[i];
+                    if ( is_latency ){
+                        if (!process_rx_pkt(dir,m)){
+                            rte_pktmbuf_free(m);
+                        }
+                    }else{
+                        rte_pktmbuf_free(m);
+                    }
+                }
+            }
+            if ((cnt<5) || j>10 ) {
+                break;
+            }
+        }
+    }
 }
 
 int CCoreEthIF::flush_tx_queue(void){
@@ -1490,7 +1901,7 @@ int CCoreEthIF::send_burst(CCorePerPort * lp_port,
                            uint16_t len,
                            CVirtualIFPerSideStats  * lp_stats){
 
-    uint16_t ret = lp_port->m_port->tx_burst(lp_port->m_table,len);
+    uint16_t ret = lp_port->m_port->tx_burst(lp_port->m_tx_queue_id,lp_port->m_table,len);
     #ifdef DELAY_IF_NEEDED
     while ( odp_unlikely( ret<len ) ){
         dry_run();
@@ -1498,7 +1909,8 @@ int CCoreEthIF::send_burst(CCorePerPort * lp_port,
         //rte_pause();
         //rte_pause();
         lp_stats->m_tx_queue_full += 1;
-        uint16_t ret1=lp_port->m_port->tx_burst(&lp_port->m_table[ret],
+        uint16_t ret1=lp_port->m_port->tx_burst(lp_port->m_tx_queue_id,
+                                                &lp_port->m_table[ret],
                                                 len-ret);
         ret+=ret1;
     }
@@ -1507,16 +1919,11 @@ int CCoreEthIF::send_burst(CCorePerPort * lp_port,
     /* CPU has burst of packets , more that TX can send need to drop them !!*/
     if ( odp_unlikely(ret < len) ) {
         lp_stats->m_tx_drop += (len-ret);
-        /*
-         * FIXME
-         * if ret<len, we should free the pkt_buffer by ourself. 
-         * rte_pktmbuf_free only free the mbuf
-         */
-    }
-    uint16_t i;
-    for (i=0; i<len;i++) {
-        rte_mbuf_t * m=lp_port->m_table[i];
-        rte_pktmbuf_free(m);
+        uint16_t i;
+        for (i=ret; i<len;i++) {
+            rte_mbuf_t * m=lp_port->m_table[i];
+            rte_pktmbuf_free(m);
+        }
     }
 
     return (0);
@@ -1590,8 +1997,10 @@ int CCoreEthIFStateless::send_node(CGenNode * no){
     CCorePerPort *  lp_port=&m_ports[dir];
     CVirtualIFPerSideStats  * lp_stats = &m_stats[dir];
     if (m) {
-        /* cache case */
-        rte_pktmbuf_refcnt_update(m,1);
+        /* cache case, a static mbuf is never freed by the tx path */
+        if ( odp_likely( !rte_pktmbuf_is_static(m) ) ) {
+            rte_pktmbuf_refcnt_update(m,1);
+        }
     }else{
         m=node_sl->alloc_node_with_vm();
         assert(m);
@@ -1603,6 +2012,188 @@ int CCoreEthIFStateless::send_node(CGenNode * no){
 
 
 
+void CCoreEthIFStateless::create_rx_stats(){
+    void *p;
+    if ( posix_memalign(&p, 64, sizeof(TrexStreamsRxStats)) != 0 ) {
+        assert(0);
+    }
+    m_rx_stats = (TrexStreamsRxStats *)p;
+    m_rx_stats->create();
+
+    char name[100];
+    sprintf(name,"rx_stats_%d",m_core_id);
+    m_rx_stats_ring.Create(std::string(name),1024,0);
+}
+
+int CCoreEthIFStateless::flush_tx_queue(void){
+    CCoreEthIF::flush_tx_queue();
+    if ( m_rx_stats ) {
+        handle_rx_stats_ring();
+    }
+    return (0);
+}
+
+/* the signatures the RX thread found in the packets of this core */
+void CCoreEthIFStateless::handle_rx_stats_ring(){
+    CGenNode * nodes[MSG_DEQUEUE_BURST];
+    uint32_t cnt;
+    while ( (cnt = m_rx_stats_ring.DequeueBurst(nodes, MSG_DEQUEUE_BURST)) > 0 ) {
+        uint32_t i;
+        for (i=0; i<cnt; i++) {
+            CGenNodeRxStatsPktInfo * msg=(CGenNodeRxStatsPktInfo *)nodes[i];
+            assert(msg->m_msg_type==CGenNodeMsgBase::RX_STATS_PKT);
+            int j;
+            for (j=0; j<msg->m_cnt; j++) {
+                m_rx_stats->handle_sig(&msg->m_data[j].m_sig, msg->m_data[j].m_len, msg->m_time);
+            }
+            m_rx_stats->add_no_sig(msg->m_no_sig);
+            CGlobalInfo::free_node(nodes[i]);
+        }
+    }
+}
+
+
+/* the stateless RX thread. it is the only reader of the rx queue of the
+   ports and sends the signature of each rx_stats packet to the DP core that
+   sent it, by the TX core of the signature. the DP cores own the counters */
+class CRxStatsStateless {
+public:
+    void Create(CPhyEthIF * ports,
+                uint8_t max_ports,
+                CCoreEthIFStateless * cores,
+                uint8_t max_cores);
+
+    void start();
+
+    void stop(){
+        m_do_stop=true;
+    }
+
+private:
+    void handle_pkt(rte_mbuf_t * m, hr_time_t now);
+    CGenNodeRxStatsPktInfo * get_msg(uint8_t core, hr_time_t now);
+    void send_msg(uint8_t core);
+    void flush_msgs();
+
+private:
+    CPhyEthIF *              m_ports;
+    uint8_t                  m_max_ports;
+    uint8_t                  m_port_id;   /* the port of the rx burst */
+    CCoreEthIFStateless *    m_cores;     /* DP core i is m_cores[i+1] */
+    uint8_t                  m_max_cores;
+    volatile bool            m_do_stop;
+    CGenNodeRxStatsPktInfo * m_msg[TrexStreamsRxStats::MAX_TX_CORES]; /* being filled, per DP core */
+};
+
+void CRxStatsStateless::Create(CPhyEthIF * ports,
+                               uint8_t max_ports,
+                               CCoreEthIFStateless * cores,
+                               uint8_t max_cores){
+    assert(max_cores <= TrexStreamsRxStats::MAX_TX_CORES);
+    m_ports     = ports;
+    m_max_ports = max_ports;
+    m_port_id   = 0;
+    m_cores     = cores;
+    m_max_cores = max_cores;
+    m_do_stop   = false;
+    int i;
+    for (i=0; i<TrexStreamsRxStats::MAX_TX_CORES; i++) {
+        m_msg[i]=0;
+    }
+}
+
+void CRxStatsStateless::start(){
+    rte_mbuf_t * rx_pkts[32];
+
+    while ( !m_do_stop ) {
+        for (m_port_id=0; m_port_id<m_max_ports; m_port_id++) {
+            uint16_t cnt = m_ports[m_port_id].rx_burst(1, rx_pkts, 32);
+            if ( cnt == 0 ) {
+                continue;
+            }
+            hr_time_t now = os_get_hr_tick_64();
+            int i;
+            for (i=0; i<(int)cnt; i++) {
+                handle_pkt(rx_pkts[i], now);
+                rte_pktmbuf_free(rx_pkts[i]);
+            }
+            flush_msgs();
+        }
+    }
+}
+
+void CRxStatsStateless::handle_pkt(rte_mbuf_t * m, hr_time_t now){
+    uint8_t * p   = rte_pktmbuf_mtod(m, uint8_t*);
+    uint32_t  len = rte_pktmbuf_data_len(m);
+    uint16_t  sig_off;
+    uint16_t  csum_off;
+    const TrexStreamRxSig * sig = NULL;
+    uint8_t   core = 0;
+
+    if ( odp_likely(TrexStreamRxSig::get_offset(p, len, sig_off, csum_off)) &&
+         (p[sig_off] == TrexStreamRxSig::MAGIC) ) {
+        sig  = (const TrexStreamRxSig *)(p + sig_off);
+        core = sig->m_flags & TrexStreamRxSig::CORE_MASK;
+    }
+    if ( odp_unlikely( (sig == NULL) || (core >= m_max_cores) ) ) {
+        /* counted by a DP core of the port */
+        sig  = NULL;
+        core = (m_port_id >> 1) % m_max_cores;
+    }
+
+    CGenNodeRxStatsPktInfo * msg = get_msg(core, now);
+    if ( odp_unlikely(msg == NULL) ) {
+        m_ports[m_port_id].m_rx_stats_drop_pkt++;
+        return;
+    }
+    if ( sig == NULL ) {
+        msg->m_no_sig++;
+        return;
+    }
+    memcpy(&msg->m_data[msg->m_cnt].m_sig, sig, sizeof(TrexStreamRxSig));
+    msg->m_data[msg->m_cnt].m_len = len;
+    msg->m_cnt++;
+    if ( msg->is_full() ) {
+        send_msg(core);
+    }
+}
+
+void CRxStatsStateless::send_msg(uint8_t core){
+    CGenNodeRxStatsPktInfo * msg = m_msg[core];
+    if ( m_cores[core+1].get_rx_stats_ring()->Enqueue((CGenNode *)msg) != 0 ) {
+        /* don't block the RX, count it */
+        m_ports[m_port_id].m_rx_stats_drop_pkt += msg->m_cnt + msg->m_no_sig;
+        CGlobalInfo::free_node((CGenNode *)msg);
+    }
+    m_msg[core]=0;
+}
+
+CGenNodeRxStatsPktInfo * CRxStatsStateless::get_msg(uint8_t core, hr_time_t now){
+    CGenNodeRxStatsPktInfo * msg = m_msg[core];
+    if ( msg == NULL ) {
+        msg = (CGenNodeRxStatsPktInfo *)CGlobalInfo::create_node();
+        if ( msg == NULL ) {
+            return (NULL);
+        }
+        msg->m_msg_type = CGenNodeMsgBase::RX_STATS_PKT;
+        msg->m_cnt      = 0;
+        msg->m_no_sig   = 0;
+        msg->m_time     = now;
+        m_msg[core]     = msg;
+    }
+    return (msg);
+}
+
+/* send what was collected from the rx burst */
+void CRxStatsStateless::flush_msgs(){
+    int i;
+    for (i=0; i<m_max_cores; i++) {
+        if ( m_msg[i] ) {
+            send_msg(i);
+        }
+    }
+}
+
 int CCoreEthIF::send_node(CGenNode * node){
 
     if ( odp_unlikely( node->get_cache_mbuf() !=NULL ) ) {
@@ -1748,7 +2339,7 @@ public:
 			 m->l2_len   =14;
         }
 #endif
-        uint16_t res=m_port->tx_burst(tx_pkts,1);
+        uint16_t res=m_port->tx_burst(m_tx_queue_id,tx_pkts,1);
         if ( res == 0 ) {
             rte_pktmbuf_free(m);
             //printf(" queue is full for latency packet !!\n");
@@ -1765,21 +2356,19 @@ public:
         return (0);
     }
     virtual rte_mbuf_t * rx(){
-//        rte_mbuf_t * rx_pkts[1];
-//        uint16_t cnt=m_port->rx_burst(m_rx_queue_id,rx_pkts,1);
-//        if (cnt) {
-//            return (rx_pkts[0]);
-//        }else{
-//            return (0);
-//        }
-        return NULL;
+        rte_mbuf_t * rx_pkts[1];
+        uint16_t cnt=m_port->rx_burst(m_rx_queue_id,rx_pkts,1);
+        if (cnt) {
+            return (rx_pkts[0]);
+        }else{
+            return (0);
+        }
     }
 
     virtual uint16_t rx_burst(struct rte_mbuf **rx_pkts, 
                                uint16_t nb_pkts){
-//        uint16_t cnt=m_port->rx_burst(m_rx_queue_id,rx_pkts,nb_pkts);
-//        return (cnt);
-        return 0;
+        uint16_t cnt=m_port->rx_burst(m_rx_queue_id,rx_pkts,nb_pkts);
+        return (cnt);
     }
 
 
@@ -2226,6 +2815,8 @@ public:
     }
 
     int run_in_laterncy_core();
+    int run_in_rx_stats_core();
+    int run_in_rx_core(uint8_t rx_id);
 
     int run_in_master();
     int stop_master();
@@ -2336,6 +2927,7 @@ public:
     volatile uint8_t       m_signal[BP_MAX_CORES] ODP_ALIGNED_CACHE ;
 
     CLatencyManager     m_mg;
+    CRxStatsStateless   m_rx_sl; /* stateless RX thread */
     CTrexGlobalIoMode   m_io_modes;
 
 private:
@@ -2569,7 +3161,7 @@ int CGlobalTRex::test_send_pkts(uint16_t queue_id,
         rte_mbuf_refcnt_update(m_test,1);
         tx_pkts[i]=m_test;
     }
-    uint16_t res=lp->tx_burst(tx_pkts,pkt);
+    uint16_t res=lp->tx_burst(queue_id,tx_pkts,pkt);
     if ((pkt-res)>0) {
         m_test_drop+=(pkt-res);
     }
@@ -2619,16 +3211,16 @@ CGlobalTRex::check_for_dp_message_from_core(int thread_id) {
         return;
     }
 
-    while ( true ) {
-        CGenNode * node = NULL;
-        if (ring->Dequeue(node) != 0) {
-            break;
+    CGenNode * nodes[MSG_DEQUEUE_BURST];
+    uint32_t cnt;
+    while ( (cnt = ring->DequeueBurst(nodes, MSG_DEQUEUE_BURST)) > 0 ) {
+        uint32_t i;
+        for (i = 0; i < cnt; i++) {
+            assert(nodes[i]);
+            TrexStatelessDpToCpMsgBase * msg = (TrexStatelessDpToCpMsgBase *)nodes[i];
+            msg->handle();
+            delete msg;
         }
-        assert(node);
-
-        TrexStatelessDpToCpMsgBase * msg = (TrexStatelessDpToCpMsgBase *)node;
-        msg->handle();
-        delete msg;
     }
 
 }
@@ -2714,6 +3306,7 @@ int  CGlobalTRex::ixgbe_configure_mg(void){
     int i;
     CLatencyManagerCfg mg_cfg;
     mg_cfg.m_max_ports = m_max_ports;
+    mg_cfg.m_rx_cores = CGlobalInfo::m_options.m_rx_cores;
 
     uint32_t latency_rate=CGlobalInfo::m_options.m_latency_rate;
 
@@ -2776,8 +3369,12 @@ int  CGlobalTRex::ixgbe_start(void){
             assert(CGlobalInfo::m_mem_pool[socket_id].m_big_mbuf_pool);
 
             _if->create_pktio(get_odp_packet_pool(socket_id));
+            /* one tx queue per DP core, latency goes through the DP */
+            _if->tx_queue_setup(m_max_queues_per_port);
+            /* the DP core drains rx queue 0 */
+            _if->rx_queue_setup(1);
 
-            //_if->set_rx_queue(0);
+            _if->set_rx_queue(0);
 	    //_if->create_pktio(CGlobalInfo::m_mem_pool[socket_id].m_big_mbuf_pool->odp_buffer_pool);
 //            _if->rx_queue_setup(0,
 //                                RTE_TEST_RX_DESC_VM_DEFAULT,
@@ -2807,6 +3404,20 @@ int  CGlobalTRex::ixgbe_start(void){
             assert(CGlobalInfo::m_mem_pool[socket_id].m_big_mbuf_pool);
 	    
             _if->create_pktio(get_odp_packet_pool(socket_id));
+            /* one tx queue per DP core + the latency queue */
+            _if->tx_queue_setup(m_max_queues_per_port+1);
+            /* one pktin queue read by the latency thread only, the classifier
+               moves the measurement packets to the latency queue (1) and the
+               rest to the drop queue. stateless has no latency, its RX thread
+               reads all the packets from the rx_stats queue (1) */
+            _if->rx_queue_setup(1);
+            _if->set_rx_queue(1);
+            if ( get_is_stateless() ) {
+                _if->configure_rx_stats_queue();
+            }else{
+                _if->configure_rx_duplicate_rules();
+                _if->configure_rx_drop_queue();
+            }
 	    
 	    //_if->create_pktio(CGlobalInfo::m_mem_pool[socket_id].m_big_mbuf_pool->odp_buffer_pool);
 
@@ -2842,8 +3453,6 @@ int  CGlobalTRex::ixgbe_start(void){
         _if->stats_clear();
         _if->set_promiscuous(true);
         _if->start();
-//        _if->configure_rx_drop_queue();
-//        _if->configure_rx_duplicate_rules();
 //
 //        _if->disable_flow_control();
 
@@ -2873,11 +3482,7 @@ int  CGlobalTRex::ixgbe_start(void){
 //        }
 //    }
 
-    /* FIXME: 
-     * no rx-check support currently
-     * no need to rx packets
-     */
-//    ixgbe_rx_queue_flush();
+    ixgbe_rx_queue_flush();
 
 
     ixgbe_configure_mg();
@@ -2909,8 +3514,15 @@ int  CGlobalTRex::ixgbe_start(void){
         if (port_offset == m_max_ports) {
             port_offset = 0;
         }    
+        if ( get_is_stateless() ){
+            m_cores_vif_sl[j].create_rx_stats();
+        }
      }
 
+    if ( get_is_stateless() ){
+        m_rx_sl.Create(m_ports, m_max_ports, m_cores_vif_sl, get_cores_tx());
+    }
+
     fprintf(stdout," -------------------------------\n");
     CCoreEthIF::DumpIfCfgHeader(stdout);
     for (i=0; i<get_cores_tx(); i++) {
@@ -2999,7 +3611,7 @@ odp_pktio_t CPhyEthIF::create_pktio(odp_pool_t pool) {
     odp_pktio_param_t pktio_param;
     odp_pktio_param_init(&pktio_param);
 
-    pktio_param.in_mode = ODP_PKTIN_MODE_DISABLED;
+    pktio_param.in_mode = ODP_PKTIN_MODE_DIRECT;
     pktio_param.out_mode = ODP_PKTOUT_MODE_DIRECT;
 
     if(CGlobalInfo::is_odpgeneric()) {
@@ -3022,6 +3634,103 @@ odp_pktio_t CPhyEthIF::create_pktio(odp_pool_t pool) {
     return pktio;
 }
 
+/* replaces the dpdk rx queues, direct pktin queues polled with rx_burst()
+ * ids above the number of odp queues share the last ones (modulo)
+ */
+void CPhyEthIF::rx_queue_setup(uint16_t nb_rx_queue){
+    odp_pktio_capability_t capa;
+    odp_pktin_queue_param_t param;
+    int ret;
+    int i;
+
+    assert( (nb_rx_queue>0) && (nb_rx_queue<=BP_MAX_RX_QUEUE) );
+    ret = odp_pktio_capability(m_pkt_io, &capa);
+    if (ret != 0) {
+        rte_exit(EXIT_FAILURE, "odp_pktio_capability: "
+                "err=%d, port=%u\n",
+                 ret, m_port_id);
+    }
+
+    odp_pktin_queue_param_init(&param);
+    param.op_mode     = ODP_PKTIO_OP_MT_UNSAFE;
+    param.hash_enable = 0;
+    param.num_queues  = nb_rx_queue;
+    if ( capa.max_input_queues < nb_rx_queue ) {
+        printf(" WARNING port %d has only %u rx queues, %u are needed \n",
+               m_port_id, capa.max_input_queues, nb_rx_queue);
+        param.num_queues = (capa.max_input_queues > 0) ? capa.max_input_queues : 1;
+    }
+
+    ret = odp_pktin_queue_config(m_pkt_io, &param);
+    if (ret != 0) {
+        rte_exit(EXIT_FAILURE, "odp_pktin_queue_config: "
+                "err=%d, port=%u, queues=%u\n",
+                 ret, m_port_id, param.num_queues);
+    }
+
+    m_rx_queues_num = (uint16_t)param.num_queues;
+    odp_pktin_queue_t queues[BP_MAX_RX_QUEUE];
+    ret = odp_pktin_queue(m_pkt_io, queues, m_rx_queues_num);
+    if (ret != (int)m_rx_queues_num) {
+        rte_exit(EXIT_FAILURE, "odp_pktin_queue: "
+                "err=%d, port=%u\n",
+                 ret, m_port_id);
+    }
+
+    for (i=0; i<BP_MAX_RX_QUEUE; i++) {
+        m_rx_queues[i] = queues[i % m_rx_queues_num];
+    }
+}
+
+/* replaces the dpdk tx queues, one direct pktout queue per TX thread
+ * so odp does not need to lock on send. In case the interface has less
+ * queues, the ids are spread over the real queues and odp locks
+ */
+void CPhyEthIF::tx_queue_setup(uint16_t nb_tx_queue){
+    odp_pktio_capability_t capa;
+    odp_pktout_queue_param_t param;
+    odp_pktout_queue_t queues[BP_MAX_TX_QUEUE+1];
+    int ret;
+    int i;
+
+    assert( (nb_tx_queue>0) && (nb_tx_queue<=BP_MAX_TX_QUEUE+1) );
+    ret = odp_pktio_capability(m_pkt_io, &capa);
+    if (ret != 0) {
+        rte_exit(EXIT_FAILURE, "odp_pktio_capability: "
+                "err=%d, port=%u\n",
+                 ret, m_port_id);
+    }
+
+    odp_pktout_queue_param_init(&param);
+    param.op_mode    = ODP_PKTIO_OP_MT_UNSAFE;
+    param.num_queues = nb_tx_queue;
+    if ( capa.max_output_queues < nb_tx_queue ) {
+        printf(" WARNING port %d has only %u tx queues, %u are needed, queues will be shared \n",
+               m_port_id, capa.max_output_queues, nb_tx_queue);
+        param.op_mode    = ODP_PKTIO_OP_MT;
+        param.num_queues = (capa.max_output_queues > 0) ? capa.max_output_queues : 1;
+    }
+
+    ret = odp_pktout_queue_config(m_pkt_io, &param);
+    if (ret != 0) {
+        rte_exit(EXIT_FAILURE, "odp_pktout_queue_config: "
+                "err=%d, port=%u, queues=%u\n",
+                 ret, m_port_id, param.num_queues);
+    }
+
+    m_tx_queues_num = (uint16_t)param.num_queues;
+    ret = odp_pktout_queue(m_pkt_io, queues, m_tx_queues_num);
+    if (ret != (int)m_tx_queues_num) {
+        rte_exit(EXIT_FAILURE, "odp_pktout_queue: "
+                "err=%d, port=%u\n",
+                 ret, m_port_id);
+    }
+
+    for (i=0; i<nb_tx_queue; i++) {
+        m_tx_queues[i] = queues[i % m_tx_queues_num];
+    }
+}
+
 int  CGlobalTRex::ixgbe_prob_init(void){
     if ( CGlobalInfo::m_options.get_expected_ports() >BP_MAX_PORTS ){
         rte_exit(EXIT_FAILURE, " maximum ports supported are %d, use the configuration file to set the expected number of ports   \n",BP_MAX_PORTS);
@@ -3546,6 +4255,9 @@ int CGlobalTRex::run_in_master(){
     }
 
     m_mg.stop();
+    if ( get_is_stateless() ) {
+        m_rx_sl.stop();
+    }
     delay(1000);
     if ( was_stopped ){
         /* we should stop latency and exit to stop agents */
@@ -3563,6 +4275,20 @@ int CGlobalTRex::run_in_laterncy_core(void){
     return (0);
 }
 
+/* stateless has no latency, the RX thread reads the rx_stats packets */
+int CGlobalTRex::run_in_rx_stats_core(void){
+    m_rx_sl.start();
+    return (0);
+}
+
+/* extra latency/rx-check RX core, rx_id 0 is the latency core itself */
+int CGlobalTRex::run_in_rx_core(uint8_t rx_id){
+    if ( !CGlobalInfo::m_options.is_latency_disabled() ){
+        m_mg.start_rx(rx_id);
+    }
+    return (0);
+}
+
 
 int CGlobalTRex::stop_core(virtual_thread_id_t virt_core_id){
     m_signal[virt_core_id]=1;
@@ -3848,6 +4574,9 @@ TrexStateless * get_stateless_obj() {
 //
 typedef struct tx_worker_args_ {
     virtual_thread_id_t virt_core_id;
+    bool                is_latency;
+    bool                is_rx_stats; /* the stateless RX thread */
+    uint8_t             rx_id;      /* >0 for an extra RX core */
     int                 ret;
 } tx_worker_args_t;
 
@@ -3857,8 +4586,19 @@ void* tx_worker_thread(void * args) {
     //     exit(1);
     // }
     tx_worker_args_t *tx_args = (tx_worker_args_t*) args;
-    printf("enter tx_worker_thread, core:%d\n",tx_args->virt_core_id);
-    tx_args->ret = g_trex.run_in_core(tx_args->virt_core_id);
+    if ( tx_args->rx_id ) {
+        printf("enter rx_worker_thread, rx core:%d\n",tx_args->rx_id);
+        tx_args->ret = g_trex.run_in_rx_core(tx_args->rx_id);
+    }else if ( tx_args->is_rx_stats ) {
+        printf("enter rx_stats_worker_thread\n");
+        tx_args->ret = g_trex.run_in_rx_stats_core();
+    }else if ( tx_args->is_latency ) {
+        printf("enter latency_worker_thread\n");
+        tx_args->ret = g_trex.run_in_laterncy_core();
+    }else{
+        printf("enter tx_worker_thread, core:%d\n",tx_args->virt_core_id);
+        tx_args->ret = g_trex.run_in_core(tx_args->virt_core_id);
+    }
     return (void*)tx_args;
 }
 
@@ -4110,7 +4850,9 @@ int main_test(int argc , char * argv[]){
         exit(1);
     }
     pal_constructor();
-	  
+    pal_set_zero_copy(CGlobalInfo::is_odp_zero_copy());
+
+    os_hr_calibrate();
     time_init();
     
         /* check if we are in simulation mode */
@@ -4175,7 +4917,16 @@ int main_test(int argc , char * argv[]){
     }
 
     CPlatformSocketInfo * lpsock=&CGlobalInfo::m_socket;
-    uint8_t req_num_workers = lpsock->get_cores_num()-1;
+    uint8_t req_num_dp_workers = lpsock->get_cores_num()-1;
+    uint8_t req_num_workers = req_num_dp_workers;
+    bool rx_stats = get_is_stateless() && !get_vm_one_queue_enable();
+    if ( !CGlobalInfo::m_options.is_latency_disabled() ) {
+        /* the latency core is RX core 0, the rest get their own threads */
+        req_num_workers += CGlobalInfo::m_options.m_rx_cores-1;
+    }else if ( rx_stats ) {
+        /* one RX thread owns the rx queue of all the ports */
+        req_num_workers += 1;
+    }
     uint8_t avail_num_workers = 0;
     odp_cpumask_t cpumask;
     int cpu;
@@ -4196,7 +4947,21 @@ int main_test(int argc , char * argv[]){
         odp_cpumask_t thd_mask;
         odp_cpumask_zero(&thd_mask);
         odp_cpumask_set(&thd_mask, cpu);
-        args[i].virt_core_id = lpsock->thread_phy_to_virt(i+1);
+        args[i].is_rx_stats = false;
+        if ( i < req_num_dp_workers ) {
+            args[i].virt_core_id = lpsock->thread_phy_to_virt(i+1);
+            args[i].is_latency   = lpsock->thread_phy_is_latency(i+1);
+            args[i].rx_id        = 0;
+        }else if ( rx_stats ) {
+            args[i].virt_core_id = 0;
+            args[i].is_latency   = false;
+            args[i].is_rx_stats  = true;
+            args[i].rx_id        = 0;
+        }else{
+            args[i].virt_core_id = 0;
+            args[i].is_latency   = false;
+            args[i].rx_id        = i - req_num_dp_workers + 1;
+        }
         odph_linux_pthread_create(&thread_tbl[i], &thd_mask,
                                   tx_worker_thread,
                                   &args[i],
@@ -4283,6 +5048,16 @@ TrexDpdkPlatformApi::get_dp_core_count() const {
     return CGlobalInfo::m_options.preview.getCores();
 }
 
+const TrexStreamsTxStats *
+TrexDpdkPlatformApi::get_stream_tx_stats(uint8_t core_id) const {
+    return g_trex.m_fl.m_threads_info[core_id]->get_stream_tx_stats();
+}
+
+const TrexStreamsRxStats *
+TrexDpdkPlatformApi::get_stream_rx_stats(uint8_t core_id) const {
+    return g_trex.m_cores_vif_sl[core_id + 1].get_stream_rx_stats();
+}
+
 
 void
 TrexDpdkPlatformApi::port_id_to_cores(uint8_t port_id, std::vector<std::pair<uint8_t, uint8_t>> &cores_id_list) const {
@@ -32,6 +32,8 @@ struct CGenNodeMsgBase  {
     enum {
         NAT_FIRST     = 7,
         LATENCY_PKT   = 8,
+        RX_CHECK_PKT  = 9,
+        RX_STATS_PKT  = 10,
     } msg_types;
 
 public:
@@ -70,6 +72,9 @@ cp     <-      -- dp1
 class CGenNode ;
 typedef CTRingSp<CGenNode>  CNodeRing;
 
+/* the consumers take the messages of a ring in bursts of up to this size */
+#define MSG_DEQUEUE_BURST   32
+
 /* CP == latency thread 
    DP == traffic pkt generator */
 class CMessagingManager {
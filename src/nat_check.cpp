@@ -46,6 +46,7 @@ void CNatStats::reset(){
     m_err_no_valid_thread_id=0;
     m_err_no_valid_proto=0;
     m_err_queue_full=0;
+    m_queue_full_retry=0;
 }
 
 
@@ -82,7 +83,6 @@ void CNatRxManager::Delete(){
     }
 }
 
-void delay(int msec);
 
 
 
@@ -100,26 +100,19 @@ void CNatRxManager::handle_aging(){
     }
 }
 
-void CNatRxManager::flush_node(CNatPerThreadInfo * thread_info){
-        // try send 
-        int cnt=0;
-        while (true) {
-            if ( thread_info->m_ring->Enqueue((CGenNode*)thread_info->m_cur_nat_msg) == 0 ){
-                #ifdef NAT_TRACE_
-                printf("send message \n");
-                #endif
-                break;
-            }
-            m_stats.m_err_queue_full++;
-            delay(1);
-            cnt++;
-            if (cnt>10) {
-                printf(" ERROR  queue from rx->dp is stuck, somthing is wrong here \n");
-                exit(1);
-            }
-        }
-        /* msg will be free by sink */
-        thread_info->m_cur_nat_msg=0;
+/* never blocks the RX core, when the ring is full the message is kept and tried again by the aging */
+bool CNatRxManager::flush_node(CNatPerThreadInfo * thread_info){
+    if ( thread_info->m_ring->Enqueue((CGenNode*)thread_info->m_cur_nat_msg) != 0 ){
+        m_stats.m_queue_full_retry++;
+        return (false);
+    }
+    #ifdef NAT_TRACE_
+    printf("send message \n");
+    #endif
+    m_stats.m_total_msg++;
+    /* msg will be free by sink */
+    thread_info->m_cur_nat_msg=0;
+    return (true);
 }
 
 
@@ -148,6 +141,16 @@ void CNatRxManager::handle_packet_ipv4(CNatOption * option,
 
 
     CGenNodeNatInfo * node=thread_info->m_cur_nat_msg;
+    if ( node && node->is_full() ){
+        /* the ring stayed full since the message was filled, drop it. the 
+           flows of the message are not learned and time out on the DP */
+        if ( !flush_node(thread_info) ){
+            m_stats.m_err_queue_full++;
+            CGlobalInfo::free_node((CGenNode *)node);
+            thread_info->m_cur_nat_msg = 0;
+        }
+        node = 0;
+    }
     if ( !node ){
         node = (CGenNodeNatInfo * )CGlobalInfo::create_node();
         assert(node);
@@ -182,6 +185,7 @@ void CNatStats::Dump(FILE *fd){
    MYDP(m_err_no_valid_thread_id);
    MYDP(m_err_no_valid_proto);
    MYDP(m_err_queue_full);
+   MYDP(m_queue_full_retry);
 }
 
 
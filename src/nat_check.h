@@ -121,7 +121,9 @@ public:
     /* errors */
     uint64_t  m_err_no_valid_thread_id;
     uint64_t  m_err_no_valid_proto;
-    uint64_t  m_err_queue_full;
+    uint64_t  m_err_queue_full;   /* messages dropped, the ring to the DP stayed full */
+    /* not an error, the ring was full and the message is sent on a later try */
+    uint64_t  m_queue_full_retry;
 public:
     uint64_t get_errs(){
         return  (m_err_no_valid_thread_id+m_err_no_valid_proto+m_err_queue_full);
@@ -142,7 +144,7 @@ public:
     void DumpShort(FILE *fd);
 private:
     CNatPerThreadInfo * get_thread_info(uint8_t thread_id);
-    void flush_node(CNatPerThreadInfo * thread_info);
+    bool flush_node(CNatPerThreadInfo * thread_info);
 
 private:
     uint8_t               m_max_threads;
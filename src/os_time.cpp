@@ -118,6 +118,67 @@ uint32_t os_get_time_freq(){
     return (SANB_sysClkRateGet());
 }
 
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <cpuid.h>
+
+/* nsec ticks until it is calibrated */
+hr_time_t os_hr_freq = 1000000000ULL;
+bool      os_hr_tsc  = false;
+
+/* CPUID.80000007H:EDX[8], the TSC runs at a constant rate in all the 
+   P/C states. without it the TSC can't be used as a clock */
+static bool os_has_invariant_tsc(){
+    unsigned int eax, ebx, ecx, edx;
+    if ( !__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) ) {
+        return (false);
+    }
+    return ( (edx & (1 << 8)) ? true : false );
+}
+
+/* a tsc reading and the ns time it was taken at, the ns reads around it 
+   that are the closest give the smallest error */
+static void os_get_tsc_ns_pair(hr_time_t & tsc, uint64_t & ns){
+    uint64_t best = ~0ULL;
+    int i;
+    tsc = 0;
+    ns  = 0;
+    for (i=0; i<8; i++) {
+        uint64_t n0 = platform_time_get_ns();
+        hr_time_t t;
+        platform_time_get_highres_tick_64(&t);
+        uint64_t n1 = platform_time_get_ns();
+        if ( (n1 - n0) < best ) {
+            best = n1 - n0;
+            tsc  = t;
+            ns   = n0 + (n1 - n0) / 2;
+        }
+    }
+}
+
+/* measure the tsc over 20 msec of the odp_time clock, stay with the 
+   nsec clock when the TSC is not invariant */
+void os_hr_calibrate(void){
+    hr_time_t tsc0 = 0, tsc1 = 0;
+    uint64_t  ns0 = 0, ns1 = 0;
+
+    if ( !os_has_invariant_tsc() ) {
+        fprintf(stderr," WARNING : no invariant TSC, using the odp_time clock \n");
+        return;
+    }
+
+    os_get_tsc_ns_pair(tsc0, ns0);
+    delay(20);
+    os_get_tsc_ns_pair(tsc1, ns1);
+
+    if ( (ns1 > ns0) && (tsc1 > tsc0) ) {
+        os_hr_freq = (hr_time_t)((double)(tsc1 - tsc0) * 1e9 / (double)(ns1 - ns0));
+        os_hr_tsc  = true;
+    }
+}
+
+#endif
+
 
 
 #endif 
@@ -36,62 +36,75 @@ uint32_t 	 os_get_time_freq();
 
 #ifdef LINUX
 
-#ifdef RTE_DPDK
-
-
-static inline hr_time_t    os_get_hr_tick_64(void){
-    odp_time_t now = odp_time_local();
-    return odp_time_to_ns(now);
-}
-
-static inline hr_time_32_t os_get_hr_tick_32(void){
-    return ( (uint32_t)os_get_hr_tick_64());
-}
+#if defined(__x86_64__) || defined(__i386__)
 
-static inline hr_time_t    os_get_hr_freq(void){
-    return (1000000000 );
-}
+/* invariant TSC, the frequency is calibrated against the monotonic clock 
+   by os_hr_calibrate(), see os_time.cpp. reading it is a few cycles 
+   while odp_time_local() + odp_time_to_ns() is a system clock read and a 
+   division, the DP scheduler reads the time several times per packet.
+   until it is calibrated, or when the TSC is not invariant, the ticks are 
+   nsec of the odp_time clock */
 
+extern hr_time_t os_hr_freq;
+extern bool      os_hr_tsc;
 
+/* call it once before time_init(), it changes the tick source */
+void os_hr_calibrate(void);
 
-#else
-
-
-/* read the rdtsc register for ticks
-   works for 64 bit aswell
-*/
 static inline void  platform_time_get_highres_tick_64(uint64_t* t)
 {
     uint32_t lo, hi;
-    __asm__ __volatile__ (      // serialize
-	  "xorl %%eax,%%eax \n        cpuid"
-	  ::: "%rax", "%rbx", "%rcx", "%rdx");
      /* We cannot use "=A", since this would use %rax on x86_64 and return
      only the lower 32bits of the TSC */
      __asm__ __volatile__ ("rdtsc" : "=a" (lo), "=d" (hi));
     *t = (uint64_t)hi << 32 | lo;
 }
 
-static inline uint32_t  platform_time_get_highres_tick_32()
-{
-    uint64_t t;
-    platform_time_get_highres_tick_64(&t);
-    return ((uint32_t)t);
+static inline uint64_t platform_time_get_ns(void){
+#ifdef RTE_DPDK
+    odp_time_t now = odp_time_local();
+    return odp_time_to_ns(now);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+#endif
 }
 
-
 static inline hr_time_t    os_get_hr_freq(void){
-	return (3000000000ULL);
+	return (os_hr_freq);
 }
 
 static inline hr_time_t os_get_hr_tick_64(void) {
  hr_time_t res;
- platform_time_get_highres_tick_64(&res);
+ if ( odp_likely(os_hr_tsc) ) {
+     platform_time_get_highres_tick_64(&res);
+ }else{
+     res = platform_time_get_ns();
+ }
  return (res);
 }
 
 static inline uint32_t os_get_hr_tick_32(void) {
-	return (platform_time_get_highres_tick_32());
+	return ((uint32_t)os_get_hr_tick_64());
+}
+
+#else
+
+static inline hr_time_t    os_get_hr_tick_64(void){
+    odp_time_t now = odp_time_local();
+    return odp_time_to_ns(now);
+}
+
+static inline hr_time_32_t os_get_hr_tick_32(void){
+    return ( (uint32_t)os_get_hr_tick_64());
+}
+
+static inline hr_time_t    os_get_hr_freq(void){
+    return (1000000000 );
+}
+
+static inline void os_hr_calibrate(void){
 }
 
 #endif
@@ -127,6 +140,15 @@ static inline dsec_t now_sec(void){
 	return ( ptime_convert_hr_dsec(d) );
 }
 
+/* the tick of a time in sec since time_init(), the schedulers convert a 
+   node time once and spin on the tick */
+static inline hr_time_t os_sec_to_hr_tick(dsec_t sec){
+    if ( sec <= 0.0 ) {
+        return (start_time);
+    }
+    return ( start_time + ptime_convert_dsec_hr(sec) );
+}
+
 
 static inline 
 void delay(int msec){
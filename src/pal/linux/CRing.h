@@ -67,6 +67,25 @@ public:
         }
     }
 
+    /* up to n objects, returns the number that were enqueued */
+    uint32_t EnqueueBurst(void * const * objs, uint32_t n){
+        uint32_t i;
+        for (i=0; i<n; i++) {
+            m_queue->push(objs[i]);
+        }
+        return (n);
+    }
+
+    /* up to n objects, returns the number that were dequeued */
+    uint32_t DequeueBurst(void ** objs, uint32_t n){
+        uint32_t i;
+        for (i=0; (i<n) && !m_queue->empty(); i++) {
+            objs[i] = m_queue->front();
+            m_queue->pop();
+        }
+        return (i);
+    }
+
     bool isFull(void){
         return (false);
     }
@@ -89,6 +108,14 @@ public:
     int Dequeue(T * & obj){
         return (CRingSp::Dequeue(*((void **)&obj)));
     }
+
+    uint32_t EnqueueBurst(T * const * objs, uint32_t n){
+        return ( CRingSp::EnqueueBurst((void * const *)objs, n) );
+    }
+
+    uint32_t DequeueBurst(T ** objs, uint32_t n){
+        return (CRingSp::DequeueBurst((void **)objs, n));
+    }
 };
 
 
@@ -25,6 +25,7 @@ limitations under the License.
 #include <stdlib.h> 
 #include <ctype.h>
 #include "sanb_atomic.h"
+#include "utl_rand.h"
 
 
 #define RTE_MBUF_TO_BADDR(mb)       (((struct rte_mbuf *)(mb)) + 1)
@@ -89,7 +90,7 @@ void utl_rte_mempool_delete(rte_mempool_t * & pool){
 uint16_t rte_mbuf_refcnt_update(rte_mbuf_t *m, int16_t value)
 {
     utl_rte_pktmbuf_check(m);
-    uint32_t a=sanb_atomic_add_return_32_old(&m->refcnt_reserved,1);
+    uint32_t a=sanb_atomic_add_return_32_old(&m->refcnt_reserved,(uint32_t)value);
 	return (a);
 }
 
@@ -104,6 +105,7 @@ void rte_pktmbuf_reset(struct rte_mbuf *m)
 	m->nb_segs = 1;
 	m->in_port = 0xff;
     m->refcnt_reserved=1;
+    m->is_static=0;
 
     #if RTE_PKTMBUF_HEADROOM > 0
     m->data_off = (RTE_PKTMBUF_HEADROOM <= m->buf_len) ?
@@ -166,6 +168,10 @@ void rte_pktmbuf_free(rte_mbuf_t *m){
 
     utl_rte_pktmbuf_check(m);
 
+    if ( rte_pktmbuf_is_static(m) ) {
+        return;
+    }
+
 	while (m != NULL) {
 		m_next = m->next;
 		rte_pktmbuf_free_seg(m);
@@ -382,8 +388,9 @@ rte_mbuf_t * utl_rte_pktmbuf_add_after(rte_mbuf_t *m1,rte_mbuf_t *m2){
 }
 
 
+/* generator of the calling thread, no lock */
 uint64_t rte_rand(void){
-    return ( rand() );
+    return ( utl_rand64(utl_rand_thread_state()) );
 }
 
 
@@ -56,6 +56,7 @@ struct rte_mbuf {
 
     uint32_t magic2;
     uint32_t refcnt_reserved;     /**< Do not use this field */
+    uint8_t  is_static;           /**< Owned by its creator, see rte_pktmbuf_set_static() */
 } ;
 
 
@@ -163,6 +164,17 @@ rte_lcore_to_socket_id(unsigned lcore_id){
  */
 #define rte_pktmbuf_data_len(m) ((m)->data_len)
 
+/**
+ * A static mbuf is owned by its creator (e.g. the cached packet of a
+ * stream), rte_pktmbuf_free() does not release it. Clear the flag before
+ * the last free.
+ */
+static inline void rte_pktmbuf_set_static(rte_mbuf_t *m, bool enable){
+    m->is_static = enable ? 1 : 0;
+}
+
+#define rte_pktmbuf_is_static(m) ((m)->is_static)
+
 
 uint64_t rte_rand(void);
 
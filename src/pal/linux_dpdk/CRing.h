@@ -54,8 +54,19 @@ public:
         return (rte_ring_sp_enqueue(m_ring,obj));
     }
 
+    /* the ring is single consumer */
     int Dequeue(void * & obj){
-        return(rte_ring_mc_dequeue(m_ring,(void **)&obj));
+        return(rte_ring_sc_dequeue(m_ring,(void **)&obj));
+    }
+
+    /* up to n objects, returns the number that were enqueued */
+    uint32_t EnqueueBurst(void * const * objs, uint32_t n){
+        return ((uint32_t)rte_ring_sp_enqueue_burst(m_ring, objs, n));
+    }
+
+    /* up to n objects, returns the number that were dequeued */
+    uint32_t DequeueBurst(void ** objs, uint32_t n){
+        return ((uint32_t)rte_ring_sc_dequeue_burst(m_ring, objs, n));
     }
 
     bool isFull(void){
@@ -80,6 +91,14 @@ public:
     int Dequeue(T * & obj){
         return (CRingSp::Dequeue(*((void **)&obj)));
     }
+
+    uint32_t EnqueueBurst(T * const * objs, uint32_t n){
+        return (CRingSp::EnqueueBurst((void * const *)objs, n));
+    }
+
+    uint32_t DequeueBurst(T ** objs, uint32_t n){
+        return (CRingSp::DequeueBurst((void **)objs, n));
+    }
 };
 
 
@@ -56,8 +56,19 @@ public:
 	return odph_ring_sp_enqueue_bulk(m_ring, &obj, 1);
     }
 
+    /* the ring is single consumer */
     int Dequeue(void * & obj){
-	return odph_ring_mc_dequeue_bulk(m_ring, (void**)&obj, 1);
+	return odph_ring_sc_dequeue_bulk(m_ring, (void**)&obj, 1);
+    }
+
+    /* up to n objects, returns the number that were enqueued */
+    uint32_t EnqueueBurst(void * const * objs, uint32_t n){
+        return ((uint32_t)odph_ring_sp_enqueue_burst(m_ring, objs, n));
+    }
+
+    /* up to n objects, returns the number that were dequeued */
+    uint32_t DequeueBurst(void ** objs, uint32_t n){
+        return ((uint32_t)odph_ring_sc_dequeue_burst(m_ring, objs, n));
     }
 
     bool isFull(void){
@@ -82,6 +93,14 @@ public:
     int Dequeue(T * & obj){
         return (CRingSp::Dequeue(*((void **)&obj)));
     }
+
+    uint32_t EnqueueBurst(T * const * objs, uint32_t n){
+        return (CRingSp::EnqueueBurst((void * const *)objs, n));
+    }
+
+    uint32_t DequeueBurst(T ** objs, uint32_t n){
+        return (CRingSp::DequeueBurst((void **)objs, n));
+    }
 };
 
 #endif
@@ -1,5 +1,6 @@
 #include "mbuf.h"
 #include <odp/helper/ring.h>
+#include "utl_rand.h"
 
 /*
  Hanoh Haim
@@ -34,6 +35,9 @@ struct trex_odp_buffer_handle {
 #define RTE_MBUF_FROM_BADDR(ba)     (((rte_mbuf_t *)(ba)) - 1)
 //alignment of rte_mempool_t
 #define MEMPOOL_ALIGN (16)
+//alignment of the objects in buffer backed mempools
+#define MEMPOOL_OBJ_ALIGN (ODP_CACHE_LINE_SIZE)
+#define MEMPOOL_OBJ_HEAD ROUND_UP_TREX_ODP_BUFFER_HANDLE(MEMPOOL_OBJ_ALIGN)
 
 /* MAGICA: allocated rte_mempool_t 
  * MAGICF: free rte_mempool_t
@@ -41,13 +45,40 @@ struct trex_odp_buffer_handle {
 #define MAGICA 0xBBCCDDAA
 #define MAGICF 0xBBCCDDFF
 
+/* debug builds fill the data area of every allocated mbuf with this,
+ * code relying on zeroed buffers shows up instead of working by chance
+ */
+#define MBUF_POISON 0x6b
+
 #define MAX_SOCKETS_SUPPORTED (4) //should keep in line with defined in bp_sim.h
-#define MAX_POOL_NUM (10)
+#define MAX_POOL_NUM (11)
 
 static odp_pool_t mempool_pool;
 static odp_pool_t packet_pool_arr[MAX_SOCKETS_SUPPORTED];
+/* all ODP_POOL_PACKET backed mempools, to find the mempool of a received packet
+ * the pktio pools (packet_pool_arr) come first
+ */
+static rte_mempool_t* pkt_mempool_tbl[MAX_SOCKETS_SUPPORTED*MAX_POOL_NUM];
+static uint32_t pkt_mempool_num;
+static bool pal_zero_copy = false;
+
+void pal_set_zero_copy(bool enable)
+{
+    pal_zero_copy = enable;
+}
+
+bool pal_is_zero_copy(void)
+{
+    return pal_zero_copy;
+}
 
 
+static rte_mempool_t* utl_rte_mempool_create_odp_pkt(const char *name,
+                                                     uint32_t n,
+                                                     uint32_t elt_size,
+                                                     uint32_t cache_size,
+                                                     uint32_t socket_id);
+
 void pal_constructor(void)
 {
     odp_pool_param_t pool_param;
@@ -65,36 +96,23 @@ void pal_constructor(void)
 	rte_exit(EXIT_FAILURE, "exit here %s: %d", __FUNCTION__, __LINE__);
     }
 
+    /* pktio rx and tx copies, the user area holds the rte_mbuf of a received packet
+     * no cache, the packets are allocated by odp and must go back to it
+     */
     for(i = 0; i < MAX_SOCKETS_SUPPORTED; i++) {
-	char name[MAX_NAME_LEN];
-	odp_pool_param_t pkt_pool_param;
-
-	snprintf(name, MAX_NAME_LEN, "pkt-%d", i);
-	odp_pool_param_init(&pkt_pool_param);
-	pkt_pool_param.pkt.seg_len = SHM_PKT_POOL_BUF_SIZE;
-	pkt_pool_param.pkt.len = SHM_PKT_POOL_BUF_SIZE;
-	pkt_pool_param.pkt.num = SHM_PKT_POOL_SIZE / SHM_PKT_POOL_BUF_SIZE;
-	pkt_pool_param.type = ODP_POOL_PACKET;
-
-	packet_pool_arr[i] = odp_pool_create(name, &pkt_pool_param);
-	if (packet_pool_arr[i] == ODP_POOL_INVALID) {
-	    printf("%s failed to create odp packet pool\n", __FUNCTION__);
-	    rte_exit(EXIT_FAILURE, "exit here %s: %d", __FUNCTION__, __LINE__);
-	}
+	rte_mempool_t* mp = utl_rte_mempool_create_odp_pkt("pkt",
+							   SHM_PKT_POOL_SIZE / SHM_PKT_POOL_BUF_SIZE,
+							   SHM_PKT_POOL_BUF_SIZE + sizeof(rte_mbuf_t),
+							   0, i);
+	packet_pool_arr[i] = mp->odp_buffer_pool;
     }
 }
 
-rte_mempool_t * utl_rte_mempool_create_non_pkt(const char  *name,
-                                               uint32_t n, 
-                                               uint32_t elt_size,
-                                               uint32_t cache_size,
-                                               uint32_t _id ,
-                                               int socket_id)
+static rte_mempool_t* utl_mempool_alloc(const char *name, int socket_id)
 {
     odp_buffer_t odp_buffer;
     struct trex_odp_buffer_handle* head;
     rte_mempool_t* mempool = NULL;
-    int ent_size = 0;
 
     if(odp_unlikely(socket_id >= MAX_SOCKETS_SUPPORTED)) {
 	printf("%s invalid argument socket_id %d\n", __FUNCTION__, socket_id);
@@ -114,24 +132,145 @@ rte_mempool_t * utl_rte_mempool_create_non_pkt(const char  *name,
 
     snprintf(mempool->name, MAX_NAME_LEN, "%s-%d", name, socket_id);
     mempool->socket_id = socket_id;
-    odp_atomic_init_u32(&mempool->count, 0);
+    mempool->is_pkt_pool = 0;
+    mempool->size = 0;
+    mempool->cache_size = 0;
+    mempool->cache_flushthresh = 0;
+    mempool->cache_shm = ODP_SHM_INVALID;
+    mempool->local_cache = NULL;
+
+    return mempool;
+}
+
+/* one rte_mempool_cache per odp thread, like dpdk's per lcore cache
+ * the counters of rte_mempool_count live there too, so get/put never
+ * write a cache line shared with other threads
+ */
+static void utl_mempool_cache_init(rte_mempool_t* mp, uint32_t n, uint32_t cache_size)
+{
+    char name[MAX_NAME_LEN + 8];
+
+    if (cache_size > RTE_MEMPOOL_CACHE_MAX_SIZE) {
+	cache_size = RTE_MEMPOOL_CACHE_MAX_SIZE;
+    }
+    /* as dpdk, a single cache should not be able to hold most of the pool */
+    if (cache_size * 3 / 2 > n) {
+	cache_size = n * 2 / 3;
+    }
+    mp->size = n;
+    mp->cache_size = cache_size;
+    mp->cache_flushthresh = cache_size * 3 / 2;
+
+    snprintf(name, sizeof(name), "%s-cache", mp->name);
+    mp->cache_shm = odp_shm_reserve(name,
+				    sizeof(struct rte_mempool_cache) * ODP_THREAD_COUNT_MAX,
+				    ODP_CACHE_LINE_SIZE, 0);
+    if (odp_unlikely(mp->cache_shm == ODP_SHM_INVALID)) {
+	printf("%s failed to reserve mempool cache\n", __FUNCTION__);
+	rte_exit(EXIT_FAILURE, "exit here %s: %d", __FUNCTION__, __LINE__);
+    }
+    mp->local_cache = (struct rte_mempool_cache*)odp_shm_addr(mp->cache_shm);
+    memset(mp->local_cache, 0, sizeof(struct rte_mempool_cache) * ODP_THREAD_COUNT_MAX);
+}
+
+/* build the header rte_pktmbuf_alloc() stamps on each mbuf of this pool */
+static void utl_mempool_mbuf_tmpl_init(rte_mempool_t* mp)
+{
+    rte_mbuf_t* tmpl = &mp->mbuf_tmpl;
+    uint32_t buf_len;
+
+    memset(tmpl, 0, sizeof(rte_mbuf_t));
+    if (mp->is_pkt_pool) {
+	/* data lives in the odp packet, the mbuf is the packet user area */
+	buf_len = mp->odp_buffer_pool_param.pkt.len;
+    } else {
+	uint32_t total_len = mp->odp_buffer_pool_param.buf.size - MEMPOOL_OBJ_HEAD;
+	if (total_len < sizeof(rte_mbuf_t)) {
+	    /* not a packet pool (e.g. the node pools), leave magic clear */
+	    return;
+	}
+	buf_len = total_len - sizeof(rte_mbuf_t);
+    }
+
+    tmpl->magic = MAGICA;
+    tmpl->pool = mp;
+    tmpl->buf_addr = NULL;
+    tmpl->buf_len = (uint16_t)buf_len;
+    /* keep some headroom between start of buffer and data */
+    tmpl->data_off = (RTE_PKTMBUF_HEADROOM <= tmpl->buf_len) ?
+	RTE_PKTMBUF_HEADROOM : tmpl->buf_len;
+    tmpl->data_len = 0;
+    tmpl->next = NULL;
+    tmpl->pkt_len = 0;
+    tmpl->nb_segs = 1;
+    tmpl->in_port = 0xff;
+    odp_atomic_init_u32(&tmpl->refcnt, 1);
+    tmpl->odp_pkt = ODP_PACKET_INVALID;
+}
+
+rte_mempool_t * utl_rte_mempool_create_non_pkt(const char  *name,
+                                               uint32_t n, 
+                                               uint32_t elt_size,
+                                               uint32_t cache_size,
+                                               uint32_t _id ,
+                                               int socket_id)
+{
+    rte_mempool_t* mempool = NULL;
+    int ent_size = 0;
+
+    mempool = utl_mempool_alloc(name, socket_id);
 
     /* buffer structure: |rounded struct trex_odp_buffer_handle|user area|
      * for packet buffer user area: |rte_mbuf|headroom|packet|tailroom|
      * for packet buffer caller has cover rte_mbuf and headroom in elt_size
      */
-    ent_size = ROUND_UP_TREX_ODP_BUFFER_HANDLE(cache_size) + elt_size;
+    ent_size = MEMPOOL_OBJ_HEAD + elt_size;
     
     odp_pool_param_init(&(mempool->odp_buffer_pool_param));
     mempool->odp_buffer_pool_param.buf.num = n;
     mempool->odp_buffer_pool_param.buf.size = ent_size;
-    mempool->odp_buffer_pool_param.buf.align = cache_size;
+    mempool->odp_buffer_pool_param.buf.align = MEMPOOL_OBJ_ALIGN;
     mempool->odp_buffer_pool_param.type = ODP_POOL_BUFFER;
     mempool->odp_buffer_pool = odp_pool_create(mempool->name, &(mempool->odp_buffer_pool_param));
     if (odp_unlikely(mempool->odp_buffer_pool == ODP_POOL_INVALID)) {
 	printf("%s failed to create odp buffer pool\n", __FUNCTION__);
 	rte_exit(EXIT_FAILURE, "exit here %s: %d", __FUNCTION__, __LINE__);
     }
+    utl_mempool_cache_init(mempool, n, cache_size);
+    utl_mempool_mbuf_tmpl_init(mempool);
+
+    return mempool;
+}
+
+/* zero-copy packet mempool
+ * packet structure: user area |rte_mbuf|, packet data |odp headroom|packet|
+ * elt_size covers rte_mbuf and headroom as for the buffer backed pools
+ */
+static rte_mempool_t* utl_rte_mempool_create_odp_pkt(const char *name,
+                                                     uint32_t n,
+                                                     uint32_t elt_size,
+                                                     uint32_t cache_size,
+                                                     uint32_t socket_id)
+{
+    rte_mempool_t* mempool = NULL;
+
+    mempool = utl_mempool_alloc(name, socket_id);
+
+    odp_pool_param_init(&(mempool->odp_buffer_pool_param));
+    mempool->odp_buffer_pool_param.pkt.num = n;
+    mempool->odp_buffer_pool_param.pkt.len = elt_size - sizeof(rte_mbuf_t);
+    mempool->odp_buffer_pool_param.pkt.seg_len = elt_size - sizeof(rte_mbuf_t);
+    mempool->odp_buffer_pool_param.pkt.uarea_size = sizeof(rte_mbuf_t);
+    mempool->odp_buffer_pool_param.type = ODP_POOL_PACKET;
+    mempool->is_pkt_pool = 1;
+    mempool->odp_buffer_pool = odp_pool_create(mempool->name, &(mempool->odp_buffer_pool_param));
+    if (odp_unlikely(mempool->odp_buffer_pool == ODP_POOL_INVALID)) {
+	printf("%s failed to create odp packet pool\n", __FUNCTION__);
+	rte_exit(EXIT_FAILURE, "exit here %s: %d", __FUNCTION__, __LINE__);
+    }
+    utl_mempool_cache_init(mempool, n, cache_size);
+    utl_mempool_mbuf_tmpl_init(mempool);
+    pkt_mempool_tbl[pkt_mempool_num++] = mempool;
 
     return mempool;
 }
@@ -146,7 +285,11 @@ rte_mempool_t * utl_rte_mempool_create(const char  *name,
     rte_mempool_t* mempool = NULL;
 
     /*caller should have already covered rte_mbuf_t in elt_size*/
-    mempool = utl_rte_mempool_create_non_pkt(name, n, elt_size, cache_size, _id, socket_id);
+    if (pal_zero_copy) {
+	mempool = utl_rte_mempool_create_odp_pkt(name, n, elt_size, cache_size, socket_id);
+    } else {
+	mempool = utl_rte_mempool_create_non_pkt(name, n, elt_size, cache_size, _id, socket_id);
+    }
     if(odp_unlikely(mempool == NULL)) {
 	printf("%s failed to create mempool\n", __FUNCTION__);
 	rte_exit(EXIT_FAILURE, "exit here %s: %d", __FUNCTION__, __LINE__);
@@ -179,53 +322,143 @@ static inline void utl_mbuf_check(const rte_mbuf_t* mbuf)
     }
 }
 
+static inline struct rte_mempool_cache* utl_mempool_cache(rte_mempool_t* mp)
+{
+    return &mp->local_cache[odp_thread_id()];
+}
+
+/* get cache_size + 1 objects from the odp pool in one call
+ * return the number of objects added to the cache
+ */
+static int utl_mempool_cache_refill(rte_mempool_t* mp, struct rte_mempool_cache* cache)
+{
+    int req = mp->cache_size + 1;
+    int i, n;
+
+    if (mp->is_pkt_pool) {
+	odp_packet_t pkts[RTE_MEMPOOL_CACHE_MAX_SIZE + 1];
+
+	n = odp_packet_alloc_multi(mp->odp_buffer_pool, mp->odp_buffer_pool_param.pkt.len, pkts, req);
+	for (i = 0; i < n; i++) {
+	    rte_mbuf_t* mbuf = (rte_mbuf_t*)odp_packet_user_area(pkts[i]);
+	    mbuf->odp_pkt = pkts[i];
+	    cache->objs[cache->len++] = mbuf;
+	}
+    } else {
+	odp_buffer_t bufs[RTE_MEMPOOL_CACHE_MAX_SIZE + 1];
+
+	n = odp_buffer_alloc_multi(mp->odp_buffer_pool, bufs, req);
+	for (i = 0; i < n; i++) {
+	    struct trex_odp_buffer_handle* buf_head = (struct trex_odp_buffer_handle*)odp_buffer_addr(bufs[i]);
+	    buf_head->odp_buffer = bufs[i];
+	    cache->objs[cache->len++] = (uint8_t*)buf_head + MEMPOOL_OBJ_HEAD;
+	}
+    }
+
+    return n;
+}
+
+/* give the top n objects of the cache back to the odp pool in one call */
+static void utl_mempool_cache_flush(rte_mempool_t* mp, struct rte_mempool_cache* cache, uint32_t n)
+{
+    uint32_t first = cache->len - n;
+    uint32_t i;
+
+    if (mp->is_pkt_pool) {
+	odp_packet_t pkts[RTE_MEMPOOL_CACHE_MAX_SIZE * 3 / 2];
+
+	for (i = 0; i < n; i++) {
+	    pkts[i] = ((rte_mbuf_t*)cache->objs[first + i])->odp_pkt;
+	}
+	odp_packet_free_multi(pkts, n);
+    } else {
+	odp_buffer_t bufs[RTE_MEMPOOL_CACHE_MAX_SIZE * 3 / 2];
+
+	for (i = 0; i < n; i++) {
+	    struct trex_odp_buffer_handle* head =
+		(struct trex_odp_buffer_handle*)((uint8_t*)cache->objs[first + i] - MEMPOOL_OBJ_HEAD);
+	    utl_buffer_check(head);
+	    bufs[i] = head->odp_buffer;
+	}
+	odp_buffer_free_multi(bufs, n);
+    }
+    cache->len = first;
+}
+
 void utl_rte_mempool_delete(rte_mempool_t* &pool)
 {
     struct trex_odp_buffer_handle* head;
+    uint32_t i;
 
     utl_mempool_check(pool);
+    /* DP threads are gone, empty every thread's cache before the pool goes */
+    for (i = 0; i < ODP_THREAD_COUNT_MAX; i++) {
+	if (pool->local_cache[i].len) {
+	    utl_mempool_cache_flush(pool, &pool->local_cache[i], pool->local_cache[i].len);
+	}
+    }
+    for (i = 0; i < pkt_mempool_num; i++) {
+	if (pkt_mempool_tbl[i] == pool) {
+	    pkt_mempool_tbl[i] = pkt_mempool_tbl[--pkt_mempool_num];
+	    break;
+	}
+    }
     odp_pool_destroy(pool->odp_buffer_pool);
+    odp_shm_free(pool->cache_shm);
     pool->magic = MAGICF;
     head = (struct trex_odp_buffer_handle*)((uint8_t*)pool - ROUND_UP_TREX_ODP_BUFFER_HANDLE(MEMPOOL_ALIGN));
     odp_buffer_free(head->odp_buffer);
     pool = NULL;
 }
 
+/* objects currently held by the application (not in the pool or in a cache)
+ * per thread counters are summed without locking, good enough for stats
+ */
 uint32_t rte_mempool_count(rte_mempool_t* mp)
 {
-    utl_mempool_check(mp);    
-    return odp_atomic_load_u32(&mp->count);
+    int32_t count = 0;
+    uint32_t i;
+
+    utl_mempool_check(mp);
+    for (i = 0; i < ODP_THREAD_COUNT_MAX; i++) {
+	count += mp->local_cache[i].count;
+    }
+    return (uint32_t)count;
 }
 
 int rte_mempool_sc_get(rte_mempool_t* mp, void **obj_p)
 {
-    odp_buffer_t odp_buffer;
-    struct trex_odp_buffer_handle* buf_head;
-    
+    struct rte_mempool_cache* cache;
+
     utl_mempool_check(mp);
-    odp_buffer = odp_buffer_alloc(mp->odp_buffer_pool);
-    if(odp_unlikely(odp_buffer == ODP_BUFFER_INVALID)){
-	printf("%s alloc failed\n", __FUNCTION__);
-	return -1; //keep consistent with dpdk synonymous func
+    cache = utl_mempool_cache(mp);
+    if (odp_unlikely(cache->len == 0)) {
+	if (odp_unlikely(utl_mempool_cache_refill(mp, cache) <= 0)) {
+	    printf("%s alloc failed\n", __FUNCTION__);
+	    return -1; //keep consistent with dpdk synonymous func
+	}
     }
-    
-    buf_head = (struct trex_odp_buffer_handle*)odp_buffer_addr(odp_buffer);
-    buf_head->odp_buffer = odp_buffer;
-    *obj_p = (uint8_t*)buf_head + ROUND_UP_TREX_ODP_BUFFER_HANDLE(mp->odp_buffer_pool_param.buf.align);
-    odp_atomic_inc_u32(&mp->count);
-    
+
+    *obj_p = cache->objs[--cache->len];
+    cache->count++;
+
     return 0;
 }
 
 void rte_mempool_sp_put(rte_mempool_t *mp, void *obj)
 {
-    struct trex_odp_buffer_handle* head;
+    struct rte_mempool_cache* cache = utl_mempool_cache(mp);
 
-    head = (struct trex_odp_buffer_handle*)((uint8_t*)obj - ROUND_UP_TREX_ODP_BUFFER_HANDLE(mp->odp_buffer_pool_param.buf.align));
-    utl_buffer_check(head);
-    
-    odp_buffer_free(head->odp_buffer);
-    odp_atomic_dec_u32(&mp->count);
+    if (mp->is_pkt_pool && mp->cache_size) {
+	/* a cached packet is handed out again without odp_packet_alloc() */
+	odp_packet_reset(((rte_mbuf_t*)obj)->odp_pkt, mp->odp_buffer_pool_param.pkt.len);
+    }
+
+    cache->objs[cache->len++] = obj;
+    cache->count--;
+    if (odp_unlikely(cache->len >= mp->cache_flushthresh)) {
+	utl_mempool_cache_flush(mp, cache, cache->len - mp->cache_size);
+    }
 }
 
 int rte_mempool_get(rte_mempool_t *mp, void **obj_p)
@@ -241,40 +474,39 @@ void rte_mempool_put(rte_mempool_t *mp, void *obj)
 rte_mbuf_t *rte_pktmbuf_alloc(rte_mempool_t *mp)
 {
     rte_mbuf_t* mbuf;
-    uint32_t total_len;
-    uint32_t buf_len;
 
     utl_mempool_check(mp);
+    if(odp_unlikely(mp->mbuf_tmpl.magic != MAGICA)) {
+	if (!mp->is_pkt_pool &&
+	    (mp->odp_buffer_pool_param.buf.size - MEMPOOL_OBJ_HEAD < sizeof(rte_mbuf_t))) {
+	    printf("%s invalid length\n", __FUNCTION__);
+	} else {
+	    printf("%s invalid mbuf template magic\n", __FUNCTION__);
+	}
+	return NULL;
+    }
     if(odp_unlikely(rte_mempool_get(mp, (void**)&mbuf) < 0)){
 	printf("%s alloc failed\n", __FUNCTION__);
 	return NULL;
     }
 
-    total_len = mp->odp_buffer_pool_param.buf.size -
-	ROUND_UP_TREX_ODP_BUFFER_HANDLE(mp->odp_buffer_pool_param.buf.align);
-    if(odp_unlikely(total_len < sizeof(rte_mbuf_t))) {
-	printf("%s invalid length\n", __FUNCTION__);
-	return NULL;
+    /* only the header is reinitialized (one cache line), the data area
+     * is left as is like in dpdk
+     */
+    if (mp->is_pkt_pool) {
+	odp_packet_t pkt = mbuf->odp_pkt;
+	memcpy(mbuf, &mp->mbuf_tmpl, sizeof(rte_mbuf_t));
+	mbuf->odp_pkt = pkt;
+	mbuf->buf_addr = odp_packet_data(pkt);
+    } else {
+	memcpy(mbuf, &mp->mbuf_tmpl, sizeof(rte_mbuf_t));
+	/* start of buffer is just after mbuf structure */
+	mbuf->buf_addr = (uint8_t *)mbuf + sizeof(rte_mbuf_t);
     }
-    memset((uint8_t*)mbuf, 0, total_len);
-    buf_len = total_len - sizeof(rte_mbuf_t);
-
-    mbuf->magic = MAGICA;
-    mbuf->pool = mp;
-    /* start of buffer is just after mbuf structure */
-    mbuf->buf_addr = (uint8_t *)mbuf + sizeof(rte_mbuf_t);
-    mbuf->buf_len = (uint16_t)buf_len;
 
-    /* keep some headroom between start of buffer and data */
-    mbuf->data_off = (RTE_PKTMBUF_HEADROOM <= mbuf->buf_len) ?
-	RTE_PKTMBUF_HEADROOM : mbuf->buf_len;
-    mbuf->data_len = 0;
-    
-    mbuf->next = NULL;
-    mbuf->pkt_len = 0;
-    mbuf->nb_segs = 1;
-    mbuf->in_port = 0xff;
-    odp_atomic_init_u32(&mbuf->refcnt, 1);
+#ifdef _DEBUG
+    memset(mbuf->buf_addr, MBUF_POISON, mbuf->buf_len);
+#endif
 
     return mbuf;
 }
@@ -285,6 +517,11 @@ void rte_pktmbuf_free(rte_mbuf_t *mbuf)
 
     utl_mbuf_check(mbuf);
 
+    /* owned by its creator, see rte_pktmbuf_set_static() */
+    if (rte_pktmbuf_is_static(mbuf)) {
+	return;
+    }
+
     while(mbuf != NULL) {
 	mbuf_next = mbuf->next;
 	rte_pktmbuf_free_seg(mbuf);
@@ -295,9 +532,7 @@ void rte_pktmbuf_free(rte_mbuf_t *mbuf)
 void rte_pktmbuf_detach(rte_mbuf_t *mbuf)
 {
     mbuf->buf_addr = (uint8_t*)mbuf + sizeof(rte_mbuf_t);
-    mbuf->buf_len = (uint16_t)(mbuf->pool->odp_buffer_pool_param.buf.size -
-			       ROUND_UP_TREX_ODP_BUFFER_HANDLE(mbuf->pool->odp_buffer_pool_param.buf.align) -
-			       sizeof(rte_mbuf_t));
+    mbuf->buf_len = mbuf->pool->mbuf_tmpl.buf_len;
 
     mbuf->data_off = (RTE_PKTMBUF_HEADROOM <= mbuf->buf_len) ?
 	RTE_PKTMBUF_HEADROOM : mbuf->buf_len;
@@ -318,7 +553,8 @@ void rte_pktmbuf_free_seg(rte_mbuf_t *mbuf)
     utl_mbuf_check(mbuf);
 
     if(odp_atomic_fetch_dec_u32(&mbuf->refcnt) == 1) {
-	rte_mbuf_t* md = RTE_MBUF_FROM_BADDR(mbuf->buf_addr);
+	/* zero-copy mbufs are never indirect, buf_addr points into the odp packet */
+	rte_mbuf_t* md = mbuf->pool->is_pkt_pool ? mbuf : RTE_MBUF_FROM_BADDR(mbuf->buf_addr);
 
 	/* indirect mbuf
 	 * although trex does not use such 
@@ -541,9 +777,10 @@ uint32_t rte_lcore_to_socket_id(uint32_t lcore_id)
 }
 
 
+/* generator of the calling thread, rand() takes a lock and has 31 bits */
 uint64_t rte_rand(void)
 {
-    return rand();
+    return utl_rand64(utl_rand_thread_state());
 }
 
 /* return 0 for success -1 for failure
@@ -592,14 +829,108 @@ int mbuf_to_odp_packet(rte_mbuf_t* mbuf, odp_packet_t* odp_packet_p)
     return 0;
 }
 
-int mbuf_to_odp_packet_tbl(rte_mbuf**pkts, odp_packet_t* odp_pkts, uint16_t nb_pkts) {
+/* make the odp packet geometry match the mbuf data
+ * idempotent, a burst that was not sent could be handed again
+ * return -1 when the packet has not enough head/tail room for it
+ */
+static inline int utl_odp_packet_sync(rte_mbuf_t* mbuf)
+{
+    odp_packet_t pkt = mbuf->odp_pkt;
+    uint8_t* data = (uint8_t*)odp_packet_data(pkt);
+    uint8_t* mbuf_data = rte_pktmbuf_mtod(mbuf, uint8_t*);
+    void* ret = data;
+    uint32_t len;
+
+    if (mbuf_data > data) {
+	ret = odp_packet_pull_head(pkt, (uint32_t)(mbuf_data - data));
+    } else if (mbuf_data < data) {
+	ret = odp_packet_push_head(pkt, (uint32_t)(data - mbuf_data));
+    }
+    if (odp_unlikely(ret == NULL)) {
+	return -1;
+    }
+
+    len = odp_packet_len(pkt);
+    if (len > mbuf->data_len) {
+	ret = odp_packet_pull_tail(pkt, len - mbuf->data_len);
+    } else if (len < mbuf->data_len) {
+	ret = odp_packet_push_tail(pkt, mbuf->data_len - len);
+    }
+    if (odp_unlikely(ret == NULL)) {
+	return -1;
+    }
+    odp_packet_l2_offset_set(pkt, 0);
+    return 0;
+}
+
+/* return 1 when the mbuf's own odp packet is handed over (zero-copy),
+ * 0 when a copy was stored in *odp_packet_p, -1 for failure
+ */
+static inline int mbuf_to_odp_packet_zc(rte_mbuf_t* mbuf, odp_packet_t* odp_packet_p)
+{
+    odp_packet_t pkt;
+
+    /* chains (prefix + shared const tail) are gathered into a new packet */
+    if (mbuf->odp_pkt == ODP_PACKET_INVALID || mbuf->nb_segs != 1) {
+	return mbuf_to_odp_packet(mbuf, odp_packet_p);
+    }
+
+    /* the packet can't take the mbuf geometry, send a copy of the mbuf data */
+    if (odp_unlikely(utl_odp_packet_sync(mbuf) < 0)) {
+	return mbuf_to_odp_packet(mbuf, odp_packet_p);
+    }
+    if (odp_atomic_load_u32(&mbuf->refcnt) == 1 && !rte_pktmbuf_is_static(mbuf)) {
+	*odp_packet_p = mbuf->odp_pkt;
+	return 1;
+    }
+
+    /* the mbuf is referenced by someone else (NODE_FLAGS_MBUF_CACHE) or static,
+     * the packet can't be given away so send a clone of it. this odp has no
+     * packet references, a static mbuf saves the refcnt but not this copy
+     */
+    pkt = odp_packet_copy(mbuf->odp_pkt, packet_pool_arr[mbuf->pool->socket_id]);
+    if (odp_unlikely(pkt == ODP_PACKET_INVALID)) {
+	printf("%s failed to clone odp packet\n", __FUNCTION__);
+	return -1;
+    }
+    *odp_packet_p = pkt;
+    return 0;
+}
+
+int mbuf_to_odp_packet_tbl(rte_mbuf**pkts, odp_packet_t* odp_pkts, uint8_t* zc, uint16_t nb_pkts) {
     int i=0;
     for (i=0; i<nb_pkts; i++) {
-        mbuf_to_odp_packet(pkts[i], &odp_pkts[i]);        
+	int ret = mbuf_to_odp_packet_zc(pkts[i], &odp_pkts[i]);
+	if (odp_unlikely(ret < 0)) {
+	    break;
+	}
+	zc[i] = (uint8_t)ret;
+	if (ret) {
+	    /* the mbuf goes away with its packet, the pool can't be touched after the send */
+	    utl_mempool_cache(pkts[i]->pool)->count--;
+	}
     } 
     return i;
 }
 
+void mbuf_odp_tx_done_tbl(rte_mbuf**pkts, odp_packet_t* odp_pkts, uint8_t* zc, uint16_t sent, uint16_t nb_pkts) {
+    int i;
+    for (i=0; i<sent; i++) {
+	if (!zc[i]) {
+	    /* odp owns the copy, drop our reference */
+	    rte_pktmbuf_free(pkts[i]);
+	}
+    }
+    for (i=sent; i<nb_pkts; i++) {
+	if (zc[i]) {
+	    /* still ours */
+	    utl_mempool_cache(pkts[i]->pool)->count++;
+	} else {
+	    odp_packet_free(odp_pkts[i]);
+	}
+    }
+}
+
 static void rte_mbuf_sanity_check(const struct rte_mbuf *m, int is_header)
 {
 	const struct rte_mbuf *m_seg;
@@ -647,3 +978,50 @@ odp_pool_t get_odp_packet_pool(int socket_id)
 {
     return packet_pool_arr[socket_id];
 }
+
+static inline rte_mempool_t* utl_rx_mempool(odp_pool_t pool)
+{
+    uint32_t i;
+
+    for (i = 0; i < pkt_mempool_num; i++) {
+	if (odp_likely(pkt_mempool_tbl[i]->odp_buffer_pool == pool)) {
+	    return pkt_mempool_tbl[i];
+	}
+    }
+    return NULL;
+}
+
+/* received packets are seen as mbufs without copy, the header is built
+ * in the packet user area and freeing the mbuf frees the packet
+ * a segmented packet is seen up to its first segment, enough for the
+ * latency/rx-check headers
+ */
+uint16_t odp_packet_to_mbuf_tbl(odp_packet_t* odp_pkts, rte_mbuf_t** pkts, uint16_t nb_pkts, uint8_t in_port)
+{
+    uint16_t i;
+    uint16_t cnt = 0;
+
+    for (i = 0; i < nb_pkts; i++) {
+	odp_packet_t pkt = odp_pkts[i];
+	rte_mempool_t* mp = utl_rx_mempool(odp_packet_pool(pkt));
+	if (odp_unlikely(mp == NULL)) {
+	    /* no room for the mbuf in this packet */
+	    odp_packet_free(pkt);
+	    continue;
+	}
+
+	rte_mbuf_t* mbuf = (rte_mbuf_t*)odp_packet_user_area(pkt);
+	memcpy(mbuf, &mp->mbuf_tmpl, sizeof(rte_mbuf_t));
+	mbuf->odp_pkt = pkt;
+	mbuf->buf_addr = odp_packet_head(pkt);
+	mbuf->data_off = (uint16_t)odp_packet_headroom(pkt);
+	mbuf->data_len = (uint16_t)odp_packet_seg_len(pkt);
+	mbuf->buf_len = mbuf->data_off + mbuf->data_len;
+	mbuf->pkt_len = mbuf->data_len;
+	mbuf->in_port = in_port;
+	utl_mempool_cache(mp)->count++;
+	pkts[cnt++] = mbuf;
+    }
+
+    return cnt;
+}
@@ -34,16 +34,8 @@ limitations under the License.
 #define SOCKET_ID_ANY 0
 #define PKT_TX_VLAN_PKT      (1ULL << 57) /**< TX packet is a 802.1q VLAN packet. */
 
-struct rte_mempool {
-    uint32_t magic;
-    uint32_t socket_id;
-    uint32_t size;
-    odp_atomic_u32_t count; //no odp_pool_count like function
-    char name[MAX_NAME_LEN];
-    odp_pool_param_t odp_buffer_pool_param;
-    odp_pool_t odp_buffer_pool;
-};
-typedef rte_mempool rte_mempool_t;
+struct rte_mempool;
+typedef struct rte_mempool rte_mempool_t;
 
 struct rte_mbuf {
     uint32_t magic;
@@ -59,9 +51,15 @@ struct rte_mbuf {
     uint8_t nb_segs;        /**< Number of segments. */
     uint8_t in_port;        /**< Input port. */
     uint32_t pkt_len;       /**< Total pkt len: sum of all segment data_len. */
+    uint8_t is_static;      /**< Owned by its creator, see rte_pktmbuf_set_static() */
 
     odp_atomic_u32_t refcnt;
 
+    /* owning odp packet when allocated from a zero-copy pool,
+     * ODP_PACKET_INVALID for buffer backed mbufs
+     */
+    odp_packet_t odp_pkt;
+
 #if 0
     /* DPFIXME
      * no hw offload in odp so discard below fields
@@ -88,6 +86,37 @@ struct rte_mbuf {
 };
 typedef struct rte_mbuf rte_mbuf_t;
 
+#define RTE_MEMPOOL_CACHE_MAX_SIZE (512)
+
+/* per odp thread object cache, only the owning thread touches it
+ * objs keeps object pointers (the user area), not odp handles
+ * refill/flush go to the odp pool in bulk
+ */
+struct rte_mempool_cache {
+    uint32_t len;   /* number of objects in objs */
+    int32_t count;  /* objects got minus objects put by this thread, could be negative */
+    void* objs[RTE_MEMPOOL_CACHE_MAX_SIZE * 3 / 2];
+} ODP_ALIGNED_CACHE;
+
+struct rte_mempool {
+    uint32_t magic;
+    uint32_t socket_id;
+    uint32_t size;
+    uint32_t cache_size;        /* objects moved per refill/flush, 0 for no cache */
+    uint32_t cache_flushthresh; /* flush when a local cache reaches this */
+    char name[MAX_NAME_LEN];
+    odp_pool_param_t odp_buffer_pool_param;
+    odp_pool_t odp_buffer_pool;
+    uint8_t is_pkt_pool; /* ODP_POOL_PACKET backed, rte_mbuf lives in the packet user area */
+    odp_shm_t cache_shm;
+    struct rte_mempool_cache* local_cache; /* ODP_THREAD_COUNT_MAX entries, indexed by odp_thread_id() */
+    /* header copied into every mbuf by rte_pktmbuf_alloc(), buf_addr/odp_pkt are per object
+     * magic is not MAGICA when the elements are too small to be mbufs
+     */
+    rte_mbuf_t mbuf_tmpl;
+};
+
+
 void utl_rte_mempool_delete(rte_mempool_t * &pool);
 
 rte_mempool_t * utl_rte_mempool_create(const char  *name,
@@ -151,6 +180,16 @@ unsigned rte_lcore_to_socket_id(unsigned lcore_id);
 
 #define rte_pktmbuf_data_len(m) ((m)->data_len)
 
+/* a static mbuf is owned by its creator (e.g. the cached packet of a stream)
+ * rte_pktmbuf_free() and the tx path don't release it and don't touch its refcnt,
+ * the tx path sends a copy of it. clear the flag before the last free
+ */
+static inline void rte_pktmbuf_set_static(rte_mbuf_t *m, bool enable){
+    m->is_static = enable ? 1 : 0;
+}
+
+#define rte_pktmbuf_is_static(m) ((m)->is_static)
+
 uint64_t rte_rand(void);
 
 
@@ -158,7 +197,26 @@ uint64_t rte_rand(void);
  * store odp_packet_t in *odp_packet_p
  */
 int mbuf_to_odp_packet(rte_mbuf_t* mbuf, odp_packet_t* odp_packet_p);
-int mbuf_to_odp_packet_tbl(rte_mbuf**pkts, odp_packet_t* odp_pkts, uint16_t pkt_nm);
+
+/* convert a burst for odp_pktio_send()
+ * zc[i] is set when the mbuf's own odp packet was handed over (zero-copy),
+ * otherwise odp_pkts[i] is a private copy
+ */
+int mbuf_to_odp_packet_tbl(rte_mbuf**pkts, odp_packet_t* odp_pkts, uint8_t* zc, uint16_t pkt_nm);
+
+/* complete a burst after odp_pktio_send() returned 'sent'
+ * sent mbufs are consumed (dpdk tx_burst semantic), unsent mbufs stay with the caller
+ */
+void mbuf_odp_tx_done_tbl(rte_mbuf**pkts, odp_packet_t* odp_pkts, uint8_t* zc, uint16_t sent, uint16_t pkt_nm);
+
+/* wrap received packets into rte_mbufs, the mbufs live in the packet user area
+ * return the number of mbufs stored in pkts, packets that can't be wrapped are freed
+ */
+uint16_t odp_packet_to_mbuf_tbl(odp_packet_t* odp_pkts, rte_mbuf_t** pkts, uint16_t nb_pkts, uint8_t in_port);
+
+/* back packet mempools created from now on with odp packet pools */
+void pal_set_zero_copy(bool enable);
+bool pal_is_zero_copy(void);
 
 void pal_constructor(void);
 extern void rte_pktmbuf_refcnt_update(struct rte_mbuf *m, int16_t v);
@@ -40,6 +40,11 @@ limitations under the License.
 
 #define PAL_NTOHLL(x)     ((uint64_t)odp_be_to_cpu_64(x))
 
+static inline void rte_pause (void)
+{
+    odp_cpu_pause();
+}
+
 
 #endif
 
@@ -24,6 +24,7 @@ limitations under the License.
 #include <trex_stateless.h>
 #include <trex_stateless_port.h>
 #include <trex_streams_compiler.h>
+#include <trex_stream_rx_stats.h>
 
 #include <iostream>
 
@@ -225,12 +226,19 @@ TrexRpcCmdAddStream::parse_vm_instr_flow_var(const Json::Value &inst, TrexStream
     uint64_t min_value   = parse_uint64(inst, "min_value", result);
     uint64_t max_value   = parse_uint64(inst, "max_value", result);
 
+    /* optional, older clients do not send it */
+    uint64_t step = 1;
+    if (inst.isMember("step")) {
+        step = parse_uint64(inst, "step", result);
+    }
+
     stream->m_vm.add_instruction(new StreamVmInstructionFlowMan(flow_var_name,
                                                                 flow_var_size,
                                                                 op_type,
                                                                 init_value,
                                                                 min_value,
-                                                                max_value));
+                                                                max_value,
+                                                                step));
 }
 
 void 
@@ -286,6 +294,13 @@ TrexRpcCmdAddStream::parse_vm(const Json::Value &vm, TrexStream *stream, Json::V
         }
         stream->m_vm.set_split_instruction(instr);
     }
+
+    /* optional, older clients do not send it */
+    if (vm.isMember("split_mode")) {
+        auto split_modes = {"block", "stride"};
+        std::string split_mode = parse_choice(vm, "split_mode", split_modes, result);
+        stream->m_vm.set_split_mode(split_mode == "stride" ? StreamVm::SPLIT_BY_STRIDE : StreamVm::SPLIT_BY_BLOCK);
+    }
 }
 
 void
@@ -310,6 +325,30 @@ TrexRpcCmdAddStream::validate_stream(const TrexStream *stream, Json::Value &resu
         generate_execute_err(result, ss.str());
     }
 
+    /* the rx signature is written after the L4 header of the packet */
+    if (stream->m_rx_check.m_enable) {
+        std::stringstream ss;
+
+        if (stream->m_rx_check.m_stream_id >= TrexStreamsRxStats::MAX_IDS) {
+            ss << "rx_stats stream_id should be less than " << TrexStreamsRxStats::MAX_IDS;
+        } else if (stream->m_rx_check.m_latency && (stream->m_rx_check.m_stream_id >= TrexStreamsRxStats::MAX_LATENCY_IDS)) {
+            ss << "rx_stats latency is supported for stream_id less than " << TrexStreamsRxStats::MAX_LATENCY_IDS;
+        } else if (stream->m_pkt.len < TrexStreamRxSig::MIN_PKT_SIZE) {
+            ss << "rx_stats requires a packet of at least " << TrexStreamRxSig::MIN_PKT_SIZE << " bytes";
+        } else {
+            uint16_t sig_off;
+            uint16_t csum_off;
+            if (!TrexStreamRxSig::get_offset(stream->m_pkt.binary, stream->m_pkt.len, sig_off, csum_off)) {
+                ss << "rx_stats requires an IPv4/IPv6 UDP or TCP packet with at least " << sizeof(TrexStreamRxSig) << " bytes of L4 payload";
+            }
+        }
+
+        if (!ss.str().empty()) {
+            delete stream;
+            generate_execute_err(result, ss.str());
+        }
+    }
+
 }
 
 /***************************
@@ -520,6 +559,52 @@ TrexRpcCmdGetAllStreams::_run(const Json::Value &params, Json::Value &result) {
     return (TREX_RPC_CMD_OK);
 }
 
+/***************************
+ * get the tx counters of the 
+ * streams of the last run 
+ * on a specific port 
+ * 
+ **************************/
+trex_rpc_cmd_rc_e
+TrexRpcCmdGetStreamStats::_run(const Json::Value &params, Json::Value &result) {
+
+    uint8_t port_id = parse_port(params, result);
+    TrexStatelessPort *port = get_stateless_obj()->get_port_by_id(port_id);
+
+    port->encode_stream_stats(result["result"]["streams"], result["result"]["others"]);
+
+    return (TREX_RPC_CMD_OK);
+}
+
+/***************************
+ * get the rx counters and 
+ * latency of the streams 
+ * with rx_stats, all ports 
+ * 
+ **************************/
+trex_rpc_cmd_rc_e
+TrexRpcCmdGetRxStats::_run(const Json::Value &params, Json::Value &result) {
+
+    get_stateless_obj()->encode_rx_stats(result["result"]);
+
+    return (TREX_RPC_CMD_OK);
+}
+
+/***************************
+ * reset the rx counters and 
+ * latency of the streams 
+ * 
+ **************************/
+trex_rpc_cmd_rc_e
+TrexRpcCmdResetRxStats::_run(const Json::Value &params, Json::Value &result) {
+
+    get_stateless_obj()->reset_rx_stats();
+
+    result["result"] = Json::objectValue;
+
+    return (TREX_RPC_CMD_OK);
+}
+
 /***************************
  * pause traffic
  * 
@@ -105,6 +105,11 @@ TREX_RPC_CMD_DEFINE(TrexRpcCmdGetAllStreams, "get_all_streams", 2, false);
 
 TREX_RPC_CMD_DEFINE(TrexRpcCmdGetStream, "get_stream", 3, false);
 
+TREX_RPC_CMD_DEFINE(TrexRpcCmdGetStreamStats, "get_stream_stats", 1, false);
+
+TREX_RPC_CMD_DEFINE(TrexRpcCmdGetRxStats,   "get_rx_stats",   0, false);
+TREX_RPC_CMD_DEFINE(TrexRpcCmdResetRxStats, "reset_rx_stats", 0, false);
+
 
 
 TREX_RPC_CMD_DEFINE(TrexRpcCmdStartTraffic,  "start_traffic", 3, true);
@@ -51,6 +51,9 @@ TrexRpcCommandsTable::TrexRpcCommandsTable() {
     register_command(new TrexRpcCmdGetStreamList());
     register_command(new TrexRpcCmdGetStream());
     register_command(new TrexRpcCmdGetAllStreams());
+    register_command(new TrexRpcCmdGetStreamStats());
+    register_command(new TrexRpcCmdGetRxStats());
+    register_command(new TrexRpcCmdResetRxStats());
 
     register_command(new TrexRpcCmdStartTraffic());
     register_command(new TrexRpcCmdStopTraffic());
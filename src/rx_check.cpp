@@ -42,7 +42,37 @@ void CRxCheckFlowTableStats::Clear(){
   m_err_oo_early=0;
   m_err_oo_late=0;
   m_err_flow_length_changed=0;
+  m_err_ft_full=0;
+  m_err_queue_full=0;
+  m_ft_size=0;
+  m_ft_probe=0;
+  m_ft_max_probe=0;
+}
 
+void CRxCheckFlowTableStats::Add(const CRxCheckFlowTableStats & o){
+  m_total_rx_bytes+=o.m_total_rx_bytes;
+  m_total_rx+=o.m_total_rx;
+  m_lookup+=o.m_lookup;
+  m_found+=o.m_found;
+  m_fif+=o.m_fif;
+  m_add+=o.m_add;
+  m_remove+=o.m_remove;
+  m_active+=o.m_active;
+  m_err_drop+=o.m_err_drop;
+  m_err_aged+=o.m_err_aged;
+  m_err_no_magic+=o.m_err_no_magic;
+  m_err_wrong_pkt_id+=o.m_err_wrong_pkt_id;
+  m_err_fif_seen_twice+=o.m_err_fif_seen_twice;
+  m_err_open_with_no_fif_pkt+=o.m_err_open_with_no_fif_pkt;
+  m_err_oo_dup+=o.m_err_oo_dup;
+  m_err_oo_early+=o.m_err_oo_early;
+  m_err_oo_late+=o.m_err_oo_late;
+  m_err_flow_length_changed+=o.m_err_flow_length_changed;
+  m_err_ft_full+=o.m_err_ft_full;
+  m_err_queue_full+=o.m_err_queue_full;
+  m_ft_size+=o.m_ft_size;
+  m_ft_probe+=o.m_ft_probe;
+  m_ft_max_probe=std::max(m_ft_max_probe,o.m_ft_max_probe);
 }
 
 #define MYDP(f) if (f)  fprintf(fd," %-40s: %llu \n",#f,(unsigned long long)f)
@@ -72,6 +102,17 @@ void CRxCheckFlowTableStats::Dump(FILE *fd){
 	MYDP (m_err_oo_early);
 	MYDP (m_err_oo_late);
     MYDP (m_err_flow_length_changed);
+    MYDP (m_err_ft_full);
+    MYDP (m_err_queue_full);
+    MYDP_A (m_ft_size);
+    MYDP (m_ft_probe);
+    MYDP (m_ft_max_probe);
+    if (m_ft_size) {
+        fprintf(fd," %-40s: %.1f %% \n","flow table occupancy",(double)m_active*100.0/(double)m_ft_size);
+    }
+    if (m_lookup) {
+        fprintf(fd," %-40s: %.2f \n","flow table avg probe",(double)m_ft_probe/(double)m_lookup);
+    }
 }
 
 void CRxCheckFlowTableStats::dump_json(std::string & json){
@@ -95,6 +136,13 @@ void CRxCheckFlowTableStats::dump_json(std::string & json){
     MYDP_J (m_err_oo_dup);
     MYDP_J (m_err_oo_early);
     MYDP_J (m_err_oo_late);
+    MYDP_J (m_err_ft_full);
+    MYDP_J (m_err_queue_full);
+    MYDP_J (m_ft_size);
+    MYDP_J (m_ft_probe);
+    MYDP_J (m_ft_max_probe);
+    uint64_t m_ft_occupancy = m_ft_size ? (m_active*100/m_ft_size) : 0; /* percent */
+    MYDP_J (m_ft_occupancy);
 
     /* must be last */
     MYDP_J_LAST (m_err_flow_length_changed);
@@ -168,6 +216,145 @@ uint64_t CRxCheckFlowTableMap::count(){
 }
 
 
+bool CRxCheckFlowTableHash::Create(uint32_t max_size,
+                                   CRxCheckFlowTableStats * stats){
+    Delete();
+    /* keep the load of the buckets under 80% */
+    uint32_t need = ((uint64_t)max_size*5/4 + BUCKET_ENTRIES-1)/BUCKET_ENTRIES;
+    uint32_t nb=1;
+    while (nb < need) {
+        nb <<= 1;
+    }
+    void * p;
+    if ( posix_memalign(&p,64,sizeof(CBucket)*nb) !=0 ){
+        return (false);
+    }
+    m_buckets = (CBucket *)p;
+    memset(m_buckets,0,sizeof(CBucket)*nb);
+    m_flows   = new CRxCheckFlow[nb*BUCKET_ENTRIES];
+    m_mask    = nb-1;
+    m_max_size= max_size;
+    m_count   = 0;
+    m_stats   = stats;
+    m_stats->m_ft_size = max_size;
+    return (true);
+}
+
+void CRxCheckFlowTableHash::Delete(){
+    if (m_buckets) {
+        free(m_buckets);
+        m_buckets=0;
+    }
+    if (m_flows) {
+        delete [] m_flows;
+        m_flows=0;
+    }
+    m_count=0;
+}
+
+bool CRxCheckFlowTableHash::find(uint64_t fid,
+                                 uint32_t & bucket,
+                                 int & entry,
+                                 uint32_t & probes){
+    uint32_t b=home_bucket(fid);
+    probes=0;
+    while ( true ) {
+        CBucket * lpb=&m_buckets[b];
+        probes++;
+        uint32_t used=lpb->m_used;
+        while ( used ) {
+            int i=__builtin_ctz(used);
+            if ( lpb->m_key[i] == fid ) {
+                bucket=b;
+                entry=i;
+                return (true);
+            }
+            used &= used-1;
+        }
+        if ( (lpb->m_passed==0) || (probes > m_mask) ) {
+            return (false);
+        }
+        b=(b+1) & m_mask;
+    }
+}
+
+CRxCheckFlow * CRxCheckFlowTableHash::lookup(uint64_t fid){
+    uint32_t bucket;
+    int      entry;
+    uint32_t probes;
+    bool     res=find(fid,bucket,entry,probes);
+
+    m_stats->m_ft_probe += probes;
+    if ( probes > m_stats->m_ft_max_probe ) {
+        m_stats->m_ft_max_probe = probes;
+    }
+    if ( res ) {
+        return (get_flow(bucket,entry));
+    }
+    return ((CRxCheckFlow *)0);
+}
+
+CRxCheckFlow * CRxCheckFlowTableHash::add(uint64_t fid){
+    if ( m_count >= m_max_size ) {
+        m_stats->m_err_ft_full++;
+        return ((CRxCheckFlow *)0);
+    }
+    uint32_t b=home_bucket(fid);
+    while ( m_buckets[b].m_used == BUCKET_FULL ) {
+        m_buckets[b].m_passed++;
+        b=(b+1) & m_mask;
+    }
+    CBucket * lpb=&m_buckets[b];
+    int i=__builtin_ctz(~lpb->m_used);
+    lpb->m_key[i]=fid;
+    lpb->m_used |= (1<<i);
+    m_count++;
+
+    CRxCheckFlow * lp=get_flow(b,i);
+    lp->reset(fid);
+    return (lp);
+}
+
+bool CRxCheckFlowTableHash::remove(uint64_t fid){
+    uint32_t bucket;
+    int      entry;
+    uint32_t probes;
+    if ( !find(fid,bucket,entry,probes) ) {
+        return (false);
+    }
+    m_buckets[bucket].m_used &= ~(1<<entry);
+    m_count--;
+
+    /* the buckets it was added after */
+    uint32_t b=home_bucket(fid);
+    while ( b != bucket ) {
+        assert(m_buckets[b].m_passed>0);
+        m_buckets[b].m_passed--;
+        b=(b+1) & m_mask;
+    }
+    return (true);
+}
+
+void CRxCheckFlowTableHash::remove_all(){
+    if (m_buckets) {
+        memset(m_buckets,0,sizeof(CBucket)*(m_mask+1));
+    }
+    m_count=0;
+}
+
+void CRxCheckFlowTableHash::dump_all(FILE *fd){
+    uint32_t b;
+    int i;
+    for (b=0; b<=m_mask; b++) {
+        for (i=0; i<BUCKET_ENTRIES; i++) {
+            if ( m_buckets[b].m_used & (1<<i) ) {
+                fprintf (fd,"flow_id: %llu \n",(unsigned long long)get_flow(b,i)->m_flow_id);
+            }
+        }
+    }
+}
+
+
 #ifdef FT_TEST
 
 void test_flowtable (){
@@ -237,9 +424,15 @@ void CPerTxthreadTemplateInfo::Dump(FILE *fd){
 }
 
 
-bool RxCheckManager::Create(){
-    m_ft.Create(100000);
+bool RxCheckManager::Create(uint32_t max_flows){
+    if ( m_ft.count() ){
+        /* the aging timers are linked into the flows */
+        tw_drain();
+    }
     m_stats.Clear();
+    if ( !m_ft.Create(max_flows,&m_stats) ){
+        return (false);
+    }
     m_hist.Create();
 	m_cur_time=0.00000001;
     m_on_drain=false;
@@ -288,7 +481,11 @@ void RxCheckManager::handle_packet(CRx_check_header * rxh){
         if (lf==0) {
             /* valid , this is FIF we don't expect flows */
             lf=m_ft.add(rxh->m_flow_id);
-            assert(lf);
+            if ( lf==0 ) {
+                /* flow table is full */
+                update_template_err(rxh->m_template_id);
+                return;
+            }
             lf->m_aging_timer_handle.m_object1=this;
 
             lf->m_flow_id=rxh->m_flow_id;
@@ -324,7 +521,11 @@ void RxCheckManager::handle_packet(CRx_check_header * rxh){
             /* no flow at it is not the first packet */
             /* the first packet was dropped ?? */
             lf=m_ft.add(rxh->m_flow_id);
-            assert(lf);
+            if ( lf==0 ) {
+                /* flow table is full */
+                update_template_err(rxh->m_template_id);
+                return;
+            }
             lf->m_aging_timer_handle.m_object1=this;
             if (rxh->get_both_dir()) {
                 lf->set_both_dir();
@@ -399,6 +600,44 @@ void RxCheckManager::handle_packet(CRx_check_header * rxh){
     }
 }
 
+void RxCheckManager::create_stats(){
+    m_stats.Clear();
+    m_hist.Create();
+    m_cur_time=0.00000001;
+    m_on_drain=false;
+    clear_stats();
+}
+
+void RxCheckManager::clear_stats(){
+    m_stats.Clear();
+    m_hist.clear_samples();
+    int i;
+    for (i=0; i<MAX_TEMPLATES_STATS;i++ ) {
+        m_template_info[i].reset();
+    }
+    m_tw.m_st_alloc=0;
+    m_tw.m_st_free=0;
+    m_tw.m_st_start=0;
+    m_tw.m_st_stop=0;
+    m_tw.m_st_handle=0;
+    m_tw.m_st_cascade=0;
+}
+
+void RxCheckManager::add_stats(RxCheckManager * o){
+    m_stats.Add(o->m_stats);
+    m_hist.merge(o->m_hist);
+    int i;
+    for (i=0; i<MAX_TEMPLATES_STATS;i++ ) {
+        m_template_info[i].add(o->m_template_info[i]);
+    }
+    m_tw.m_st_alloc   += o->m_tw.m_st_alloc;
+    m_tw.m_st_free    += o->m_tw.m_st_free;
+    m_tw.m_st_start   += o->m_tw.m_st_start;
+    m_tw.m_st_stop    += o->m_tw.m_st_stop;
+    m_tw.m_st_handle  += o->m_tw.m_st_handle;
+    m_tw.m_st_cascade += o->m_tw.m_st_cascade;
+}
+
 void RxCheckManager::update_template_err(uint8_t template_id){
     get_template(template_id)->inc_error_counter();
 }
@@ -425,6 +664,8 @@ bool RxCheckManager::on_flow_end(CRxCheckFlow * lp){
 
 
 void RxCheckManager::Delete(){
+    /* the aging timers are linked into the flows */
+    tw_drain();
     m_ft.Delete();
     m_hist.Delete();
 }
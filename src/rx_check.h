@@ -94,6 +94,14 @@ public:
     uint16_t            m_oo_err; /* out of order issue */
     uint16_t            m_flags;
 public:
+    /* reuse of a table entry, the timer handle is kept */
+    void reset(uint64_t fid){
+        m_flow_id=fid;
+        m_dir[0]=CRxCheckFlowPerDir();
+        m_dir[1]=CRxCheckFlowPerDir();
+        m_oo_err=0;
+        m_flags=0;
+    }
 
     uint16_t  get_total_pkt_seen(void){
         return (m_dir[0].m_pkts+
@@ -170,6 +178,13 @@ public:
 	uint64_t  m_err_oo_late;  /* early packet ,expect 7 got 6 */
 
     uint64_t  m_err_flow_length_changed;  /* early packet ,expect 7 got 6 */
+    uint64_t  m_err_ft_full;  /* flow table is full, flow is not checked */
+    uint64_t  m_err_queue_full; /* ring to the RX core of the flow is full, packet is not checked */
+
+    /* flow table */
+    uint64_t  m_ft_size;      /* max flows */
+    uint64_t  m_ft_probe;     /* buckets read by lookups */
+    uint64_t  m_ft_max_probe;
 
     uint64_t get_total_err(void){
         return (m_err_drop+m_err_aged+
@@ -179,12 +194,15 @@ public:
                     m_err_open_with_no_fif_pkt+
                     m_err_oo_dup+
                     m_err_oo_early+
-                    m_err_oo_late+m_err_flow_length_changed);
+                    m_err_oo_late+m_err_flow_length_changed+
+                    m_err_ft_full+m_err_queue_full);
 
     }
 
 public:
     void Clear();
+    /* sum of the RX cores, the max probe is the max */
+    void Add(const CRxCheckFlowTableStats & o);
     void Dump(FILE *fd);
     void dump_json(std::string & json);
 };
@@ -212,86 +230,73 @@ public:
 
 
 
-class uint64_tHashEnv
-{
-public:
-	static uint32_t Hash(uint64_t x)
-	{
-		return ( (x >>40) ^ (x & 0xffffffff));
-	}
-};
+/* default size of the rx-check flow table, --rx-check-flows */
+#define RX_CHECK_MAX_FLOWS_DEF  (256*1024)
 
-template<class T>
-class CMyFSA {
+/**
+ * fixed size open addressing flow table, the flows are kept inline and
+ * never move ( the aging timer handle is linked into the timer wheel ).
+ *
+ * a bucket is a cache line with the keys of 7 flows, lookup checks the
+ * keys of the home bucket and moves to the next one only when some flow
+ * was added past it ( m_passed ), so a remove does not leave tombstones
+ */
+class CRxCheckFlowTableHash   {
 public:
-	bool Create(uint32_t size, bool supportGetNext, bool ctorRequired){
-		return(true);
-	}
-
-    void Delete(){
-	}
-	void Reset(){
-	}
-
-	T * GetNewItem(){
-		return (new T());
-	}
-
-	void ReturnItem(T *obj){
-		delete obj;
-	}
-};
-
-
-
-#if 0
+    enum {
+        BUCKET_ENTRIES = 7,
+        BUCKET_FULL    = ((1 << BUCKET_ENTRIES) - 1)
+    };
+
+    CRxCheckFlowTableHash(){
+        m_buckets=0;
+        m_flows=0;
+        m_mask=0;
+        m_max_size=0;
+        m_count=0;
+        m_stats=0;
+    }
 
-typedef CHashEntry<uint64_t,CRxCheckFlow> rx_c_hash_ent_t;
-typedef CCloseHash<uint64_t,CRxCheckFlow,uint64_tHashEnv,CMyFSA<rx_c_hash_ent_t> > rx_c_hash_t;
+    bool Create(uint32_t max_size,CRxCheckFlowTableStats * stats);
+    void Delete();
+    bool remove(uint64_t fid );
+    CRxCheckFlow * lookup(uint64_t fid );
+    /* NULL in case the table is full */
+    CRxCheckFlow * add(uint64_t fid );
+    void remove_all(void);
+    void dump_all(FILE *fd);
+    uint64_t count(void){
+        return (m_count);
+    }
 
+private:
+    struct CBucket {
+        uint64_t    m_key[BUCKET_ENTRIES];
+        uint8_t     m_used;   /* bit per entry */
+        uint8_t     m_pad;
+        uint16_t    m_passed; /* flows that were added after this bucket */
+        uint32_t    m_pad1;
+    };
+
+    inline uint32_t home_bucket(uint64_t fid){
+        return ( (uint32_t)((fid * 0x9E3779B97F4A7C15ULL) >> 32) & m_mask );
+    }
 
-class CRxCheckFlowTableHash   {
-public:
-    bool Create(int max_size){
-		return ( m_hash.Create(max_size,0,false,false,true) );
-	}
-    void Delete(){
-		m_hash.Delete();
-	}
-    bool remove(uint64_t fid ) {
-		return(m_hash.Remove(fid)==hsOK?true:false);
-	}
-    CRxCheckFlow * lookup(uint64_t fid ){
-		rx_c_hash_ent_t *lp=m_hash.Find(fid);
-		if (lp) {
-			return (&lp->value);
-		}else{
-			return ((CRxCheckFlow *)NULL);
-		}
-	}
-    CRxCheckFlow * add(uint64_t fid ){
-		rx_c_hash_ent_t *lp;
-		assert(m_hash.Insert(fid,lp)==hsOK);
-		return (&lp->value);
-	}
-
-    void remove_all(void){
-		
-	}
-    void dump_all(FILE *fd){
-		m_hash.Dump(fd);
-	}
-    uint64_t count(void){
-		return ( m_hash.GetSize());
+    inline CRxCheckFlow * get_flow(uint32_t bucket,int entry){
+        return (&m_flows[bucket*BUCKET_ENTRIES+entry]);
+    }
 
-	}
-public:
+    bool find(uint64_t fid,uint32_t & bucket,int & entry,uint32_t & probes);
 
-	rx_c_hash_t                  m_hash;
+private:
+    CBucket *                    m_buckets;
+    CRxCheckFlow *               m_flows;
+    uint32_t                     m_mask;
+    uint32_t                     m_max_size;
+    uint64_t                     m_count;
+    CRxCheckFlowTableStats *     m_stats;
 };
 
-#endif
-
 
 // must be 2^
 #define MAX_TEMPLATES_STATS 32
@@ -361,6 +366,15 @@ public:
         return (m_rx_pkts);
     }
 
+    /* sum of the RX cores, the jitter is the one of the worst core */
+    void add(CPerTemplateInfo & o){
+        m_rx_pkts+=o.m_rx_pkts;
+        m_errors+=o.m_errors;
+        if ( o.m_jitter.get_jitter() > m_jitter.get_jitter() ){
+            m_jitter=o.m_jitter;
+        }
+    }
+
 
 private:
     uint64_t m_rx_pkts;
@@ -371,7 +385,7 @@ private:
 class RxCheckManager {
 
 public:
-    bool Create();
+    bool Create(uint32_t max_flows=RX_CHECK_MAX_FLOWS_DEF);
     void Delete();
     void handle_packet(CRx_check_header * rxh);
 	void Dump(FILE *fd);
@@ -392,6 +406,12 @@ public:
 
     void dump_json(std::string & json );
 
+    /* a manager that only holds the stats of the RX cores ( CP side ),
+       the flow table is not created */
+    void create_stats();
+    void clear_stats();
+    void add_stats(RxCheckManager * o);
+
 protected:
     void update_template_err(uint8_t template_id);
 
@@ -410,7 +430,7 @@ protected:
 public:
     
     CTimerWheel                     m_tw;
-    CRxCheckFlowTableMap           m_ft;
+    CRxCheckFlowTableHash          m_ft;
     CRxCheckFlowTableStats         m_stats;
 
     CTimeHistogram                 m_hist;
@@ -20,13 +20,70 @@ limitations under the License.
 */
 #include <trex_stateless.h>
 #include <trex_stateless_port.h>
+#include <trex_stream_rx_stats.h>
 
+#include <algorithm>
 #include <sched.h>
 #include <iostream>
 #include <unistd.h>
 
 using namespace std;
 
+/**
+ * rx_stats of all the DP cores that read RX, each core has the 
+ * packets of its own ports. the latency histograms are merged, the 
+ * jitter is the worst one 
+ */
+class TrexStreamsRxSum {
+public:
+    TrexStreamsRxSum() : m_cnt(TrexStreamsRxStats::MAX_IDS),
+                         m_lat(TrexStreamsRxStats::MAX_LATENCY_IDS),
+                         m_jitter(TrexStreamsRxStats::MAX_LATENCY_IDS) {
+        for (auto &h : m_lat) {
+            h.Reset();
+        }
+        memset(&m_cnt[0], 0, sizeof(TrexStreamRxCounters) * m_cnt.size());
+        m_no_sig = 0;
+    }
+
+    void collect(const TrexPlatformApi *api) {
+        for (uint8_t core_id = 0; core_id < api->get_dp_core_count(); core_id++) {
+            const TrexStreamsRxStats *rx_stats = api->get_stream_rx_stats(core_id);
+            if (rx_stats == NULL) {
+                continue;
+            }
+
+            for (int i = 0; i < TrexStreamsRxStats::MAX_IDS; i++) {
+                TrexStreamRxCounters c;
+                rx_stats->get_counters(i, c);
+                m_cnt[i].Add(c);
+            }
+
+            for (int i = 0; i < TrexStreamsRxStats::MAX_LATENCY_IDS; i++) {
+                m_lat[i].Merge(rx_stats->get_latency(i));
+                m_jitter[i] = std::max(m_jitter[i], rx_stats->get_jitter_nsec(i));
+            }
+            m_no_sig += rx_stats->get_no_sig();
+        }
+    }
+
+    void sub(const TrexStreamsRxSum &base) {
+        for (int i = 0; i < TrexStreamsRxStats::MAX_IDS; i++) {
+            m_cnt[i].Sub(base.m_cnt[i]);
+        }
+        for (int i = 0; i < TrexStreamsRxStats::MAX_LATENCY_IDS; i++) {
+            CHdrHistogram total = m_lat[i];
+            m_lat[i].Sub(total, base.m_lat[i]);
+        }
+        m_no_sig -= base.m_no_sig;
+    }
+
+    std::vector<TrexStreamRxCounters> m_cnt;
+    std::vector<CHdrHistogram>        m_lat;    /* nsec */
+    std::vector<uint32_t>             m_jitter; /* nsec */
+    uint64_t                          m_no_sig;
+};
+
 /***********************************************************
  * Trex stateless object
  * 
@@ -52,6 +109,7 @@ TrexStateless::TrexStateless(const TrexStatelessCfg &cfg) {
 
     m_platform_api = cfg.m_platform_api;
     m_publisher    = cfg.m_publisher;
+    m_rx_base      = NULL;
 
 }
 
@@ -76,6 +134,9 @@ TrexStateless::~TrexStateless() {
 
     delete m_platform_api;
     m_platform_api = NULL;
+
+    delete m_rx_base;
+    m_rx_base = NULL;
 }
 
 
@@ -157,6 +218,71 @@ TrexStateless::encode_stats(Json::Value &global) {
     }
 }
 
+void
+TrexStateless::encode_rx_stats(Json::Value &rx_stats) {
+
+    TrexStreamsRxSum total;
+    total.collect(m_platform_api);
+    if (m_rx_base) {
+        total.sub(*m_rx_base);
+    }
+
+    rx_stats["no_sig"] = Json::Value::UInt64(total.m_no_sig);
+
+    Json::Value &streams = rx_stats["streams"];
+    streams = Json::objectValue;
+
+    for (int i = 0; i < TrexStreamsRxStats::MAX_IDS; i++) {
+        const TrexStreamRxCounters &c = total.m_cnt[i];
+        if (c.m_pkts == 0) {
+            continue;
+        }
+
+        std::stringstream ss;
+        ss << i;
+
+        Json::Value &stream = streams[ss.str()];
+        stream["rx_pkts"]  = Json::Value::UInt64(c.m_pkts);
+        stream["rx_bytes"] = Json::Value::UInt64(c.m_bytes);
+        stream["seq_drop"] = Json::Value::UInt64(c.m_seq_drop);
+        stream["seq_ooo"]  = Json::Value::UInt64(c.m_seq_ooo);
+        stream["seq_dup"]  = Json::Value::UInt64(c.m_seq_dup);
+
+        if ( (i >= TrexStreamsRxStats::MAX_LATENCY_IDS) || (total.m_lat[i].get_cnt() == 0) ) {
+            continue;
+        }
+
+        const CHdrHistogram &h = total.m_lat[i];
+        Json::Value &lat = stream["latency"];
+        lat["cnt"]         = Json::Value::UInt64(h.get_cnt());
+        lat["avg_usec"]    = h.get_mean() / 1000.0;
+        lat["min_usec"]    = (double)h.get_min() / 1000.0;
+        lat["max_usec"]    = (double)h.get_max() / 1000.0;
+        lat["jitter_usec"] = (double)total.m_jitter[i] / 1000.0;
+
+        Json::Value &percentiles = lat["percentiles_usec"];
+        percentiles["50"]    = (double)h.get_percentile(50.0) / 1000.0;
+        percentiles["90"]    = (double)h.get_percentile(90.0) / 1000.0;
+        percentiles["99"]    = (double)h.get_percentile(99.0) / 1000.0;
+        percentiles["99.9"]  = (double)h.get_percentile(99.9) / 1000.0;
+        percentiles["99.99"] = (double)h.get_percentile(99.99) / 1000.0;
+    }
+}
+
+/**
+ * the DP cores own the counters, a reset keeps the current values 
+ * and the next reads are relative to them 
+ */
+void
+TrexStateless::reset_rx_stats() {
+    if (m_rx_base == NULL) {
+        m_rx_base = new TrexStreamsRxSum();
+    }else{
+        *m_rx_base = TrexStreamsRxSum();
+    }
+    m_rx_base->collect(m_platform_api);
+}
+
 /**
  * generate a snapshot for publish (async publish)
  * 
@@ -170,7 +296,20 @@ TrexStateless::generate_publish_snapshot(std::string &snapshot) {
     root["type"] = 0;
 
     /* stateless specific info goes here */
-    root["data"] = Json::nullValue;
+    root["data"] = Json::objectValue;
+
+    /* the RPC thread changes the ports streams */
+    std::unique_lock<std::mutex> lock(m_global_cp_lock);
+
+    for (uint8_t i = 0; i < m_port_count; i++) {
+        std::stringstream ss;
+
+        ss << "port " << i;
+        Json::Value &port = root["data"][ss.str()];
+        m_ports[i]->encode_stream_stats(port["streams"], port["others"]);
+    }
+
+    lock.unlock();
 
     snapshot = writer.write(root);
 }
@@ -49,6 +49,7 @@ public:
 };
 
 class TrexStatelessPort;
+class TrexStreamsRxSum;
 
 /**
  * unified stats
@@ -144,6 +145,13 @@ public:
      */
     void               encode_stats(Json::Value &global);
 
+    /**
+     * rx_stats of the streams ( by rx_stats stream_id ) summed 
+     * over the DP cores that read RX, since the last reset
+     */
+    void               encode_rx_stats(Json::Value &rx_stats);
+    void               reset_rx_stats();
+
     /**
      * generate a snapshot for publish
      */
@@ -179,6 +187,9 @@ protected:
 
     TrexPublisher                        *m_publisher;
 
+    /* rx_stats at the last reset, NULL before the first one */
+    TrexStreamsRxSum                     *m_rx_base;
+
     std::mutex m_global_cp_lock;
 };
 
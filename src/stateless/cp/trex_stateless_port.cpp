@@ -23,8 +23,11 @@ limitations under the License.
 #include <trex_stateless_port.h>
 #include <trex_stateless_messaging.h>
 #include <trex_streams_compiler.h>
+#include <trex_stream_tx_stats.h>
 
 #include <string>
+#include <sstream>
+#include <algorithm>
 
 #ifndef TREX_RPC_MOCK_SERVER
 
@@ -72,6 +75,7 @@ TrexStatelessPort::TrexStatelessPort(uint8_t port_id, const TrexPlatformApi *api
     m_dp_events.create(this);
 
     m_graph_obj = NULL;
+    m_stats_event_id = -1;
 }
 
 
@@ -164,6 +168,15 @@ TrexStatelessPort::start_traffic(const TrexPortMultiplier &mul, double duration)
     /* mark that DP event of stoppped is possible */
     m_dp_events.wait_for_event(TrexDpPortEvent::EVENT_STOP, event_id);
 
+    /* the compiler gives the enabled streams compressed ids by their order */
+    m_dp_stream_ids.clear();
+    for (auto stream : streams) {
+        if (stream->m_enabled) {
+            m_dp_stream_ids.push_back(stream->m_stream_id);
+        }
+    }
+    m_stats_event_id = event_id;
+
 
     /* update object status */
     m_factor = factor;
@@ -378,6 +391,48 @@ TrexStatelessPort::encode_stats(Json::Value &port) {
     port["tx_rx_errors"]    = Json::Value::UInt64(stats.m_stats.m_tx_rx_errors);
 }
 
+void
+TrexStatelessPort::encode_stream_stats(Json::Value &streams, Json::Value &others) {
+
+    const TrexPlatformApi *api = get_stateless_obj()->get_platform_api();
+
+    int count = std::min((int)m_dp_stream_ids.size(), (int)TrexStreamsTxStats::MAX_STREAMS);
+    std::vector<TrexStreamTxCounters> total(count);
+    std::vector<TrexStreamTxCounters> core;
+    TrexStreamTxCounters total_others = {0, 0};
+    TrexStreamTxCounters core_others;
+
+    /* the ports of a DP core are 2 * dual port id and the next one */
+    uint8_t local_port = m_port_id % TrexStreamsTxStats::NUM_PORTS;
+
+    for (auto core_id : m_cores_id_list) {
+        const TrexStreamsTxStats *tx_stats = api->get_stream_tx_stats(core_id);
+        if ( (tx_stats == NULL) || !tx_stats->snapshot(local_port, m_stats_event_id, core, core_others) ) {
+            continue;
+        }
+        for (int i = 0; i < (int)core.size() && i < (int)total.size(); i++) {
+            total[i].m_pkts  += core[i].m_pkts;
+            total[i].m_bytes += core[i].m_bytes;
+        }
+        total_others.m_pkts  += core_others.m_pkts;
+        total_others.m_bytes += core_others.m_bytes;
+    }
+
+    streams = Json::objectValue;
+    for (int i = 0; i < count; i++) {
+        std::stringstream ss;
+        ss << m_dp_stream_ids[i];
+
+        Json::Value &stream = streams[ss.str()];
+        stream["tx_pkts"]  = Json::Value::UInt64(total[i].m_pkts);
+        stream["tx_bytes"] = Json::Value::UInt64(total[i].m_bytes);
+    }
+
+    others["streams"]  = Json::Value::UInt((unsigned int)(m_dp_stream_ids.size() - count));
+    others["tx_pkts"]  = Json::Value::UInt64(total_others.m_pkts);
+    others["tx_bytes"] = Json::Value::UInt64(total_others.m_bytes);
+}
+
 void 
 TrexStatelessPort::send_message_to_all_dp(TrexStatelessCpToDpMsgBase *msg) {
 
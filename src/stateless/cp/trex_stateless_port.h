@@ -217,6 +217,14 @@ public:
      */
     void encode_stats(Json::Value &port);
 
+    /**
+     * encode the tx counters of the streams of the last run, 
+     * summed over the DP cores, as JSON keyed by stream id.
+     * the streams past TrexStreamsTxStats::MAX_STREAMS are counted
+     * together in others
+     */
+    void encode_stream_stats(Json::Value &streams, Json::Value &others);
+
     uint8_t get_port_id() {
         return m_port_id;
     }
@@ -373,6 +381,10 @@ private:
 
     /* owner information */
     TrexPortOwner       m_owner;
+
+    /* the stream id of each compressed DP stream id of the last run */
+    std::vector<uint32_t> m_dp_stream_ids;
+    int                   m_stats_event_id;
 };
 
 
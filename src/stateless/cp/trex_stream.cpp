@@ -62,7 +62,7 @@ TrexStream::vm_compile() {
     }
 
     /* compile */
-    m_vm.compile(m_pkt.len);
+    m_vm.compile(m_pkt.len,m_pkt.binary);
 
     /* create DP object */
     m_vm_dp = m_vm.generate_dp_object();
@@ -71,6 +71,18 @@ void StreamVmInstructionFlowMan::sanity_check_valid_opt(uint32_t ins_id,StreamVm
 
 void StreamVmInstructionFlowMan::sanity_check_valid_range(uint32_t ins_id,StreamVm *lp){
     //TBD check that init,min,max in valid range 
+
+    if ( m_step == 0 ) {
+        std::stringstream ss;
+        ss << "instruction id '" << ins_id << "' flow var step must be positive";
+        lp->err(ss.str());
+    }
+
+    if ( (m_step > 1) && ((m_init_value < m_min_value) || ((m_init_value - m_min_value) % m_step) != 0) ) {
+        std::stringstream ss;
+        ss << "instruction id '" << ins_id << "' init value " << m_init_value << " is not min value plus a multiple of the step " << m_step;
+        lp->err(ss.str());
+    }
 }
 
 
@@ -102,7 +114,7 @@ void StreamVmInstructionFlowMan::Dump(FILE *fd){
         break;
     };
 
-    fprintf(fd," (%lu:%lu:%lu) \n",m_init_value,m_min_value,m_max_value);
+    fprintf(fd," (%lu:%lu:%lu) step:%lu \n",m_init_value,m_min_value,m_max_value,m_step);
 }
 
 
@@ -117,7 +129,7 @@ void StreamVmInstructionFlowClient::Dump(FILE *fd){
 
     fprintf(fd," client_var ,%s , ",m_var_name.c_str());
 
-    fprintf(fd," ip:(%x-%x) port:(%x-%x)  flow_limit:%lu  flags: %x\n",m_client_min,m_client_max, m_port_min,m_port_max,(ulong)m_limit_num_flows,m_flags);
+    fprintf(fd," ip:(%x-%x) port:(%x-%x)  flow_limit:%lu  flags: %x ip_step: %u\n",m_client_min,m_client_max, m_port_min,m_port_max,(ulong)m_limit_num_flows,m_flags,(uint32_t)m_ip_step);
 }
 
 
@@ -203,15 +215,15 @@ void StreamVm::build_flow_var_table() {
         }
     }
 
-    /* if we found allocate BSS +4 bytes */
+    /* if we found allocate BSS +8 bytes for the random state */
     if ( m_is_random_var ){
         VmFlowVarRec var;
 
         var.m_offset = m_cur_var_offset;
         var.m_ins.m_ins_flowv = NULL;
-        var.m_size_bytes = sizeof(uint32_t);
+        var.m_size_bytes = sizeof(uint64_t);
         var_add("___random___",var);
-        m_cur_var_offset += sizeof(uint32_t);
+        m_cur_var_offset += sizeof(uint64_t);
     }
 
     for (auto inst : m_inst_list) {
@@ -323,6 +335,251 @@ void StreamVm::free_bss(){
 }
 
 
+static bool vm_overlap(uint32_t a,uint32_t a_end,uint32_t b,uint32_t b_end){
+    return ( (a < b_end) && (b < a_end) );
+}
+
+/* parse the ipv4 header of a fix in the stream packet, it is valid only 
+   when the checksums of the packet are valid, otherwise the fix repairs them */
+static void vm_parse_cs_header(const uint8_t * pkt,
+                               uint16_t pkt_size,
+                               StreamVmCsHeader & h){
+    if ( (pkt == NULL) || (h.m_offset + IPV4_HDR_LEN > pkt_size) ) {
+        return;
+    }
+    uint8_t * ip  = (uint8_t *)pkt + h.m_offset;
+    uint16_t  len = (ip[0] & 0xf) * 4;
+
+    if ( ((ip[0] >> 4) != 4) || (len < IPV4_HDR_LEN) || (h.m_offset + len > pkt_size) ) {
+        return;
+    }
+    if ( pkt_InetChecksum(ip,len) != 0 ) {
+        return;
+    }
+    h.m_len   = len;
+    h.m_valid = true;
+
+    uint8_t  proto = ip[9];
+    uint16_t total = PKT_NTOHS(*(uint16_t *)(ip+2));
+    uint16_t frag  = PKT_NTOHS(*(uint16_t *)(ip+6)) & 0x3fff;
+
+    if ( ((proto != IPHeader::Protocol::TCP) && (proto != IPHeader::Protocol::UDP)) ||
+         frag || (total < len) || (h.m_offset + total > pkt_size) ) {
+        return;
+    }
+    uint8_t * l4     = ip + len;
+    uint16_t  l4_len = total - len;
+
+    if ( proto == IPHeader::Protocol::TCP ) {
+        if ( l4_len < 20 ) {
+            return;
+        }
+        h.m_l4_cs = h.m_offset + len + 16;
+    }else{
+        /* zero is no checksum */
+        if ( (l4_len < 8) || (*(uint16_t *)(l4+6) == 0) ) {
+            return;
+        }
+        h.m_l4_cs  = h.m_offset + len + 6;
+        h.m_is_udp = true;
+    }
+
+    if ( pkt_L4InetChecksum(ip+12,8,proto,l4,l4_len) != 0 ) {
+        return;
+    }
+    h.m_l4_end = h.m_offset + total;
+    h.m_l4     = true;
+}
+
+/**
+ * find the ipv4 headers that can be kept incrementally. a header is not 
+ * when a write covers part of it or its checksum, the tcp/udp checksum 
+ * is not when a write covers the length/protocol or part of the segment, 
+ * or when another fixed header is inside the segment (tunnel) 
+ */
+void StreamVm::build_cs_table(const uint8_t * pkt){
+    m_cs_table.clear();
+    uint32_t ins_id=0;
+
+    for (auto inst : m_inst_list) {
+        if ( inst->get_instruction_type() == StreamVmInstruction::itFIX_IPV4_CS ){
+            uint16_t of = ((StreamVmInstructionFixChecksumIpv4 *)inst)->m_pkt_offset;
+            bool found = false;
+            for (auto & h : m_cs_table) {
+                if ( h.m_offset == of ) {
+                    h.m_last_fix = ins_id;
+                    found = true;
+                }
+            }
+            if ( !found ) {
+                StreamVmCsHeader h;
+                memset(&h,0,sizeof(h));
+                h.m_offset   = of;
+                h.m_len      = IPV4_HDR_LEN;
+                h.m_last_fix = ins_id;
+                vm_parse_cs_header(pkt,m_pkt_size,h);
+                m_cs_table.push_back(h);
+            }
+        }
+        ins_id++;
+    }
+
+    for (auto & h : m_cs_table) {
+        for (auto & o : m_cs_table) {
+            if ( &o == &h ) {
+                continue;
+            }
+            if ( vm_overlap(h.m_offset,h.m_offset+h.m_len,o.m_offset,o.m_offset+o.m_len) ) {
+                h.m_valid = false;
+            }
+            if ( (o.m_offset >= h.m_offset+h.m_len) && (o.m_offset < h.m_l4_end) ) {
+                h.m_l4 = false;
+            }
+        }
+    }
+
+    for (auto inst : m_inst_list) {
+        if ( inst->get_instruction_type() != StreamVmInstruction::itPKT_WR ){
+            continue;
+        }
+        StreamVmInstructionWriteToPkt * lpPkt = (StreamVmInstructionWriteToPkt *)inst;
+        VmFlowVarRec var;
+        if ( var_lookup(lpPkt->m_flow_var_name,var) == false ) {
+            continue;
+        }
+        uint32_t w   = lpPkt->m_pkt_offset;
+        uint32_t end = w + var.m_size_bytes;
+
+        for (auto & h : m_cs_table) {
+            uint32_t o       = h.m_offset;
+            uint32_t hdr_end = o + h.m_len;
+
+            if ( vm_overlap(w,end,o,hdr_end) && ( (w < o) || (end > hdr_end) ) ) {
+                h.m_valid = false;
+            }
+            if ( vm_overlap(w,end,o+10,o+12) ) {
+                h.m_valid = false;
+            }
+            if ( !h.m_l4 ) {
+                continue;
+            }
+            /* version/length, total length, fragment, protocol */
+            if ( vm_overlap(w,end,o,o+1) || vm_overlap(w,end,o+2,o+4) ||
+                 vm_overlap(w,end,o+6,o+8) || vm_overlap(w,end,o+9,o+10) ) {
+                h.m_l4 = false;
+            }
+            if ( vm_overlap(w,end,hdr_end,h.m_l4_end) && ( (w < hdr_end) || (end > h.m_l4_end) ) ) {
+                h.m_l4 = false;
+            }
+            if ( vm_overlap(w,end,h.m_l4_cs,h.m_l4_cs+2) ) {
+                h.m_l4 = false;
+            }
+            /* the last word of an odd write at the end of the packet */
+            if ( (w >= hdr_end) && (end <= h.m_l4_end) && (((end - hdr_end) & 1) == 1) && (end + 1 > m_pkt_size) ) {
+                h.m_l4 = false;
+            }
+        }
+    }
+
+    for (auto & h : m_cs_table) {
+        if ( !h.m_valid ) {
+            h.m_l4 = false;
+        }
+    }
+}
+
+/* the checksums that a write of [offset,offset+size) keeps, false if none */
+bool StreamVm::get_cs_update(uint32_t ins_id,
+                             uint16_t offset,
+                             uint8_t size,
+                             StreamDPOpCsUpdate & cs){
+    uint32_t end  = offset + size;
+    uint32_t base = 0;
+
+    memset(&cs,0,sizeof(cs));
+    for (auto & h : m_cs_table) {
+        if ( !h.m_valid ) {
+            continue;
+        }
+        uint32_t hdr_end = h.m_offset + h.m_len;
+
+        if ( (offset >= h.m_offset) && (end <= hdr_end) ) {
+            /* a write after the last fix leaves the checksum as is */
+            if ( ins_id < h.m_last_fix ) {
+                cs.m_flags  |= StreamDPOpCsUpdate::CS_IPV4;
+                cs.m_ipv4_cs = h.m_offset + 10;
+                base = h.m_offset;
+            }
+            /* src/dst are in the pseudo header */
+            if ( h.m_l4 && (offset >= h.m_offset + 12) && (end <= h.m_offset + 20) ) {
+                cs.m_flags |= StreamDPOpCsUpdate::CS_L4;
+                base = h.m_offset;
+            }
+        }
+        if ( h.m_l4 && (offset >= hdr_end) && (end <= h.m_l4_end) ) {
+            cs.m_flags |= StreamDPOpCsUpdate::CS_L4;
+            base = hdr_end;
+        }
+        if ( (cs.m_flags & StreamDPOpCsUpdate::CS_L4) && (cs.m_l4_cs == 0) ) {
+            cs.m_flags |= (h.m_is_udp ? StreamDPOpCsUpdate::CS_L4_UDP : 0);
+            cs.m_l4_cs  = h.m_l4_cs;
+        }
+    }
+
+    if ( cs.m_flags == 0 ) {
+        return (false);
+    }
+    cs.m_offset = offset - ((offset - base) & 1);
+    cs.m_words  = (end - cs.m_offset + 1) / 2;
+    return (true);
+}
+
+template <class WR>
+static void vm_add_pkt_wr(StreamDPVmInstructions & ins,
+                          WR & wr,
+                          uint8_t cs_op,
+                          bool is_cs,
+                          StreamDPOpCsUpdate & cs){
+    if ( is_cs ) {
+        StreamDPOpPktWrCs<WR> k;
+        k.m_wr      = wr;
+        k.m_wr.m_op = cs_op;
+        k.m_cs      = cs;
+        ins.add_command(&k,sizeof(k));
+    }else{
+        ins.add_command(&wr,sizeof(wr));
+    }
+}
+
+
+/* flow var with a step, inc_op is the INC op code of the size, DEC and RANDOM 
+   follow it by 4 and 8 */
+template <typename T>
+static void vm_add_flow_var_step(StreamDPVmInstructions & instructions,
+                                 const StreamVmInstructionFlowMan * lpMan,
+                                 uint8_t inc_op,
+                                 uint16_t flow_offset){
+    StreamDPOpFlowVarStep<T> fv;
+
+    switch (lpMan->m_op) {
+    case StreamVmInstructionFlowMan::FLOW_VAR_OP_DEC :
+        fv.m_op = inc_op + 4;
+        break;
+    case StreamVmInstructionFlowMan::FLOW_VAR_OP_RANDOM :
+        fv.m_op = inc_op + 8;
+        break;
+    default:
+        fv.m_op = inc_op;
+        break;
+    }
+    fv.m_flow_offset = (uint8_t)flow_offset;
+    fv.m_min_val     = (T)lpMan->m_min_value;
+    fv.m_max_val     = (T)lpMan->get_last_value();
+    fv.m_step        = (T)lpMan->m_step;
+    fv.m_count       = (T)lpMan->get_splitable_range();
+    instructions.add_command(&fv,sizeof(fv));
+}
+
 void StreamVm::build_program(){
 
     /* build the commands into a buffer */
@@ -346,15 +603,45 @@ void StreamVm::build_program(){
                 err(ss.str());
             }
 
-            StreamDPOpIpv4Fix ipv_fix;
-            ipv_fix.m_offset = lpFix->m_pkt_offset;
-            ipv_fix.m_op = StreamDPVmInstructions::ditFIX_IPV4_CS;
-            m_instructions.add_command(&ipv_fix,sizeof(ipv_fix));
+            /* the writes keep the checksum */
+            bool is_kept = false;
+            for (auto & h : m_cs_table) {
+                if ( (h.m_offset == lpFix->m_pkt_offset) && h.m_valid ) {
+                    is_kept = true;
+                }
+            }
+
+            if ( !is_kept ) {
+                StreamDPOpIpv4Fix ipv_fix;
+                ipv_fix.m_offset = lpFix->m_pkt_offset;
+                ipv_fix.m_op = StreamDPVmInstructions::ditFIX_IPV4_CS;
+                m_instructions.add_command(&ipv_fix,sizeof(ipv_fix));
+            }
         }
 
 
-        /* flow man */
-        if (ins_type == StreamVmInstruction::itFLOW_MAN) {
+        /* flow man with a step */
+        if ( (ins_type == StreamVmInstruction::itFLOW_MAN) && 
+             (((StreamVmInstructionFlowMan *)inst)->m_step != 1) ) {
+            StreamVmInstructionFlowMan *lpMan =(StreamVmInstructionFlowMan *)inst;
+
+            switch (lpMan->m_size_bytes) {
+            case 1:
+                vm_add_flow_var_step<uint8_t>(m_instructions,lpMan,StreamDPVmInstructions::ditINC8_STEP,get_var_offset(lpMan->m_var_name));
+                break;
+            case 2:
+                vm_add_flow_var_step<uint16_t>(m_instructions,lpMan,StreamDPVmInstructions::ditINC16_STEP,get_var_offset(lpMan->m_var_name));
+                break;
+            case 4:
+                vm_add_flow_var_step<uint32_t>(m_instructions,lpMan,StreamDPVmInstructions::ditINC32_STEP,get_var_offset(lpMan->m_var_name));
+                break;
+            default:
+                vm_add_flow_var_step<uint64_t>(m_instructions,lpMan,StreamDPVmInstructions::ditINC64_STEP,get_var_offset(lpMan->m_var_name));
+                break;
+            }
+
+        } else if (ins_type == StreamVmInstruction::itFLOW_MAN) {
+            /* flow man */
             StreamVmInstructionFlowMan *lpMan =(StreamVmInstructionFlowMan *)inst;
 
 
@@ -476,6 +763,17 @@ void StreamVm::build_program(){
             }
             add_field_cnt(lpPkt->m_pkt_offset + var.m_size_bytes);
 
+            StreamDPOpCsUpdate cs;
+            bool is_cs = get_cs_update(ins_id,lpPkt->m_pkt_offset,var.m_size_bytes,cs);
+            if ( is_cs ) {
+                add_field_cnt(cs.m_offset + cs.m_words * 2);
+                if ( cs.m_flags & StreamDPOpCsUpdate::CS_IPV4 ) {
+                    add_field_cnt(cs.m_ipv4_cs + 2);
+                }
+                if ( cs.m_flags & StreamDPOpCsUpdate::CS_L4 ) {
+                    add_field_cnt(cs.m_l4_cs + 2);
+                }
+            }
 
             uint8_t       op_size=var.m_size_bytes;
             bool is_big    = lpPkt->m_is_big_endian;
@@ -489,7 +787,7 @@ void StreamVm::build_program(){
                 pw8.m_offset =flow_offset;
                 pw8.m_pkt_offset = lpPkt->m_pkt_offset;
                 pw8.m_val_offset = (int8_t)lpPkt->m_add_value;
-                m_instructions.add_command(&pw8,sizeof(pw8));
+                vm_add_pkt_wr(m_instructions,pw8,StreamDPVmInstructions::itPKT_WR8_CS,is_cs,cs);
             }
 
             if (op_size == 2) {
@@ -499,7 +797,7 @@ void StreamVm::build_program(){
                 pw16.m_offset =flow_offset;
                 pw16.m_pkt_offset = lpPkt->m_pkt_offset;
                 pw16.m_val_offset = (int16_t)lpPkt->m_add_value;
-                m_instructions.add_command(&pw16,sizeof(pw16));
+                vm_add_pkt_wr(m_instructions,pw16,StreamDPVmInstructions::itPKT_WR16_CS,is_cs,cs);
             }
 
             if (op_size == 4) {
@@ -509,7 +807,7 @@ void StreamVm::build_program(){
                 pw32.m_offset =flow_offset;
                 pw32.m_pkt_offset = lpPkt->m_pkt_offset;
                 pw32.m_val_offset = (int32_t)lpPkt->m_add_value;
-                m_instructions.add_command(&pw32,sizeof(pw32));
+                vm_add_pkt_wr(m_instructions,pw32,StreamDPVmInstructions::itPKT_WR32_CS,is_cs,cs);
             }
 
             if (op_size == 8) {
@@ -519,7 +817,7 @@ void StreamVm::build_program(){
                 pw64.m_offset =flow_offset;
                 pw64.m_pkt_offset = lpPkt->m_pkt_offset;
                 pw64.m_val_offset = (int64_t)lpPkt->m_add_value;
-                m_instructions.add_command(&pw64,sizeof(pw64));
+                vm_add_pkt_wr(m_instructions,pw64,StreamDPVmInstructions::itPKT_WR64_CS,is_cs,cs);
             }
 
         }
@@ -534,7 +832,7 @@ void StreamVm::build_program(){
 
                 client_cmd.m_flow_offset = get_var_offset(lpMan->m_var_name+".ip"); /* start offset */
                 client_cmd.m_flags       = 0; /* not used */
-                client_cmd.m_pad         = 0;
+                client_cmd.m_ip_step     = lpMan->m_ip_step;
                 client_cmd.m_min_ip      = lpMan->m_client_min;
                 client_cmd.m_max_ip      = lpMan->m_client_max;
                 m_instructions.add_command(&client_cmd,sizeof(client_cmd));
@@ -545,7 +843,7 @@ void StreamVm::build_program(){
 
                 client_cmd.m_flow_offset = get_var_offset(lpMan->m_var_name+".ip"); /* start offset */
                 client_cmd.m_flags       = 0; /* not used */
-                client_cmd.m_pad         = 0;
+                client_cmd.m_ip_step     = lpMan->m_ip_step;
                 client_cmd.m_min_port    = lpMan->m_port_min;
                 client_cmd.m_max_port    = lpMan->m_port_max;
                 client_cmd.m_min_ip      = lpMan->m_client_min;
@@ -560,13 +858,254 @@ void StreamVm::build_program(){
 }
 
 
+/* flow var inc/dec + write of the var into the fused kernel */
+template <typename T, bool IS_INC, typename FV, typename WR>
+static void vm_fuse_flow_var(std::vector<uint8_t> & out,
+                             uint8_t op,
+                             FV * fv,
+                             WR * wr){
+    StreamDPOpFlowVarWr<T,IS_INC> k;
+    k.m_op          = op;
+    k.m_flags       = wr->m_flags & StreamDPOpFused::FUSED_WR_IS_BIG;
+    k.m_flow_offset = fv->m_flow_offset;
+    k.m_pkt_offset  = wr->m_pkt_offset;
+    k.m_ipv4_offset = 0;
+    k.m_min_val     = fv->m_min_val;
+    k.m_max_val     = fv->m_max_val;
+    k.m_val_offset  = (T)wr->m_val_offset;
+    out.assign((uint8_t *)&k,(uint8_t *)&k+sizeof(k));
+}
+
+/* client var + writes of its ip/port into the fused kernel */
+template <class CLIENT_OP>
+static void vm_fuse_client(std::vector<uint8_t> & out,
+                           uint8_t op,
+                           CLIENT_OP * client,
+                           StreamDPOpPktWr32 * wr_ip,
+                           StreamDPOpPktWr16 * wr_port){
+    StreamDPOpClientsWr<CLIENT_OP> k;
+    memset(&k,0,sizeof(k));
+    k.m_client      = *client;
+    k.m_client.m_op = op;
+    if (wr_ip) {
+        k.m_flags        |= StreamDPOpFused::FUSED_WR_IP;
+        k.m_flags        |= (wr_ip->is_big() ? StreamDPOpFused::FUSED_WR_IS_BIG : 0);
+        k.m_ip_pkt_offset = wr_ip->m_pkt_offset;
+        k.m_ip_val_offset = wr_ip->m_val_offset;
+    }
+    if (wr_port) {
+        k.m_flags          |= StreamDPOpFused::FUSED_WR_PORT;
+        k.m_flags          |= (wr_port->is_big() ? StreamDPOpFused::FUSED_PORT_IS_BIG : 0);
+        k.m_port_pkt_offset = wr_port->m_pkt_offset;
+        k.m_port_val_offset = wr_port->m_val_offset;
+    }
+    out.assign((uint8_t *)&k,(uint8_t *)&k+sizeof(k));
+}
+
+static bool vm_is_pkt_wr(const std::vector<uint8_t> & ins){
+    return ( (ins.size() > 0) &&
+             (ins[0] >= StreamDPVmInstructions::itPKT_WR8) &&
+             (ins[0] <= StreamDPVmInstructions::itPKT_WR64) );
+}
+
+/* writes that keep the checksums are not fused */
+static bool vm_is_pkt_wr_cs(const std::vector<uint8_t> & ins){
+    return ( (ins.size() > 0) &&
+             (ins[0] >= StreamDPVmInstructions::itPKT_WR8_CS) &&
+             (ins[0] <= StreamDPVmInstructions::itPKT_WR64_CS) );
+}
+
+/* next instruction after <from> that was not removed */
+static int vm_next_ins(std::vector<std::vector<uint8_t> > & prog,int from){
+    int i;
+    for (i=from+1; i<(int)prog.size(); i++) {
+        if (prog[i].size()) {
+            return (i);
+        }
+    }
+    return (-1);
+}
+
+/* first packet write after <from> that reads flow var bytes [offset,offset+size), 
+   -1 if there is none or it can not be fused */
+static int vm_find_reader(std::vector<std::vector<uint8_t> > & prog,
+                          int from,
+                          uint8_t offset,
+                          uint8_t size){
+    int i;
+    for (i=from+1; i<(int)prog.size(); i++) {
+        if ( vm_is_pkt_wr(prog[i]) || vm_is_pkt_wr_cs(prog[i]) ) {
+            uint8_t of = ((StreamDPOpPktWrBase *)&prog[i][0])->m_offset;
+            if ( (of >= offset) && (of < offset+size) ) {
+                return ( vm_is_pkt_wr(prog[i]) ? i : -1 );
+            }
+        }
+    }
+    return (-1);
+}
+
+/**
+ * lower the program into fused kernels. a flow var inc/dec is moved down 
+ * to its first write, nothing reads the var in between and inc/dec do not 
+ * use the random seed so the order of the random vars does not change. 
+ * a client var is moved down to the first write of its ip or port and 
+ * takes the write of the other field if it is the next instruction. an 
+ * ipv4 fix right after a fused kernel is done by the kernel 
+ */
+void StreamVm::fuse_program(){
+    std::vector<std::vector<uint8_t> > prog;
+    uint8_t * p     = m_instructions.get_program();
+    uint8_t * p_end = p + m_instructions.get_program_size();
+    int i;
+
+    while ( p < p_end ) {
+        uint16_t size = StreamDPVmInstructions::get_ins_size(*p);
+        prog.push_back(std::vector<uint8_t>(p,p+size));
+        p += size;
+    }
+
+    for (i=0; i<(int)prog.size(); i++) {
+        if ( prog[i].size() == 0 ) {
+            continue;
+        }
+        uint8_t op = prog[i][0];
+
+        if ( (op >= StreamDPVmInstructions::ditINC8) && (op <= StreamDPVmInstructions::ditDEC64) ) {
+            /* flow var, same layout for all sizes up to the offset */
+            uint8_t of = ((StreamDPOpFlowVar8 *)&prog[i][0])->m_flow_offset;
+            int j = vm_find_reader(prog,i,of,1);
+            if ( j < 0 ) {
+                continue;
+            }
+            uint8_t * fv = &prog[i][0];
+            uint8_t * wr = &prog[j][0];
+
+            switch (op) {
+            case StreamDPVmInstructions::ditINC8 :
+                vm_fuse_flow_var<uint8_t,true>(prog[j],StreamDPVmInstructions::ditINC8_WR,(StreamDPOpFlowVar8 *)fv,(StreamDPOpPktWr8 *)wr);
+                break;
+            case StreamDPVmInstructions::ditINC16 :
+                vm_fuse_flow_var<uint16_t,true>(prog[j],StreamDPVmInstructions::ditINC16_WR,(StreamDPOpFlowVar16 *)fv,(StreamDPOpPktWr16 *)wr);
+                break;
+            case StreamDPVmInstructions::ditINC32 :
+                vm_fuse_flow_var<uint32_t,true>(prog[j],StreamDPVmInstructions::ditINC32_WR,(StreamDPOpFlowVar32 *)fv,(StreamDPOpPktWr32 *)wr);
+                break;
+            case StreamDPVmInstructions::ditINC64 :
+                vm_fuse_flow_var<uint64_t,true>(prog[j],StreamDPVmInstructions::ditINC64_WR,(StreamDPOpFlowVar64 *)fv,(StreamDPOpPktWr64 *)wr);
+                break;
+            case StreamDPVmInstructions::ditDEC8 :
+                vm_fuse_flow_var<uint8_t,false>(prog[j],StreamDPVmInstructions::ditDEC8_WR,(StreamDPOpFlowVar8 *)fv,(StreamDPOpPktWr8 *)wr);
+                break;
+            case StreamDPVmInstructions::ditDEC16 :
+                vm_fuse_flow_var<uint16_t,false>(prog[j],StreamDPVmInstructions::ditDEC16_WR,(StreamDPOpFlowVar16 *)fv,(StreamDPOpPktWr16 *)wr);
+                break;
+            case StreamDPVmInstructions::ditDEC32 :
+                vm_fuse_flow_var<uint32_t,false>(prog[j],StreamDPVmInstructions::ditDEC32_WR,(StreamDPOpFlowVar32 *)fv,(StreamDPOpPktWr32 *)wr);
+                break;
+            default:
+                vm_fuse_flow_var<uint64_t,false>(prog[j],StreamDPVmInstructions::ditDEC64_WR,(StreamDPOpFlowVar64 *)fv,(StreamDPOpPktWr64 *)wr);
+                break;
+            }
+            prog[i].clear();
+            continue;
+        }
+
+        if ( (op == StreamDPVmInstructions::itCLIENT_VAR) || (op == StreamDPVmInstructions::itCLIENT_VAR_UNLIMIT) ) {
+            uint8_t of = prog[i][1];
+            int j = vm_find_reader(prog,i,of,StreamVmInstructionFlowClient::get_flow_var_size());
+            if ( j < 0 ) {
+                continue;
+            }
+            uint8_t j_of = ((StreamDPOpPktWrBase *)&prog[j][0])->m_offset;
+            if ( (j_of != of) && (j_of != of+4) ) {
+                /* flow limit is read first */
+                continue;
+            }
+            /* the other field, only when it is written right after */
+            uint8_t other_of = (j_of == of) ? of+4 : of;
+            int k = vm_next_ins(prog,j);
+            if ( (k >= 0) &&
+                 ( !vm_is_pkt_wr(prog[k]) || (((StreamDPOpPktWrBase *)&prog[k][0])->m_offset != other_of) ) ) {
+                k = -1;
+            }
+
+            std::vector<uint8_t> wr_ip;
+            std::vector<uint8_t> wr_port;
+            (j_of == of ? wr_ip : wr_port) = prog[j];
+            if ( k >= 0 ) {
+                (other_of == of ? wr_ip : wr_port) = prog[k];
+                prog[k].clear();
+            }
+
+            if ( op == StreamDPVmInstructions::itCLIENT_VAR ) {
+                vm_fuse_client(prog[j],StreamDPVmInstructions::itCLIENT_VAR_WR,
+                               (StreamDPOpClientsLimit *)&prog[i][0],
+                               wr_ip.size() ? (StreamDPOpPktWr32 *)&wr_ip[0] : NULL,
+                               wr_port.size() ? (StreamDPOpPktWr16 *)&wr_port[0] : NULL);
+            }else{
+                vm_fuse_client(prog[j],StreamDPVmInstructions::itCLIENT_VAR_UNLIMIT_WR,
+                               (StreamDPOpClientsUnLimit *)&prog[i][0],
+                               wr_ip.size() ? (StreamDPOpPktWr32 *)&wr_ip[0] : NULL,
+                               wr_port.size() ? (StreamDPOpPktWr16 *)&wr_port[0] : NULL);
+            }
+            prog[i].clear();
+        }
+    }
+
+    /* ipv4 fix right after a fused kernel */
+    for (i=0; i<(int)prog.size(); i++) {
+        if ( (prog[i].size() == 0) ||
+             (prog[i][0] < StreamDPVmInstructions::ditINC8_WR) ||
+             (prog[i][0] > StreamDPVmInstructions::itCLIENT_VAR_UNLIMIT_WR) ) {
+            continue;
+        }
+        int k = vm_next_ins(prog,i);
+        if ( (k < 0) || (prog[k][0] != StreamDPVmInstructions::ditFIX_IPV4_CS) ) {
+            continue;
+        }
+        uint16_t fix_of = ((StreamDPOpIpv4Fix *)&prog[k][0])->m_offset;
+
+        switch (prog[i][0]) {
+        case StreamDPVmInstructions::itCLIENT_VAR_WR : {
+            StreamDPOpClientsLimitWr * lp = (StreamDPOpClientsLimitWr *)&prog[i][0];
+            lp->m_flags |= StreamDPOpFused::FUSED_IPV4_FIX;
+            lp->m_ipv4_offset = fix_of;
+            }
+            break;
+        case StreamDPVmInstructions::itCLIENT_VAR_UNLIMIT_WR : {
+            StreamDPOpClientsUnLimitWr * lp = (StreamDPOpClientsUnLimitWr *)&prog[i][0];
+            lp->m_flags |= StreamDPOpFused::FUSED_IPV4_FIX;
+            lp->m_ipv4_offset = fix_of;
+            }
+            break;
+        default: {
+            /* flow var kernels share the layout up to the values */
+            StreamDPOpInc8Wr * lp = (StreamDPOpInc8Wr *)&prog[i][0];
+            lp->m_flags |= StreamDPOpFused::FUSED_IPV4_FIX;
+            lp->m_ipv4_offset = fix_of;
+            }
+            break;
+        }
+        prog[k].clear();
+    }
+
+    m_instructions.clear();
+    for (i=0; i<(int)prog.size(); i++) {
+        if ( prog[i].size() ) {
+            m_instructions.add_command(&prog[i][0],prog[i].size());
+        }
+    }
+}
+
+
 void StreamVm::build_bss() {
     alloc_bss();
     uint8_t * p=(uint8_t *)m_bss;
 
     if ( m_is_random_var ){
-        *((uint32_t*)p)=rand();
-        p+=sizeof(uint32_t);
+        /* each compile ( and each core of a split ) gets its own seed of the run */
+        vm_srand((uint64_t*)p,utl_rand_new_seed());
+        p+=sizeof(uint64_t);
     }
 
     for (auto inst : m_inst_list) {
@@ -600,8 +1139,9 @@ void StreamVm::build_bss() {
         if ( inst->get_instruction_type() == StreamVmInstruction::itFLOW_CLIENT ){
 
             StreamVmInstructionFlowClient * ins_man=(StreamVmInstructionFlowClient *)inst;
-            if (ins_man->m_client_min>0) {
-                *((uint32_t*)p)=(uint32_t)(ins_man->m_client_min-1);
+            if ( (ins_man->m_client_min>0) || (ins_man->m_ip_step>1) ) {
+                /* one step back, the first packet has the min ip */
+                *((uint32_t*)p)=(uint32_t)(ins_man->m_client_min-ins_man->m_ip_step);
             }else{
                 *((uint32_t*)p)=(uint32_t)ins_man->m_client_min;
             }
@@ -666,7 +1206,11 @@ StreamVm::copy_instructions(StreamVm &other) const {
  * actual work - compile the VM
  * 
  */
-void StreamVm::compile(uint16_t pkt_len) {
+void StreamVm::compile(uint16_t pkt_len, bool fuse) {
+    compile(pkt_len,NULL,fuse);
+}
+
+void StreamVm::compile(uint16_t pkt_len, const uint8_t * pkt, bool fuse) {
 
     if (is_vm_empty()) {
         return;
@@ -680,8 +1224,16 @@ void StreamVm::compile(uint16_t pkt_len) {
     /* build init flow var memory */
     build_bss();
 
+    build_cs_table(pkt);
+
     build_program();
 
+    m_cs_table.clear();
+
+    if ( fuse ) {
+        fuse_program();
+    }
+
     if ( get_max_packet_update_offset() >svMAX_PACKET_OFFSET_CHANGE ){
         std::stringstream ss;
         ss << "maximum offset is" << get_max_packet_update_offset() << " bigger than maximum " <<svMAX_PACKET_OFFSET_CHANGE;
@@ -748,6 +1300,85 @@ void StreamVm::Dump(FILE *fd){
 }
 
 
+uint16_t StreamDPVmInstructions::get_ins_size(uint8_t op_code){
+    switch (op_code) {
+    case ditINC8 :
+    case ditDEC8 :
+    case ditRANDOM8 :
+        return (sizeof(StreamDPOpFlowVar8));
+    case ditINC16 :
+    case ditDEC16 :
+    case ditRANDOM16 :
+        return (sizeof(StreamDPOpFlowVar16));
+    case ditINC32 :
+    case ditDEC32 :
+    case ditRANDOM32 :
+        return (sizeof(StreamDPOpFlowVar32));
+    case ditINC64 :
+    case ditDEC64 :
+    case ditRANDOM64 :
+        return (sizeof(StreamDPOpFlowVar64));
+    case ditFIX_IPV4_CS :
+        return (sizeof(StreamDPOpIpv4Fix));
+    case itPKT_WR8 :
+        return (sizeof(StreamDPOpPktWr8));
+    case itPKT_WR16 :
+        return (sizeof(StreamDPOpPktWr16));
+    case itPKT_WR32 :
+        return (sizeof(StreamDPOpPktWr32));
+    case itPKT_WR64 :
+        return (sizeof(StreamDPOpPktWr64));
+    case itCLIENT_VAR :
+        return (sizeof(StreamDPOpClientsLimit));
+    case itCLIENT_VAR_UNLIMIT :
+        return (sizeof(StreamDPOpClientsUnLimit));
+    case ditINC8_WR :
+    case ditDEC8_WR :
+        return (sizeof(StreamDPOpInc8Wr));
+    case ditINC16_WR :
+    case ditDEC16_WR :
+        return (sizeof(StreamDPOpInc16Wr));
+    case ditINC32_WR :
+    case ditDEC32_WR :
+        return (sizeof(StreamDPOpInc32Wr));
+    case ditINC64_WR :
+    case ditDEC64_WR :
+        return (sizeof(StreamDPOpInc64Wr));
+    case itCLIENT_VAR_WR :
+        return (sizeof(StreamDPOpClientsLimitWr));
+    case itCLIENT_VAR_UNLIMIT_WR :
+        return (sizeof(StreamDPOpClientsUnLimitWr));
+    case itPKT_WR8_CS :
+        return (sizeof(StreamDPOpPktWr8Cs));
+    case itPKT_WR16_CS :
+        return (sizeof(StreamDPOpPktWr16Cs));
+    case itPKT_WR32_CS :
+        return (sizeof(StreamDPOpPktWr32Cs));
+    case itPKT_WR64_CS :
+        return (sizeof(StreamDPOpPktWr64Cs));
+    case ditINC8_STEP :
+    case ditDEC8_STEP :
+    case ditRANDOM8_STEP :
+        return (sizeof(StreamDPOpFlowVar8Step));
+    case ditINC16_STEP :
+    case ditDEC16_STEP :
+    case ditRANDOM16_STEP :
+        return (sizeof(StreamDPOpFlowVar16Step));
+    case ditINC32_STEP :
+    case ditDEC32_STEP :
+    case ditRANDOM32_STEP :
+        return (sizeof(StreamDPOpFlowVar32Step));
+    case ditINC64_STEP :
+    case ditDEC64_STEP :
+    case ditRANDOM64_STEP :
+        return (sizeof(StreamDPOpFlowVar64Step));
+    default:
+        assert(0);
+    }
+    return (0);
+}
+
+
 void StreamDPVmInstructions::clear(){
     m_inst_list.clear();
 }
@@ -901,6 +1532,97 @@ void StreamDPVmInstructions::Dump(FILE *fd){
             p+=sizeof(StreamDPOpClientsUnLimit);
             break;
 
+        case  ditINC8_WR :
+            ((StreamDPOpInc8Wr *)p)->dump(fd,"INC8Wr");
+            p+=sizeof(StreamDPOpInc8Wr);
+            break;
+        case  ditINC16_WR :
+            ((StreamDPOpInc16Wr *)p)->dump(fd,"INC16Wr");
+            p+=sizeof(StreamDPOpInc16Wr);
+            break;
+        case  ditINC32_WR :
+            ((StreamDPOpInc32Wr *)p)->dump(fd,"INC32Wr");
+            p+=sizeof(StreamDPOpInc32Wr);
+            break;
+        case  ditINC64_WR :
+            ((StreamDPOpInc64Wr *)p)->dump(fd,"INC64Wr");
+            p+=sizeof(StreamDPOpInc64Wr);
+            break;
+        case  ditDEC8_WR :
+            ((StreamDPOpDec8Wr *)p)->dump(fd,"DEC8Wr");
+            p+=sizeof(StreamDPOpDec8Wr);
+            break;
+        case  ditDEC16_WR :
+            ((StreamDPOpDec16Wr *)p)->dump(fd,"DEC16Wr");
+            p+=sizeof(StreamDPOpDec16Wr);
+            break;
+        case  ditDEC32_WR :
+            ((StreamDPOpDec32Wr *)p)->dump(fd,"DEC32Wr");
+            p+=sizeof(StreamDPOpDec32Wr);
+            break;
+        case  ditDEC64_WR :
+            ((StreamDPOpDec64Wr *)p)->dump(fd,"DEC64Wr");
+            p+=sizeof(StreamDPOpDec64Wr);
+            break;
+        case  itCLIENT_VAR_WR :
+            ((StreamDPOpClientsLimitWr *)p)->dump(fd,"ClientWr");
+            p+=sizeof(StreamDPOpClientsLimitWr);
+            break;
+        case  itCLIENT_VAR_UNLIMIT_WR :
+            ((StreamDPOpClientsUnLimitWr *)p)->dump(fd,"ClientUnlimtedWr");
+            p+=sizeof(StreamDPOpClientsUnLimitWr);
+            break;
+        case  itPKT_WR8_CS :
+            ((StreamDPOpPktWr8Cs *)p)->dump(fd,"Wr8Cs");
+            p+=sizeof(StreamDPOpPktWr8Cs);
+            break;
+        case  itPKT_WR16_CS :
+            ((StreamDPOpPktWr16Cs *)p)->dump(fd,"Wr16Cs");
+            p+=sizeof(StreamDPOpPktWr16Cs);
+            break;
+        case  itPKT_WR32_CS :
+            ((StreamDPOpPktWr32Cs *)p)->dump(fd,"Wr32Cs");
+            p+=sizeof(StreamDPOpPktWr32Cs);
+            break;
+        case  itPKT_WR64_CS :
+            ((StreamDPOpPktWr64Cs *)p)->dump(fd,"Wr64Cs");
+            p+=sizeof(StreamDPOpPktWr64Cs);
+            break;
+
+        case  ditINC8_STEP :
+        case  ditINC16_STEP :
+        case  ditINC32_STEP :
+        case  ditINC64_STEP :
+        case  ditDEC8_STEP :
+        case  ditDEC16_STEP :
+        case  ditDEC32_STEP :
+        case  ditDEC64_STEP :
+        case  ditRANDOM8_STEP :
+        case  ditRANDOM16_STEP :
+        case  ditRANDOM32_STEP :
+        case  ditRANDOM64_STEP : {
+            static const char * names[] = { "INC8Step", "INC16Step", "INC32Step", "INC64Step",
+                                            "DEC8Step", "DEC16Step", "DEC32Step", "DEC64Step",
+                                            "RAND8Step", "RAND16Step", "RAND32Step", "RAND64Step" };
+            const char * name = names[op_code - ditINC8_STEP];
+            switch ( (op_code - ditINC8_STEP) % 4 ) {
+            case 0:
+                ((StreamDPOpFlowVar8Step *)p)->dump(fd,name);
+                break;
+            case 1:
+                ((StreamDPOpFlowVar16Step *)p)->dump(fd,name);
+                break;
+            case 2:
+                ((StreamDPOpFlowVar32Step *)p)->dump(fd,name);
+                break;
+            default:
+                ((StreamDPOpFlowVar64Step *)p)->dump(fd,name);
+                break;
+            }
+            p+=get_ins_size(op_code);
+            }
+            break;
+
 
         default:
             assert(0);
@@ -909,6 +1631,10 @@ void StreamDPVmInstructions::Dump(FILE *fd){
 }
 
 
+void StreamDPOpCsUpdate::dump(FILE *fd){
+    fprintf(fd," %10s  cs flags:%lu, of:%lu, words:%lu, ipv4_cs:%lu, l4_cs:%lu \n", "",(ulong)m_flags,(ulong)m_offset,(ulong)m_words,(ulong)m_ipv4_cs,(ulong)m_l4_cs);
+}
+
 void StreamDPOpFlowVar8::dump(FILE *fd,std::string opt){
     fprintf(fd," %10s  op:%lu, of:%lu, (%lu- %lu) \n",  opt.c_str(),(ulong)m_op,(ulong)m_flow_offset,(ulong)m_min_val,(ulong)m_max_val);
 }
@@ -948,11 +1674,11 @@ void StreamDPOpIpv4Fix::dump(FILE *fd,std::string opt){
 
 
 void StreamDPOpClientsLimit::dump(FILE *fd,std::string opt){
-    fprintf(fd," %10s  op:%lu, flow_offset: %lu (%x-%x) (%x-%x) flow_limit :%lu flags:%x \n",  opt.c_str(),(ulong)m_op,(ulong)m_flow_offset,m_min_ip,m_max_ip,m_min_port,m_max_port,(ulong)m_limit_flows,m_flags);
+    fprintf(fd," %10s  op:%lu, flow_offset: %lu (%x-%x) (%x-%x) flow_limit :%lu flags:%x ip_step:%u \n",  opt.c_str(),(ulong)m_op,(ulong)m_flow_offset,m_min_ip,m_max_ip,m_min_port,m_max_port,(ulong)m_limit_flows,m_flags,(uint32_t)m_ip_step);
 }
 
 void StreamDPOpClientsUnLimit::dump(FILE *fd,std::string opt){
-    fprintf(fd," %10s  op:%lu, flow_offset: %lu (%x-%x) flags:%x \n",  opt.c_str(),(ulong)m_op,(ulong)m_flow_offset,m_min_ip,m_max_ip,m_flags);
+    fprintf(fd," %10s  op:%lu, flow_offset: %lu (%x-%x) flags:%x ip_step:%u \n",  opt.c_str(),(ulong)m_op,(ulong)m_flow_offset,m_min_ip,m_max_ip,m_flags,(uint32_t)m_ip_step);
 }
 
 
@@ -29,47 +29,26 @@ limitations under the License.
 #include <common/Network/Packet/IPHeader.h>
 #include "pal_utl.h"
 #include "mbuf.h"
+#include "utl_rand.h"
 
 
 
-//https://software.intel.com/en-us/articles/fast-random-number-generator-on-the-intel-pentiumr-4-processor/
+/* the random state of a VM is the first 8 bytes of its bss, see utl_rand.h */
 
-//Used to seed the generator.
-inline void fast_srand(uint32_t &g_seed, int seed ){
-  g_seed = seed;
-}
-
-
-//fastrand routine returns one integer, similar output value range as C lib.
-
-inline int fastrand(uint32_t &g_seed)
-{
-  g_seed = (214013*g_seed+2531011);
-  return (g_seed>>16)&0x7FFF;
-}         
-
-static inline void vm_srand(uint32_t * per_thread_seed,uint64_t seedval)
+static inline void vm_srand(uint64_t * per_thread_seed,uint64_t seedval)
 {
-    fast_srand( *per_thread_seed,seedval );
+    utl_srand(*per_thread_seed,seedval);
 }
 
-static inline uint32_t vm_rand16(uint32_t * per_thread_seed)
+/* [min,max] of the var, the whole range of the type is a range of zero */
+static inline uint32_t vm_rand_range32(uint64_t * per_thread_seed,uint32_t min_val,uint32_t max_val)
 {
-	return ( fastrand(*per_thread_seed));
+    return ( min_val + utl_rand_range32(*per_thread_seed,max_val - min_val + 1) );
 }
 
-static inline uint32_t vm_rand32(uint32_t * per_thread_seed)
+static inline uint64_t vm_rand_range64(uint64_t * per_thread_seed,uint64_t min_val,uint64_t max_val)
 {
-	return ( (vm_rand16(per_thread_seed)<<16)+vm_rand16(per_thread_seed));
-}
-
-static inline uint64_t vm_rand64(uint32_t * per_thread_seed)
-{
-    uint64_t res;
-
-    res=((uint64_t)vm_rand32(per_thread_seed)<<32)+vm_rand32(per_thread_seed);
-
-    return (res);
+    return ( min_val + utl_rand_range64(*per_thread_seed,max_val - min_val + 1) );
 }
                           
 
@@ -104,9 +83,9 @@ public:
         }
     }
 
-    inline void run_rand(uint8_t * flow_var,uint32_t *per_thread_random) {
+    inline void run_rand(uint8_t * flow_var,uint64_t *per_thread_random) {
         uint8_t * p=(flow_var+m_flow_offset);
-        *p= m_min_val + (vm_rand16(per_thread_random)  % (int)(m_max_val - m_min_val + 1));
+        *p= (uint8_t)vm_rand_range32(per_thread_random,m_min_val,m_max_val);
     }
 
 
@@ -138,9 +117,9 @@ public:
         }
     }
 
-    inline void run_rand(uint8_t * flow_var,uint32_t *per_thread_random) {
+    inline void run_rand(uint8_t * flow_var,uint64_t *per_thread_random) {
         uint16_t * p=(uint16_t *)(flow_var+m_flow_offset);
-        *p= m_min_val + (vm_rand16(per_thread_random) % (int)(m_max_val - m_min_val + 1));
+        *p= (uint16_t)vm_rand_range32(per_thread_random,m_min_val,m_max_val);
     }
 
 
@@ -173,9 +152,9 @@ public:
         }
     }
 
-    inline void run_rand(uint8_t * flow_var,uint32_t *per_thread_random) {
+    inline void run_rand(uint8_t * flow_var,uint64_t *per_thread_random) {
         uint32_t * p=(uint32_t *)(flow_var+m_flow_offset);
-        *p= m_min_val + (vm_rand32(per_thread_random) % (int)(m_max_val - m_min_val + 1));
+        *p= vm_rand_range32(per_thread_random,m_min_val,m_max_val);
     }
 
 } __attribute__((packed)) ;
@@ -206,14 +185,68 @@ public:
         }
     }
 
-    inline void run_rand(uint8_t * flow_var,uint32_t *per_thread_random) {
+    inline void run_rand(uint8_t * flow_var,uint64_t *per_thread_random) {
         uint64_t * p=(uint64_t *)(flow_var+m_flow_offset);
-        *p= m_min_val + ( vm_rand64(per_thread_random)  % (int)(m_max_val - m_min_val + 1));
+        *p= vm_rand_range64(per_thread_random,m_min_val,m_max_val);
+    }
+
+
+} __attribute__((packed)) ;
+
+/**
+ * flow var with a step other than 1, the values are m_min_val + k*m_step 
+ * up to m_max_val that is one of them ( see StreamVmInstructionFlowMan ). 
+ * m_count is the number of values for random 
+ */
+template <typename T>
+struct StreamDPOpFlowVarStep {
+    uint8_t m_op;
+    uint8_t m_flow_offset;
+    T       m_min_val;
+    T       m_max_val;
+    T       m_step;
+    T       m_count;
+public:
+    void dump(FILE *fd,std::string opt){
+        fprintf(fd," %10s  op:%lu, of:%lu, (%lu-%lu) step:%lu \n",  opt.c_str(),(ulong)m_op,(ulong)m_flow_offset,(ulong)m_min_val,(ulong)m_max_val,(ulong)m_step);
+    }
+
+    inline void run_inc(uint8_t * flow_var) {
+        T *p = (T *)(flow_var + m_flow_offset);
+        if (*p == m_max_val) {
+            *p = m_min_val;
+        } else {
+            *p = (T)(*p + m_step);
+        }
     }
 
+    inline void run_dec(uint8_t * flow_var) {
+        T *p = (T *)(flow_var + m_flow_offset);
+        if (*p == m_min_val) {
+            *p = m_max_val;
+        } else {
+            *p = (T)(*p - m_step);
+        }
+    }
+
+    inline void run_rand(uint8_t * flow_var,uint64_t *per_thread_random) {
+        T * p=(T *)(flow_var+m_flow_offset);
+        uint64_t r;
+        if ( sizeof(T) <= 4 ) {
+            r = utl_rand_range32(*per_thread_random,(uint32_t)m_count);
+        } else {
+            r = utl_rand_range64(*per_thread_random,(uint64_t)m_count);
+        }
+        *p = (T)(m_min_val + m_step * (T)r);
+    }
 
 } __attribute__((packed)) ;
 
+typedef StreamDPOpFlowVarStep<uint8_t>  StreamDPOpFlowVar8Step;
+typedef StreamDPOpFlowVarStep<uint16_t> StreamDPOpFlowVar16Step;
+typedef StreamDPOpFlowVarStep<uint32_t> StreamDPOpFlowVar32Step;
+typedef StreamDPOpFlowVarStep<uint64_t> StreamDPOpFlowVar64Step;
+
 
 struct StreamDPOpPktWrBase {
     enum {
@@ -320,6 +353,79 @@ public:
 } __attribute__((packed));
 
 
+/**
+ * incremental checksum update of a packet write (RFC 1624), used instead 
+ * of StreamDPOpIpv4Fix when the stream packet has valid checksums, see 
+ * StreamVm::build_program. the words that the write covers are summed 
+ * before and after the write and the difference is added to the ipv4 
+ * and/or the tcp/udp checksum field in place 
+ */
+struct StreamDPOpCsUpdate {
+    enum {
+        CS_IPV4   = 1, /* update the ipv4 header checksum */
+        CS_L4     = 2, /* update the tcp/udp checksum */
+        CS_L4_UDP = 4  /* udp, a zero checksum is sent as 0xffff */
+    };
+
+    uint8_t  m_flags;
+    uint8_t  m_words;      /* words that the write covers */
+    uint16_t m_offset;     /* first word, aligned to the header */
+    uint16_t m_ipv4_cs;    /* offset of the ipv4 checksum field */
+    uint16_t m_l4_cs;      /* offset of the tcp/udp checksum field */
+public:
+    void dump(FILE *fd);
+
+    inline uint32_t sum(uint8_t * pkt_base){
+        uint16_t * p = (uint16_t *)(pkt_base + m_offset);
+        uint32_t   s = 0;
+        int i;
+        for (i=0; i<m_words; i++) {
+            s += p[i];
+        }
+        return (s);
+    }
+
+    inline void update(uint8_t * pkt_base,uint32_t old_sum){
+        uint32_t delta = pkt_DeltaInetChecksum(old_sum,sum(pkt_base));
+        if ( m_flags & CS_IPV4 ) {
+            uint16_t * cs = (uint16_t *)(pkt_base + m_ipv4_cs);
+            *cs = pkt_ApplyInetChecksumDelta(*cs,delta);
+        }
+        if ( m_flags & CS_L4 ) {
+            uint16_t * cs = (uint16_t *)(pkt_base + m_l4_cs);
+            uint16_t   v  = pkt_ApplyInetChecksumDelta(*cs,delta);
+            if ( (v == 0) && (m_flags & CS_L4_UDP) ) {
+                v = 0xffff;
+            }
+            *cs = v;
+        }
+    }
+} __attribute__((packed));
+
+/* packet write that keeps the checksums */
+template <class WR>
+struct StreamDPOpPktWrCs {
+    WR                  m_wr; /* the op code is the checksum one */
+    StreamDPOpCsUpdate  m_cs;
+public:
+    void dump(FILE *fd,std::string opt){
+        m_wr.dump(fd,opt);
+        m_cs.dump(fd);
+    }
+
+    inline void wr(uint8_t * flow_var_base,uint8_t * pkt_base) {
+        uint32_t old_sum = m_cs.sum(pkt_base);
+        m_wr.wr(flow_var_base,pkt_base);
+        m_cs.update(pkt_base,old_sum);
+    }
+} __attribute__((packed));
+
+typedef StreamDPOpPktWrCs<StreamDPOpPktWr8>  StreamDPOpPktWr8Cs;
+typedef StreamDPOpPktWrCs<StreamDPOpPktWr16> StreamDPOpPktWr16Cs;
+typedef StreamDPOpPktWrCs<StreamDPOpPktWr32> StreamDPOpPktWr32Cs;
+typedef StreamDPOpPktWrCs<StreamDPOpPktWr64> StreamDPOpPktWr64Cs;
+
+
 /* flow varible of Client command */
 struct StreamDPFlowClient {
     uint32_t cur_ip;
@@ -332,7 +438,7 @@ struct StreamDPOpClientsLimit {
     uint8_t m_op;
     uint8_t m_flow_offset; /* offset into the flow var  bytes */
     uint8_t m_flags;
-    uint8_t m_pad;
+    uint8_t m_ip_step;     /* the ips are m_min_ip + k*m_ip_step */
     uint16_t    m_min_port;
     uint16_t    m_max_port;
 
@@ -344,8 +450,8 @@ public:
     void dump(FILE *fd,std::string opt);
     inline void run(uint8_t * flow_var_base) {
         StreamDPFlowClient * lp= (StreamDPFlowClient *)(flow_var_base+m_flow_offset);
-        lp->cur_ip++;
-        if (lp->cur_ip > m_max_ip ) {
+        lp->cur_ip += m_ip_step;
+        if ((uint32_t)(lp->cur_ip - m_min_ip) > (uint32_t)(m_max_ip - m_min_ip)) {
             lp->cur_ip= m_min_ip;
             lp->cur_port++;
             if (lp->cur_port > m_max_port) {
@@ -375,7 +481,7 @@ struct StreamDPOpClientsUnLimit {
     uint8_t m_op;
     uint8_t m_flow_offset; /* offset into the flow var  bytes */
     uint8_t m_flags;
-    uint8_t m_pad;
+    uint8_t m_ip_step;
     uint32_t    m_min_ip;
     uint32_t    m_max_ip;
 
@@ -383,8 +489,8 @@ public:
     void dump(FILE *fd,std::string opt);
     inline void run(uint8_t * flow_var_base) {
         StreamDPFlowClient * lp= (StreamDPFlowClient *)(flow_var_base+m_flow_offset);
-        lp->cur_ip++;
-        if (lp->cur_ip > m_max_ip ) {
+        lp->cur_ip += m_ip_step;
+        if ((uint32_t)(lp->cur_ip - m_min_ip) > (uint32_t)(m_max_ip - m_min_ip)) {
             lp->cur_ip= m_min_ip;
             lp->cur_port++;
             if (lp->cur_port == 0) {
@@ -396,6 +502,115 @@ public:
 } __attribute__((packed));
 
 
+static inline uint8_t  vm_hton(uint8_t v)  { return (v); }
+static inline uint16_t vm_hton(uint16_t v) { return (PKT_HTONS(v)); }
+static inline uint32_t vm_hton(uint32_t v) { return (PKT_HTONL(v)); }
+static inline uint64_t vm_hton(uint64_t v) { return (pal_ntohl64(v)); }
+
+/**
+ * fused kernels, see StreamVm::fuse_program. 
+ * a flow var inc/dec is fused with the first write of the var, 
+ * a client var with the first writes of its ip/port and both 
+ * with an ipv4 fix that follows the write 
+ */
+struct StreamDPOpFused {
+    enum {
+        FUSED_WR_IS_BIG   = 1, /* same as PKT_WR_IS_BIG */
+        FUSED_IPV4_FIX    = 2,
+        FUSED_WR_IP       = 4,
+        FUSED_WR_PORT     = 8,
+        FUSED_PORT_IS_BIG = 16
+    };
+
+    static inline void fix_ipv4(uint8_t flags,uint16_t offset,uint8_t * pkt_base){
+        if ( flags & FUSED_IPV4_FIX ) {
+            IPHeader * ipv4 = (IPHeader *)(pkt_base+offset);
+            ipv4->updateCheckSum();
+        }
+    }
+};
+
+template <typename T, bool IS_INC>
+struct StreamDPOpFlowVarWr {
+    uint8_t  m_op;
+    uint8_t  m_flags;
+    uint8_t  m_flow_offset;
+    uint16_t m_pkt_offset;
+    uint16_t m_ipv4_offset;
+    T        m_min_val;
+    T        m_max_val;
+    T        m_val_offset;
+public:
+    void dump(FILE *fd,std::string opt){
+        fprintf(fd," %10s  op:%lu, of:%lu, (%lu-%lu) flags:%lu, pkt_of:%lu, ipv4_of:%lu \n",  opt.c_str(),(ulong)m_op,(ulong)m_flow_offset,(ulong)m_min_val,(ulong)m_max_val,(ulong)m_flags,(ulong)m_pkt_offset,(ulong)m_ipv4_offset);
+    }
+
+    inline void run(uint8_t * flow_var,uint8_t * pkt_base) {
+        T * p = (T *)(flow_var + m_flow_offset);
+        T   v = *p;
+        if ( IS_INC ) {
+            v = (v == m_max_val) ? m_min_val : (T)(v + 1);
+        }else{
+            v = (v == m_min_val) ? m_max_val : (T)(v - 1);
+        }
+        *p = v;
+
+        T * p_pkt = (T *)(pkt_base + m_pkt_offset);
+        v = (T)(v + m_val_offset);
+        if ( odp_likely(m_flags & StreamDPOpFused::FUSED_WR_IS_BIG) ) {
+            *p_pkt = vm_hton(v);
+        }else{
+            *p_pkt = v;
+        }
+        StreamDPOpFused::fix_ipv4(m_flags,m_ipv4_offset,pkt_base);
+    }
+} __attribute__((packed));
+
+template <class CLIENT_OP>
+struct StreamDPOpClientsWr {
+    CLIENT_OP m_client; /* the op code is the fused one */
+    uint8_t   m_flags;
+    uint16_t  m_ip_pkt_offset;
+    uint16_t  m_port_pkt_offset;
+    uint16_t  m_ipv4_offset;
+    int32_t   m_ip_val_offset;
+    int16_t   m_port_val_offset;
+public:
+    void dump(FILE *fd,std::string opt){
+        m_client.dump(fd,opt);
+        fprintf(fd," %10s  flags:%lu, ip_of:%lu, port_of:%lu, ipv4_of:%lu \n", "",(ulong)m_flags,(ulong)m_ip_pkt_offset,(ulong)m_port_pkt_offset,(ulong)m_ipv4_offset);
+    }
+
+    inline void run(uint8_t * flow_var,uint8_t * pkt_base) {
+        m_client.run(flow_var);
+        StreamDPFlowClient * lp= (StreamDPFlowClient *)(flow_var+m_client.m_flow_offset);
+
+        if ( m_flags & StreamDPOpFused::FUSED_WR_IP ) {
+            uint32_t * p_pkt = (uint32_t *)(pkt_base + m_ip_pkt_offset);
+            uint32_t   v     = lp->cur_ip + m_ip_val_offset;
+            *p_pkt = (m_flags & StreamDPOpFused::FUSED_WR_IS_BIG) ? PKT_HTONL(v) : v;
+        }
+        if ( m_flags & StreamDPOpFused::FUSED_WR_PORT ) {
+            uint16_t * p_pkt = (uint16_t *)(pkt_base + m_port_pkt_offset);
+            uint16_t   v     = lp->cur_port + m_port_val_offset;
+            *p_pkt = (m_flags & StreamDPOpFused::FUSED_PORT_IS_BIG) ? PKT_HTONS(v) : v;
+        }
+        StreamDPOpFused::fix_ipv4(m_flags,m_ipv4_offset,pkt_base);
+    }
+} __attribute__((packed));
+
+typedef StreamDPOpFlowVarWr<uint8_t,true>   StreamDPOpInc8Wr;
+typedef StreamDPOpFlowVarWr<uint16_t,true>  StreamDPOpInc16Wr;
+typedef StreamDPOpFlowVarWr<uint32_t,true>  StreamDPOpInc32Wr;
+typedef StreamDPOpFlowVarWr<uint64_t,true>  StreamDPOpInc64Wr;
+typedef StreamDPOpFlowVarWr<uint8_t,false>  StreamDPOpDec8Wr;
+typedef StreamDPOpFlowVarWr<uint16_t,false> StreamDPOpDec16Wr;
+typedef StreamDPOpFlowVarWr<uint32_t,false> StreamDPOpDec32Wr;
+typedef StreamDPOpFlowVarWr<uint64_t,false> StreamDPOpDec64Wr;
+typedef StreamDPOpClientsWr<StreamDPOpClientsLimit>   StreamDPOpClientsLimitWr;
+typedef StreamDPOpClientsWr<StreamDPOpClientsUnLimit> StreamDPOpClientsUnLimitWr;
+
+
 /* datapath instructions */
 class StreamDPVmInstructions {
 public:
@@ -422,9 +637,48 @@ public:
         itPKT_WR32       ,
         itPKT_WR64       ,
         itCLIENT_VAR       ,
-        itCLIENT_VAR_UNLIMIT      
+        itCLIENT_VAR_UNLIMIT      ,
+
+        /* fused kernels */
+        ditINC8_WR      ,
+        ditINC16_WR     ,
+        ditINC32_WR     ,
+        ditINC64_WR     ,
+
+        ditDEC8_WR      ,
+        ditDEC16_WR     ,
+        ditDEC32_WR     ,
+        ditDEC64_WR     ,
+
+        itCLIENT_VAR_WR ,
+        itCLIENT_VAR_UNLIMIT_WR ,
+
+        /* packet writes that keep the checksums */
+        itPKT_WR8_CS    ,
+        itPKT_WR16_CS   ,
+        itPKT_WR32_CS   ,
+        itPKT_WR64_CS   ,
+
+        /* flow var with a step */
+        ditINC8_STEP    ,
+        ditINC16_STEP   ,
+        ditINC32_STEP   ,
+        ditINC64_STEP   ,
+
+        ditDEC8_STEP    ,
+        ditDEC16_STEP   ,
+        ditDEC32_STEP   ,
+        ditDEC64_STEP   ,
+
+        ditRANDOM8_STEP ,
+        ditRANDOM16_STEP,
+        ditRANDOM32_STEP,
+        ditRANDOM64_STEP
     };
 
+    /* size of the instruction in the program */
+    static uint16_t get_ins_size(uint8_t op_code);
+
 
 public:
     void clear();
@@ -443,7 +697,7 @@ private:
 
 class StreamDPVmInstructionsRunner {
 public:
-    inline void run(uint32_t * per_thread_random,
+    inline void run(uint64_t * per_thread_random,
                     uint32_t program_size,
                     uint8_t * program,  /* program */
                     uint8_t * flow_var, /* flow var */
@@ -452,7 +706,7 @@ public:
 };
 
 
-inline void StreamDPVmInstructionsRunner::run(uint32_t * per_thread_random,
+inline void StreamDPVmInstructionsRunner::run(uint64_t * per_thread_random,
                                               uint32_t program_size,
                                               uint8_t * program,  /* program */
                                               uint8_t * flow_var, /* flow var */
@@ -586,6 +840,117 @@ inline void StreamDPVmInstructionsRunner::run(uint32_t * per_thread_random,
             ua.lpw64->wr(flow_var,pkt);
             p+=sizeof(StreamDPOpPktWr64);
             break;
+
+        case  StreamDPVmInstructions::ditINC8_WR :
+            ((StreamDPOpInc8Wr *)p)->run(flow_var,pkt);
+            p+=sizeof(StreamDPOpInc8Wr);
+            break;
+        case  StreamDPVmInstructions::ditINC16_WR :
+            ((StreamDPOpInc16Wr *)p)->run(flow_var,pkt);
+            p+=sizeof(StreamDPOpInc16Wr);
+            break;
+        case  StreamDPVmInstructions::ditINC32_WR :
+            ((StreamDPOpInc32Wr *)p)->run(flow_var,pkt);
+            p+=sizeof(StreamDPOpInc32Wr);
+            break;
+        case  StreamDPVmInstructions::ditINC64_WR :
+            ((StreamDPOpInc64Wr *)p)->run(flow_var,pkt);
+            p+=sizeof(StreamDPOpInc64Wr);
+            break;
+
+        case  StreamDPVmInstructions::ditDEC8_WR :
+            ((StreamDPOpDec8Wr *)p)->run(flow_var,pkt);
+            p+=sizeof(StreamDPOpDec8Wr);
+            break;
+        case  StreamDPVmInstructions::ditDEC16_WR :
+            ((StreamDPOpDec16Wr *)p)->run(flow_var,pkt);
+            p+=sizeof(StreamDPOpDec16Wr);
+            break;
+        case  StreamDPVmInstructions::ditDEC32_WR :
+            ((StreamDPOpDec32Wr *)p)->run(flow_var,pkt);
+            p+=sizeof(StreamDPOpDec32Wr);
+            break;
+        case  StreamDPVmInstructions::ditDEC64_WR :
+            ((StreamDPOpDec64Wr *)p)->run(flow_var,pkt);
+            p+=sizeof(StreamDPOpDec64Wr);
+            break;
+
+        case  StreamDPVmInstructions::itCLIENT_VAR_WR :
+            ((StreamDPOpClientsLimitWr *)p)->run(flow_var,pkt);
+            p+=sizeof(StreamDPOpClientsLimitWr);
+            break;
+        case  StreamDPVmInstructions::itCLIENT_VAR_UNLIMIT_WR :
+            ((StreamDPOpClientsUnLimitWr *)p)->run(flow_var,pkt);
+            p+=sizeof(StreamDPOpClientsUnLimitWr);
+            break;
+
+        case  StreamDPVmInstructions::itPKT_WR8_CS :
+            ((StreamDPOpPktWr8Cs *)p)->wr(flow_var,pkt);
+            p+=sizeof(StreamDPOpPktWr8Cs);
+            break;
+        case  StreamDPVmInstructions::itPKT_WR16_CS :
+            ((StreamDPOpPktWr16Cs *)p)->wr(flow_var,pkt);
+            p+=sizeof(StreamDPOpPktWr16Cs);
+            break;
+        case  StreamDPVmInstructions::itPKT_WR32_CS :
+            ((StreamDPOpPktWr32Cs *)p)->wr(flow_var,pkt);
+            p+=sizeof(StreamDPOpPktWr32Cs);
+            break;
+        case  StreamDPVmInstructions::itPKT_WR64_CS :
+            ((StreamDPOpPktWr64Cs *)p)->wr(flow_var,pkt);
+            p+=sizeof(StreamDPOpPktWr64Cs);
+            break;
+
+        case  StreamDPVmInstructions::ditINC8_STEP :
+            ((StreamDPOpFlowVar8Step *)p)->run_inc(flow_var);
+            p+=sizeof(StreamDPOpFlowVar8Step);
+            break;
+        case  StreamDPVmInstructions::ditINC16_STEP :
+            ((StreamDPOpFlowVar16Step *)p)->run_inc(flow_var);
+            p+=sizeof(StreamDPOpFlowVar16Step);
+            break;
+        case  StreamDPVmInstructions::ditINC32_STEP :
+            ((StreamDPOpFlowVar32Step *)p)->run_inc(flow_var);
+            p+=sizeof(StreamDPOpFlowVar32Step);
+            break;
+        case  StreamDPVmInstructions::ditINC64_STEP :
+            ((StreamDPOpFlowVar64Step *)p)->run_inc(flow_var);
+            p+=sizeof(StreamDPOpFlowVar64Step);
+            break;
+
+        case  StreamDPVmInstructions::ditDEC8_STEP :
+            ((StreamDPOpFlowVar8Step *)p)->run_dec(flow_var);
+            p+=sizeof(StreamDPOpFlowVar8Step);
+            break;
+        case  StreamDPVmInstructions::ditDEC16_STEP :
+            ((StreamDPOpFlowVar16Step *)p)->run_dec(flow_var);
+            p+=sizeof(StreamDPOpFlowVar16Step);
+            break;
+        case  StreamDPVmInstructions::ditDEC32_STEP :
+            ((StreamDPOpFlowVar32Step *)p)->run_dec(flow_var);
+            p+=sizeof(StreamDPOpFlowVar32Step);
+            break;
+        case  StreamDPVmInstructions::ditDEC64_STEP :
+            ((StreamDPOpFlowVar64Step *)p)->run_dec(flow_var);
+            p+=sizeof(StreamDPOpFlowVar64Step);
+            break;
+
+        case  StreamDPVmInstructions::ditRANDOM8_STEP :
+            ((StreamDPOpFlowVar8Step *)p)->run_rand(flow_var,per_thread_random);
+            p+=sizeof(StreamDPOpFlowVar8Step);
+            break;
+        case  StreamDPVmInstructions::ditRANDOM16_STEP :
+            ((StreamDPOpFlowVar16Step *)p)->run_rand(flow_var,per_thread_random);
+            p+=sizeof(StreamDPOpFlowVar16Step);
+            break;
+        case  StreamDPVmInstructions::ditRANDOM32_STEP :
+            ((StreamDPOpFlowVar32Step *)p)->run_rand(flow_var,per_thread_random);
+            p+=sizeof(StreamDPOpFlowVar32Step);
+            break;
+        case  StreamDPVmInstructions::ditRANDOM64_STEP :
+            ((StreamDPOpFlowVar64Step *)p)->run_rand(flow_var,per_thread_random);
+            p+=sizeof(StreamDPOpFlowVar64Step);
+            break;
         default:
             assert(0);
         }
@@ -700,8 +1065,14 @@ public:
         return ( StreamVmInstruction::itFLOW_MAN);
     }
 
+    /* number of values, min + k*step up to max */
     virtual uint64_t get_splitable_range() const {
-        return (m_max_value - m_min_value + 1);
+        return ((m_max_value - m_min_value) / m_step + 1);
+    }
+
+    /* the last value, max when it is on the step */
+    uint64_t get_last_value() const {
+        return (m_min_value + (get_splitable_range() - 1) * m_step);
     }
 
     /**
@@ -725,10 +1096,10 @@ public:
 
         switch (m_op) {
         case FLOW_VAR_OP_INC:
-            return (init == m_min_value ? m_max_value : (init - 1));
+            return (init == m_min_value ? get_last_value() : (init - m_step));
 
         case FLOW_VAR_OP_DEC:
-            return (init == m_max_value ? m_min_value : (init + 1));
+            return (init == get_last_value() ? m_min_value : (init + m_step));
 
         default:
             return init;
@@ -741,13 +1112,15 @@ public:
                                flow_var_op_e op,
                                uint64_t init_value,
                                uint64_t min_value,
-                               uint64_t max_value) : StreamVmInstructionVar(var_name) {
+                               uint64_t max_value,
+                               uint64_t step = 1) : StreamVmInstructionVar(var_name) {
 
         m_op = op;
         m_size_bytes = size;
         m_init_value = init_value;
         m_min_value  = min_value;
         m_max_value  = max_value;
+        m_step       = step;
     }
 
     virtual void Dump(FILE *fd);
@@ -760,7 +1133,8 @@ public:
                                               m_op,
                                               m_init_value,
                                               m_min_value,
-                                              m_max_value);
+                                              m_max_value,
+                                              m_step);
     }
 
 private:
@@ -780,6 +1154,7 @@ public:
     uint64_t m_init_value;
     uint64_t m_min_value;
     uint64_t m_max_value;
+    uint64_t m_step;
 
 };
 
@@ -819,6 +1194,7 @@ public:
 
         m_limit_num_flows = limit_num_flows;
         m_flags = flags;
+        m_ip_step = 1;
     }
 
     virtual void Dump(FILE *fd);
@@ -845,13 +1221,15 @@ public:
     }
 
     virtual StreamVmInstruction * clone() {
-        return new StreamVmInstructionFlowClient(m_var_name,
-                                                 m_client_min,
-                                                 m_client_max,
-                                                 m_port_min,
-                                                 m_port_max,
-                                                 m_limit_num_flows,
-                                                 m_flags);
+        StreamVmInstructionFlowClient * lp = new StreamVmInstructionFlowClient(m_var_name,
+                                                                               m_client_min,
+                                                                               m_client_max,
+                                                                               m_port_min,
+                                                                               m_port_max,
+                                                                               m_limit_num_flows,
+                                                                               m_flags);
+        lp->m_ip_step = m_ip_step;
+        return (lp);
     }
 
 public:
@@ -862,6 +1240,7 @@ public:
     uint16_t m_port_max;  // start port 
     uint32_t m_limit_num_flows;   // number of flows
     uint16_t m_flags;
+    uint8_t  m_ip_step;  // the ips are min + k*step, set by the VM splitter
 };
 
 
@@ -1046,6 +1425,22 @@ private:
 };
 
 
+/**
+ * an ipv4 header with a fix instruction, when it is valid the 
+ * checksums are kept by the packet writes and the fix is not needed 
+ */
+struct StreamVmCsHeader {
+    bool     m_valid;      /* the ipv4 checksum is kept incrementally */
+    bool     m_l4;         /* the tcp/udp checksum is kept too */
+    bool     m_is_udp;
+    uint16_t m_offset;     /* of the ipv4 header */
+    uint16_t m_len;        /* ipv4 header length */
+    uint16_t m_l4_end;     /* end of the tcp/udp segment */
+    uint16_t m_l4_cs;      /* offset of the tcp/udp checksum field */
+    uint32_t m_last_fix;   /* id of the last fix instruction of the header */
+};
+
+
 /**
  * describes a VM program
  * 
@@ -1058,6 +1453,12 @@ public:
         svMAX_PACKET_OFFSET_CHANGE = 512
     };
 
+    /* how the VM splitter divides the values of a var between N DP cores */
+    enum split_mode_e {
+        SPLIT_BY_BLOCK,  /* a contiguous part of the values per core */
+        SPLIT_BY_STRIDE  /* core i takes every N-th value starting at the i-th */
+    };
+
 
 
     StreamVm(){
@@ -1067,6 +1468,7 @@ public:
         m_cur_var_offset=0;
         m_is_random_var=false;
         m_split_instr=NULL;
+        m_split_mode=SPLIT_BY_BLOCK;
         m_is_compiled = false;
     }
 
@@ -1082,6 +1484,14 @@ public:
         return m_split_instr;
     }
 
+    void set_split_mode(split_mode_e mode) {
+        m_split_mode = mode;
+    }
+
+    split_mode_e get_split_mode() const {
+        return m_split_mode;
+    }
+
     StreamVmDp * generate_dp_object(){
 
         if (!m_is_compiled) {
@@ -1150,8 +1560,16 @@ public:
      * compile the VM 
      * return true of success, o.w false 
      * 
+     * fuse - lower common sequences into fused kernels 
+     */
+    void compile(uint16_t pkt_len, bool fuse = true);
+
+    /**
+     * pkt - the stream packet. headers that have an ipv4 fix and 
+     * valid checksums in pkt are kept by the packet writes 
+     * incrementally, including the tcp/udp checksum 
      */
-    void compile(uint16_t pkt_len);
+    void compile(uint16_t pkt_len, const uint8_t * pkt, bool fuse = true);
 
     ~StreamVm();
 
@@ -1183,8 +1601,17 @@ private:
 
     void build_bss();
 
+    void build_cs_table(const uint8_t * pkt);
+
+    bool get_cs_update(uint32_t ins_id,
+                       uint16_t offset,
+                       uint8_t size,
+                       StreamDPOpCsUpdate & cs);
+
     void build_program();
 
+    void fuse_program();
+
     void alloc_bss();
 
     void free_bss();
@@ -1210,6 +1637,10 @@ private:
     StreamDPVmInstructions             m_instructions;
     
     StreamVmInstructionVar             *m_split_instr;
+    split_mode_e                        m_split_mode;
+
+    /* ipv4 headers that are fixed, valid while compiling */
+    std::vector<StreamVmCsHeader>      m_cs_table;
     
 };
 
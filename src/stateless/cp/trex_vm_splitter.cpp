@@ -61,120 +61,187 @@ TrexVmSplitter::split(TrexStream *stream, std::vector<TrexStream *> core_streams
 bool
 TrexVmSplitter::split_internal() {
 
-    const StreamVmInstructionVar *split_instr = m_stream->m_vm.get_split_instruction();
-
-    /* if no split instruction was specified - fall back*/
-    if (split_instr == NULL) {
+    /* one core gets the whole VM */
+    if (m_dp_core_count < 2) {
         return false;
     }
 
-    if (split_instr->get_instruction_type() == StreamVmInstruction::itFLOW_MAN) {
-        return split_by_flow_var( (const StreamVmInstructionFlowMan *)split_instr );
-
-    } else if (split_instr->get_instruction_type() == StreamVmInstruction::itFLOW_CLIENT) {
-        return split_by_flow_client_var( (const StreamVmInstructionFlowClient *)split_instr );
+    const std::vector<StreamVmInstruction *> &instructions = m_stream->m_vm.get_instruction_list();
+    const StreamVmInstructionVar *split_instr = m_stream->m_vm.get_split_instruction();
+    std::vector<uint32_t> split_vars;
 
-    } else {
-        throw TrexException("VM splitter : cannot split by instruction which is not flow var or flow client var");
+    if (split_instr) {
+        if ( (split_instr->get_instruction_type() != StreamVmInstruction::itFLOW_MAN) &&
+             (split_instr->get_instruction_type() != StreamVmInstruction::itFLOW_CLIENT) ) {
+            throw TrexException("VM splitter : cannot split by instruction which is not flow var or flow client var");
+        }
     }
 
-}
-
-/**
- * split VM by flow var 
- * 
- * @author imarom (20-Dec-15)
- * 
- * @param instr 
- * 
- * @return bool 
- */
-bool
-TrexVmSplitter::split_by_flow_var(const StreamVmInstructionFlowMan *instr) {
-    /* no point in splitting random */
-    if (instr->m_op == StreamVmInstructionFlowMan::FLOW_VAR_OP_RANDOM) {
-        return false;
+    /* the split instruction, or every var if none was specified */
+    for (uint32_t i = 0; i < instructions.size(); i++) {
+        if ( split_instr && (instructions[i] != split_instr) ) {
+            continue;
+        }
+        if (is_splitable(instructions[i])) {
+            split_vars.push_back(i);
+        }
     }
 
-    /* if the range is too small - it is unsplitable  */
-    if (instr->get_splitable_range() < m_dp_core_count) {
+    /* nothing to split - fall back */
+    if (split_vars.empty()) {
         return false;
     }
 
+    m_split_mode = m_stream->m_vm.get_split_mode();
+
     /* we need to split - duplicate VM now */
     duplicate_vm();
 
-    /* calculate range splitting */
-    uint64_t range = instr->get_splitable_range();
+    for (uint32_t index : split_vars) {
+        if (instructions[index]->get_instruction_type() == StreamVmInstruction::itFLOW_MAN) {
+            split_flow_var(index);
+        } else {
+            split_flow_client_var(index);
+        }
+    }
 
-    uint64_t range_part = range / m_dp_core_count;
-    uint64_t leftover   = range % m_dp_core_count;
+    for (TrexStream *core_stream : *m_core_streams) {
+        core_stream->vm_compile();
+    }
 
-    /* first core handles a bit more */
-    uint64_t start   = instr->m_min_value;
-    uint64_t end     = start + range_part + leftover - 1;
+    return true;
+}
 
+/**
+ * a var can be split if every core gets at least one value
+ */
+bool
+TrexVmSplitter::is_splitable(const StreamVmInstruction *instr) const {
 
-    /* do work */
-    for (TrexStream *core_stream : *m_core_streams) {
+    switch (instr->get_instruction_type()) {
+    case StreamVmInstruction::itFLOW_MAN:
+        return ( ((const StreamVmInstructionFlowMan *)instr)->get_splitable_range() >= m_dp_core_count );
 
-        /* get the per-core instruction to split */
-        StreamVmInstructionFlowMan *per_core_instr = (StreamVmInstructionFlowMan *)core_stream->m_vm.get_split_instruction();
+    case StreamVmInstruction::itFLOW_CLIENT:
+        return ( ((const StreamVmInstructionFlowClient *)instr)->get_ip_range() >= m_dp_core_count );
 
-        per_core_instr->m_min_value  = start;
-        per_core_instr->m_max_value  = end; 
+    default:
+        return false;
+    }
+}
 
-        /* after split this has no meaning - choose it as we see fit */
-        per_core_instr->m_init_value = (per_core_instr->m_op == StreamVmInstructionFlowMan::FLOW_VAR_OP_DEC ? end : start);
+/**
+ * the values of a var are indexed [0, count), get the indexes 
+ * of a core 
+ *  
+ * by block the first core handles a bit more, by stride core i 
+ * takes i, i + N, i + 2N ... 
+ */
+void
+TrexVmSplitter::get_core_part(uint8_t core_id,
+                              uint64_t count,
+                              uint64_t &first,
+                              uint64_t &last,
+                              uint64_t &step) const {
+
+    if (m_split_mode == StreamVm::SPLIT_BY_STRIDE) {
+        first = core_id;
+        last  = core_id + ((count - 1 - core_id) / m_dp_core_count) * m_dp_core_count;
+        step  = m_dp_core_count;
+        return;
+    }
 
-        core_stream->vm_compile();
+    uint64_t range_part = count / m_dp_core_count;
+    uint64_t leftover   = count % m_dp_core_count;
 
-        start = end + 1;
-        end   = start + range_part - 1;
+    if (core_id == 0) {
+        first = 0;
+        last  = range_part + leftover - 1;
+    } else {
+        first = leftover + core_id * range_part;
+        last  = first + range_part - 1;
     }
-
-    return true;
+    step = 1;
 }
 
+/**
+ * split VM by flow var 
+ * 
+ * @author imarom (20-Dec-15)
+ * 
+ * @param index of the var in the VM
+ */
+void
+TrexVmSplitter::split_flow_var(uint32_t index) {
+
+    const StreamVmInstructionFlowMan *instr = (const StreamVmInstructionFlowMan *)m_stream->m_vm.get_instruction_list()[index];
 
-bool
-TrexVmSplitter::split_by_flow_client_var(const StreamVmInstructionFlowClient *instr) {
+    uint64_t count = instr->get_splitable_range();
 
-    /* if the range is too small - it is unsplitable  */
-    if (instr->get_ip_range() < m_dp_core_count) {
-        return false;
+    /* index of the init value */
+    uint64_t init = (instr->m_init_value - instr->m_min_value) / instr->m_step;
+    if ( (instr->m_init_value < instr->m_min_value) || (init >= count) ) {
+        init = 0;
     }
 
-    /* we need to split - duplicate VM now */
-    duplicate_vm();
+    for (uint8_t core_id = 0; core_id < m_dp_core_count; core_id++) {
 
-    /* calculate range splitting */
-    uint64_t range = instr->get_ip_range();
+        /* get the per-core instruction to split */
+        StreamVmInstructionFlowMan *per_core_instr = (StreamVmInstructionFlowMan *)(*m_core_streams)[core_id]->m_vm.get_instruction_list()[index];
+
+        uint64_t first, last, step;
+        get_core_part(core_id, count, first, last, step);
+
+        /* where the core starts */
+        uint64_t start;
+        if (m_split_mode == StreamVm::SPLIT_BY_STRIDE) {
+            /* the value of the core that is next to the init value in the original order */
+            switch (instr->m_op) {
+            case StreamVmInstructionFlowMan::FLOW_VAR_OP_INC:
+                start = init + ((first + step - (init % step)) % step);
+                if (start > last) {
+                    start = first;
+                }
+                break;
+            case StreamVmInstructionFlowMan::FLOW_VAR_OP_DEC:
+                start = (init < first) ? last : (init - ((init - first) % step));
+                break;
+            default:
+                start = first;
+                break;
+            }
+        } else {
+            /* after split this has no meaning - choose it as we see fit */
+            start = (instr->m_op == StreamVmInstructionFlowMan::FLOW_VAR_OP_DEC ? last : first);
+        }
 
-    uint64_t range_part = range / m_dp_core_count;
-    uint64_t leftover   = range % m_dp_core_count;
+        per_core_instr->m_min_value  = instr->m_min_value + first * instr->m_step;
+        per_core_instr->m_max_value  = instr->m_min_value + last * instr->m_step;
+        per_core_instr->m_init_value = instr->m_min_value + start * instr->m_step;
+        per_core_instr->m_step       = instr->m_step * step;
+    }
+}
 
-    /* first core handles a bit more */
-    uint64_t start   = instr->m_client_min;
-    uint64_t end     = start + range_part + leftover - 1;
 
+void
+TrexVmSplitter::split_flow_client_var(uint32_t index) {
 
-    /* do work */
-    for (TrexStream *core_stream : *m_core_streams) {
+    const StreamVmInstructionFlowClient *instr = (const StreamVmInstructionFlowClient *)m_stream->m_vm.get_instruction_list()[index];
 
-        /* get the per-core instruction to split */
-        StreamVmInstructionFlowClient *per_core_instr = (StreamVmInstructionFlowClient *)core_stream->m_vm.get_split_instruction();
+    uint64_t count = instr->get_ip_range();
 
-        per_core_instr->m_client_min  = start;
-        per_core_instr->m_client_max  = end; 
+    for (uint8_t core_id = 0; core_id < m_dp_core_count; core_id++) {
 
-        core_stream->vm_compile();
+        /* get the per-core instruction to split */
+        StreamVmInstructionFlowClient *per_core_instr = (StreamVmInstructionFlowClient *)(*m_core_streams)[core_id]->m_vm.get_instruction_list()[index];
 
-        start = end + 1;
-        end   = start + range_part - 1;
-    }
+        uint64_t first, last, step;
+        get_core_part(core_id, count, first, last, step);
 
-    return true;
+        per_core_instr->m_client_min = instr->m_client_min + first;
+        per_core_instr->m_client_max = instr->m_client_min + last;
+        per_core_instr->m_ip_step    = (uint8_t)step;
+    }
 }
 
 /**
@@ -27,6 +27,16 @@ limitations under the License.
  * TRex VM splitter is used to split 
  * VM instructions around cores 
  *  
+ * the values of a flow var ( inc/dec/random ) or the ips of a 
+ * client var are divided between the cores so the cores never 
+ * generate the same value. the var of the split instruction is 
+ * split, without a split instruction every var that has enough 
+ * values is split. 
+ *  
+ * SPLIT_BY_BLOCK gives each core a contiguous part of the 
+ * values, SPLIT_BY_STRIDE gives core i every N-th value 
+ * starting at the i-th so the cores together keep the order 
+ * of the original sequence 
  * 
  * @author imarom (23-Dec-15)
  */
@@ -36,6 +46,7 @@ public:
 
     TrexVmSplitter() {
         m_dp_core_count = 0;
+        m_split_mode    = StreamVm::SPLIT_BY_BLOCK;
     }
 
     /**
@@ -46,14 +57,23 @@ public:
 
 private:
     bool split_internal();
-    bool split_by_flow_var(const StreamVmInstructionFlowMan *instr);
-    bool split_by_flow_client_var(const StreamVmInstructionFlowClient *instr);
+    bool is_splitable(const StreamVmInstruction *instr) const;
+    void split_flow_var(uint32_t index);
+    void split_flow_client_var(uint32_t index);
+
+    /* part of [0, count) of a core, first/last index and the index step */
+    void get_core_part(uint8_t core_id,
+                       uint64_t count,
+                       uint64_t &first,
+                       uint64_t &last,
+                       uint64_t &step) const;
 
     void duplicate_vm();
 
     TrexStream                 *m_stream;
     std::vector<TrexStream *>  *m_core_streams;
     uint8_t                     m_dp_core_count;
+    StreamVm::split_mode_e      m_split_mode;
 };
 
 
@@ -125,6 +125,24 @@ std::string CGenNodeStateless::get_stream_state_str(stream_state_t stream_state)
 }
 
 
+static_assert(_128_MBUF_SIZE >= CGenNodeStateless::SL_PREFIX_FAST_MAX, "the smallest mbuf must hold a fast prefix" );
+
+/**
+ * copy the prefix of the packet into a new mbuf. 
+ * up to SL_PREFIX_FAST_MAX the copy is one or two whole lines with a 
+ * constant size, the compiler turns it into a few vector moves. the 
+ * source is padded to a line and the mbuf has room for the lines 
+ */
+static inline void stl_copy_prefix(uint8_t *dst, const uint8_t *src, uint16_t size){
+    if ( odp_likely(size <= CGenNodeStateless::SL_PREFIX_LINE) ) {
+        memcpy(dst, src, CGenNodeStateless::SL_PREFIX_LINE);
+    }else if ( size <= CGenNodeStateless::SL_PREFIX_FAST_MAX ) {
+        memcpy(dst, src, CGenNodeStateless::SL_PREFIX_FAST_MAX);
+    }else{
+        memcpy(dst, src, size);
+    }
+}
+
 rte_mbuf_t   * CGenNodeStateless::alloc_node_with_vm(){
 
     rte_mbuf_t        * m;
@@ -137,22 +155,53 @@ rte_mbuf_t   * CGenNodeStateless::alloc_node_with_vm(){
     /* TBD remove this, should handle cases of error */
     assert(m);
     char *p=rte_pktmbuf_append(m, prefix_size);
-    memcpy( p ,m_original_packet_data_prefix, prefix_size); 
+    stl_copy_prefix((uint8_t *)p, m_original_packet_data_prefix, prefix_size);
 
 
     /* run the VM program */
     StreamDPVmInstructionsRunner runner;
 
-    runner.run( (uint32_t*)m_vm_flow_var,
+    runner.run( (uint64_t*)m_vm_flow_var,
                 m_vm_program_size, 
                 m_vm_program,
                 m_vm_flow_var,
                 (uint8_t*)p);
 
+    if ( m_flags & SL_NODE_RX_SIG ) {
+        TrexStreamRxSig * sig = (TrexStreamRxSig *)(p + m_rx_sig_off);
+        uint32_t old_sum = 0;
+        if ( m_rx_csum_off ) {
+            old_sum = pkt_SumInetChecksum((uint8_t *)sig, sizeof(TrexStreamRxSig));
+        }
+        sig->m_magic  = TrexStreamRxSig::MAGIC;
+        sig->m_flags  = m_rx_flags;
+        sig->m_rx_id  = m_rx_id;
+        sig->m_seq    = m_rx_seq++;
+        /* the simulation uses the node time so the output is the same on each run */
+        sig->m_time_stamp = CGlobalInfo::is_realtime() ? os_get_hr_tick_64() :
+                            (uint64_t)(m_time * (double)TrexStreamRxSig::SIM_TICK_HZ);
+        if ( m_rx_csum_off ) {
+            /* the signature is inside the L4 payload, keep the checksum valid */
+            uint16_t * csum = (uint16_t *)(p + m_rx_csum_off);
+            uint32_t   new_sum = pkt_SumInetChecksum((uint8_t *)sig, sizeof(TrexStreamRxSig));
+            uint16_t   v = pkt_ApplyInetChecksumDelta(*csum, pkt_DeltaInetChecksum(old_sum, new_sum));
+            if ( (v == 0) && m_rx_csum_udp ) {
+                /* zero is no checksum for udp */
+                v = 0xffff;
+            }
+            *csum = v;
+        }
+    }
 
     rte_mbuf_t * m_const = get_const_mbuf();
     if (  m_const != NULL) {
-        utl_rte_pktmbuf_add_after(m,m_const);
+        /* the references are taken for a batch ( at least a burst ) of packets at once */
+        if ( odp_unlikely(m_const_refs == 0) ) {
+            m_const_refs = (m_burst > SL_CONST_REFS_BATCH) ? m_burst : SL_CONST_REFS_BATCH;
+            rte_mbuf_refcnt_update(m_const, m_const_refs);
+        }
+        m_const_refs--;
+        utl_rte_pktmbuf_add_after2(m,m_const);
     }
     return (m);
 }
@@ -162,12 +211,18 @@ void CGenNodeStateless::free_stl_node(){
     /* if we have cache mbuf free it */
     rte_mbuf_t * m=get_cache_mbuf();
     if (m) {
+        rte_pktmbuf_set_static(m, false);
         rte_pktmbuf_free(m);
         m_cache_mbuf=0;
     }else{
         /* non cache - must have an header */
          m=get_const_mbuf();
          if (m) {
+             /* give back the references that were not used */
+             if (m_const_refs) {
+                 rte_mbuf_refcnt_update(m, -(int16_t)m_const_refs);
+                 m_const_refs=0;
+             }
              rte_pktmbuf_free(m); /* reduce the ref counter */
          }
          free_prefix_header();
@@ -300,6 +355,21 @@ TrexStatelessDpCore::create(uint8_t thread_id, CFlowGenListPerThread *core) {
     for (i=0; i<NUM_PORTS_PER_CORE; i++) {
         m_ports[i].create(core);
     }
+
+    if ( m_tx_stats == NULL ) {
+        void * p = NULL;
+        if ( posix_memalign(&p, 64, sizeof(TrexStreamsTxStats)) != 0 ) {
+            p = NULL;
+        }
+        assert(p);
+        m_tx_stats = (TrexStreamsTxStats *)p;
+    }
+    m_tx_stats->create();
+}
+
+TrexStatelessDpCore::~TrexStatelessDpCore() {
+    free(m_tx_stats);
+    m_tx_stats = NULL;
 }
 
 
@@ -524,7 +594,10 @@ TrexStatelessDpCore::add_stream(TrexStatelessDpPerPort * lp_port,
     const uint8_t *stream_pkt = stream->m_pkt.binary;
 
     node->m_pause =0;
+    node->m_const_refs =0;
     node->m_stream_type = stream->m_type;
+    node->m_tx_stats    = m_tx_stats->get_counters(stream->m_port_id - m_local_port_offset, stream->m_stream_id);
+    node->m_tx_pkt_len  = pkt_size;
     node->m_next_time_offset = 1.0 / stream->get_pps();
 
     /* stateless specific fields */
@@ -556,13 +629,34 @@ TrexStatelessDpCore::add_stream(TrexStatelessDpPerPort * lp_port,
         assert(0);
     };
 
+    node->update_burst();
     node->m_port_id = stream->m_port_id;
 
     /* set dir 0 or 1 client or server */
     node->set_mbuf_cache_dir(dir);
 
 
-    if (node->m_ref_stream_info->getDpVm() == NULL) {
+    /* rx streams carry a signature after the L4 header of each packet */
+    bool rx_sig = stream->m_rx_check.m_enable;
+    bool csum_udp = false;
+    node->m_rx_sig_off  = 0;
+    node->m_rx_csum_off = 0;
+    if ( rx_sig && !TrexStreamRxSig::get_offset(stream_pkt, pkt_size, node->m_rx_sig_off, node->m_rx_csum_off, &csum_udp) ) {
+        /* validated by the RPC, no place for the signature */
+        rx_sig = false;
+    }
+    node->m_rx_csum_udp = csum_udp ? 1 : 0;
+    node->m_rx_id    = rx_sig ? stream->m_rx_check.m_stream_id : 0;
+    node->m_rx_seq   = 0;
+    node->m_rx_flags = (m_core->m_thread_id & TrexStreamRxSig::CORE_MASK);
+    if ( stream->m_rx_check.m_seq_enabled ) {
+        node->m_rx_flags |= TrexStreamRxSig::F_SEQ;
+    }
+    if ( stream->m_rx_check.m_latency ) {
+        node->m_rx_flags |= TrexStreamRxSig::F_LATENCY;
+    }
+
+    if ( (node->m_ref_stream_info->getDpVm() == NULL) && !rx_sig ) {
         /* no VM */
 
         node->m_vm_flow_var =  NULL;
@@ -581,6 +675,11 @@ TrexStatelessDpCore::add_stream(TrexStatelessDpPerPort * lp_port,
         /* TBD repace the mac if req we should add flag  */
         m_core->m_node_gen.m_v_if->update_mac_addr_from_global_cfg(dir,(uint8_t*) p);
     
+        /* pre-built packet that the tx path sends without refcnt/free */
+        if ( CGlobalInfo::m_options.preview.getStlStaticMbuf() ) {
+            rte_pktmbuf_set_static(m, true);
+        }
+
         /* set the packet as a readonly */
         node->set_cache_mbuf(m);
 
@@ -591,16 +690,38 @@ TrexStatelessDpCore::add_stream(TrexStatelessDpPerPort * lp_port,
         TrexStream * local_mem_stream = node->m_ref_stream_info;
 
         StreamVmDp  * lpDpVm = local_mem_stream->getDpVm();
+        uint16_t header_size;
 
-        node->m_vm_flow_var      = lpDpVm->clone_bss(); /* clone the flow var */
-        node->m_vm_program       = lpDpVm->get_program(); /* same ref to the program */
-        node->m_vm_program_size  = lpDpVm->get_program_size();
+        if ( lpDpVm ) {
+            node->m_vm_flow_var      = lpDpVm->clone_bss(); /* clone the flow var */
+            node->m_vm_program       = lpDpVm->get_program(); /* same ref to the program */
+            node->m_vm_program_size  = lpDpVm->get_program_size();
 
+            if (lpDpVm->get_prefix_size() > pkt_size ) {
+                lpDpVm->set_prefix_size(pkt_size);
+            }
+            header_size = lpDpVm->get_prefix_size();
+        }else{
+            /* rx stream without VM, only the signature is written */
+            node->m_vm_flow_var      = NULL;
+            node->m_vm_program       = NULL;
+            node->m_vm_program_size  = 0;
+            header_size = 0;
+        }
+
+        if ( rx_sig ) {
+            /* the prefix holds the signature, the rest of the packet stays const */
+            node->m_flags |= CGenNodeStateless::SL_NODE_RX_SIG;
+            uint16_t sig_end = node->m_rx_sig_off + sizeof(TrexStreamRxSig);
+            if ( header_size < sig_end ) {
+                header_size = sig_end;
+            }
+        }
 
         /* we need to copy the object */
-        if ( pkt_size > lpDpVm->get_prefix_size() ) {
+        if ( pkt_size > header_size ) {
             /* we need const packet */
-            uint16_t const_pkt_size  = pkt_size - lpDpVm->get_prefix_size() ;
+            uint16_t const_pkt_size  = pkt_size - header_size;
             rte_mbuf_t *m = CGlobalInfo::pktmbuf_alloc(node->get_socket_id(), const_pkt_size );
             assert(m);
 
@@ -608,18 +729,12 @@ TrexStatelessDpCore::add_stream(TrexStatelessDpPerPort * lp_port,
             assert(p);
 
             /* copy packet data */
-            memcpy(p,(stream_pkt + lpDpVm->get_prefix_size()),const_pkt_size);
+            memcpy(p,(stream_pkt + header_size),const_pkt_size);
 
             node->set_const_mbuf(m);
         }
 
-
-        if (lpDpVm->get_prefix_size() > pkt_size ) {
-            lpDpVm->set_prefix_size(pkt_size);
-        }
-
         /* copy the headr */
-        uint16_t header_size = lpDpVm->get_prefix_size();
         assert(header_size);
         node->alloc_prefix_header(header_size);
         uint8_t *p=node->m_original_packet_data_prefix;
@@ -657,6 +772,8 @@ TrexStatelessDpCore::start_traffic(TrexStreamsCompiledObj *obj,
     /* no nodes in the list */
     assert(lp_port->m_active_nodes.size()==0);
 
+    m_tx_stats->start_port(obj->get_port_id() - m_local_port_offset, event_id, obj->get_objects().size());
+
     for (auto single_stream : obj->get_objects()) {
         /* all commands should be for the same port */
         assert(obj->get_port_id() == single_stream.m_stream->m_port_id);
@@ -763,6 +880,8 @@ TrexStatelessDpCore::stop_traffic(uint8_t port_id,
                                                                    lp_port->get_event_id());
     ring->Enqueue((CGenNode *)event_msg);
 
+    /* the final counters of the port */
+    m_tx_stats->publish();
 }
 
 /**
@@ -26,6 +26,7 @@ limitations under the License.
 
 #include <msg_manager.h>
 #include <pal_utl.h>
+#include <trex_stream_tx_stats.h>
 
 class TrexStatelessCpToDpMsgBase;
 class TrexStatelessDpStart;
@@ -119,8 +120,11 @@ public:
         m_thread_id = 0;
         m_core = NULL;
         m_duration = -1;
+        m_tx_stats = NULL;
     }
 
+    ~TrexStatelessDpCore();
+
     /**
      * "static constructor"
      * 
@@ -188,20 +192,23 @@ public:
     void periodic_check_for_cp_messages() {
         // doing this inline for performance reasons
 
+        /* every sync, the CP reads the streams counters from the copy */
+        m_tx_stats->publish();
+
         /* fast path */
         if ( odp_likely ( m_ring_from_cp->isEmpty() ) ) {
             return;
         }
 
-        while ( true ) {
-            CGenNode * node = NULL;
-            if (m_ring_from_cp->Dequeue(node) != 0) {
-                break;
+        CGenNode * nodes[MSG_DEQUEUE_BURST];
+        uint32_t cnt;
+        while ( (cnt = m_ring_from_cp->DequeueBurst(nodes, MSG_DEQUEUE_BURST)) > 0 ) {
+            uint32_t i;
+            for (i = 0; i < cnt; i++) {
+                assert(nodes[i]);
+                TrexStatelessCpToDpMsgBase * msg = (TrexStatelessCpToDpMsgBase *)nodes[i];
+                handle_cp_msg(msg);
             }
-            assert(node);
-
-            TrexStatelessCpToDpMsgBase * msg = (TrexStatelessCpToDpMsgBase *)node;
-            handle_cp_msg(msg);
         }
 
     }
@@ -217,6 +224,11 @@ public:
                                  CGenNodeStateless * next_node);
 
 
+    /* read by the CP, see TrexStreamsTxStats */
+    const TrexStreamsTxStats * get_tx_stats() const {
+        return (m_tx_stats);
+    }
+
     TrexStatelessDpPerPort * get_port_db(uint8_t port_id){
         assert((m_local_port_offset==port_id) ||(m_local_port_offset+1==port_id));
         uint8_t local_port_id = port_id -m_local_port_offset;
@@ -277,6 +289,8 @@ private:
     CFlowGenListPerThread   * m_core;
 
     double                 m_duration;
+
+    TrexStreamsTxStats   * m_tx_stats; /* per stream tx counters */
 };
 
 #endif /* __TREX_STATELESS_DP_CORE_H__ */
@@ -27,6 +27,8 @@ limitations under the License.
 
 class TrexStatelessDpCore;
 #include <trex_stream.h>
+#include <trex_stream_tx_stats.h>
+#include <trex_stream_rx_stats.h>
 
 class TrexStatelessCpToDpMsgBase;
 class CFlowGenListPerThread;
@@ -60,10 +62,17 @@ public:
         SL_NODE_FLAGS_DIR                  =1, //USED by master
         SL_NODE_FLAGS_MBUF_CACHE           =2, //USED by master
 
-        SL_NODE_CONST_MBUF                =4
+        SL_NODE_CONST_MBUF                =4,
+        SL_NODE_RX_SIG                    =8  /* write TrexStreamRxSig after the L4 header of each packet */
 
     };
 
+    enum {
+        SL_PREFIX_LINE          = 64,  /* the prefix is kept and copied in whole lines */
+        SL_PREFIX_FAST_MAX      = 128, /* up to this size the copy is unrolled */
+        SL_CONST_REFS_BATCH     = 64   /* const mbuf references taken at once */
+    };
+
     enum {                                          
             ss_FREE_RESUSE =1, /* should be free by scheduler */
             ss_INACTIVE    =2, /* will be active by other stream or stopped */
@@ -102,13 +111,20 @@ private:
     uint8_t *            m_vm_flow_var; /* pointer to the vm flow var */
     uint8_t *            m_vm_program;  /* pointer to the program */
     uint16_t             m_vm_program_size; /* up to 64K op codes */
-    uint16_t             m_pad2;
-    uint32_t             m_pad3;
+    uint16_t             m_burst;  /* packets per event in continues mode */
+    uint32_t             m_const_refs; /* references of the const mbuf that were taken and not used yet */
 
     /* End Fast Field VM Section */
 
-    /* pad to match the size of CGenNode */
-    uint8_t             m_pad_end[20];
+    TrexStreamTxCounters * m_tx_stats;  /* per core counters of the stream */
+    uint16_t             m_tx_pkt_len;
+
+    uint16_t             m_rx_id;     /* rx_stats stream_id, valid with SL_NODE_RX_SIG */
+    uint32_t             m_rx_seq;    /* next sequence of the signature */
+    uint8_t              m_rx_flags;  /* TrexStreamRxSig flags and the TX core */
+    uint8_t              m_rx_csum_udp; /* m_rx_csum_off is a udp checksum, never 0 */
+    uint16_t             m_rx_sig_off;  /* offset of the signature in the prefix */
+    uint16_t             m_rx_csum_off; /* offset of the L4 checksum, zero for none */
 
 
 public:
@@ -126,6 +142,23 @@ public:
     void update_rate(double factor) {
         /* update the inter packet gap */
         m_next_time_offset         =  m_next_time_offset / factor;
+        update_burst();
+    }
+
+    /**
+     * a fast continues stream sends m_burst packets per event, 
+     * the burst span is bounded by ( burst - 1 ) * threshold 
+     * 
+     */
+    inline void update_burst(){
+        CParserOption * po = &CGlobalInfo::m_options;
+        if ( (m_stream_type == TrexStream::stCONTINUOUS) &&
+             (po->m_stl_burst > 1) &&
+             (m_next_time_offset < usec_to_sec(po->m_stl_burst_thr_usec)) ) {
+            m_burst = po->m_stl_burst;
+        }else{
+            m_burst = 1;
+        }
     }
 
     /* we restart the stream, schedule it using stream isg */
@@ -183,11 +216,23 @@ public:
 
     void refresh();
 
+    /* no branch, a paused stream adds zero */
+    inline void update_tx_stats(uint32_t pkts) {
+        m_tx_stats->m_pkts  += pkts;
+        m_tx_stats->m_bytes += pkts * m_tx_pkt_len;
+    }
+
     inline void handle_continues(CFlowGenListPerThread *thread) {
 
+        if (odp_unlikely (m_burst > 1)) {
+            handle_continues_burst(thread);
+            return;
+        }
+
         if (odp_unlikely (is_pause()==false)) {
             thread->m_node_gen.m_v_if->send_node( (CGenNode *)this);
         }
+        update_tx_stats(m_pause ^ 1);
 
         /* in case of continues */
         m_time += m_next_time_offset;
@@ -196,8 +241,35 @@ public:
         thread->m_node_gen.m_p_queue.push( (CGenNode *)this);
     }
 
+    /* send m_burst packets back to back, each with its own time, one event for all */
+    inline void handle_continues_burst(CFlowGenListPerThread *thread) {
+        CNodeGenerator * gen = &thread->m_node_gen;
+        bool paused = is_pause();
+        uint16_t i;
+
+        for (i=0; i<m_burst; i++) {
+            if ( paused==false ) {
+                gen->m_v_if->send_node( (CGenNode *)this);
+            }
+            m_time += m_next_time_offset;
+        }
+
+        update_tx_stats(m_burst * (m_pause ^ 1));
+
+        gen->m_stl_burst_events++;
+        gen->m_stl_burst_pkts += m_burst;
+        double span = (m_burst - 1) * m_next_time_offset;
+        if ( span > gen->m_stl_burst_max_span ) {
+            gen->m_stl_burst_max_span = span;
+        }
+
+        /* insert a new event */
+        gen->m_p_queue.push( (CGenNode *)this);
+    }
+
     inline void handle_multi_burst(CFlowGenListPerThread *thread) {
         thread->m_node_gen.m_v_if->send_node( (CGenNode *)this);
+        update_tx_stats(1);
 
         m_single_burst--;
         if (m_single_burst > 0 ) {
@@ -295,11 +367,21 @@ public:
         }
     }
 
-    /* prefix header exits only in non cache mode size is 64/128/512  other are not possible right now */
+    /**
+     * prefix header exits only in non cache mode. 
+     * the buffer is line aligned and padded with zeros to a whole line 
+     * so the prefix can be copied in lines 
+     */
     inline void alloc_prefix_header(uint16_t size){
+         void *p;
+         uint16_t alloc_size = (size + SL_PREFIX_LINE - 1) & ~(SL_PREFIX_LINE - 1);
+
          set_prefix_header_size(size);
-         m_original_packet_data_prefix = (uint8_t *)malloc(size);
-         assert(m_original_packet_data_prefix);
+         if ( posix_memalign(&p, SL_PREFIX_LINE, alloc_size) != 0 ) {
+             assert(0);
+         }
+         memset(p, 0, alloc_size);
+         m_original_packet_data_prefix = (uint8_t *)p;
     }
 
     inline void free_prefix_header(){
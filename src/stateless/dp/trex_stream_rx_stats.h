@@ -0,0 +1,331 @@
+/*
+Copyright (c) 2015-2015 Cisco Systems, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#ifndef __TREX_STREAM_RX_STATS_H__
+#define __TREX_STREAM_RX_STATS_H__
+
+#include <stdint.h>
+#include <string.h>
+#include <os_time.h>
+#include <time_histogram.h>
+#include <utl_jitter.h>
+
+/**
+ * signature of a stream with rx_stats, the first bytes of the L4 payload.
+ * the TX writes it into the prefix of the packet, see
+ * CGenNodeStateless::alloc_node_with_vm, the RX finds it with get_offset
+ * and looks for the magic
+ *
+ * host byte order. the time stamp is the hr tick of the TX core, the
+ * sequence is per TX core as each DP core sends its own part of a stream
+ */
+struct TrexStreamRxSig {
+    enum {
+        MAGIC      = 0xab,
+
+        F_SEQ      = 0x80, /* m_seq is valid */
+        F_LATENCY  = 0x40, /* m_time_stamp is valid */
+        CORE_MASK  = 0x3f, /* TX DP core */
+
+        /* the shortest frame without the crc */
+        MIN_PKT_SIZE = 60,
+
+        /* the simulation has no clock, its time stamps are nsec of the node time */
+        SIM_TICK_HZ  = 1000000000
+    };
+
+    uint8_t   m_magic;
+    uint8_t   m_flags;
+    uint16_t  m_rx_id;      /* rx_stats stream_id */
+    uint32_t  m_seq;
+    uint64_t  m_time_stamp;
+
+    /**
+     * offset of the signature in an ipv4/ipv6 udp/tcp packet with up to two
+     * vlan tags, after the L4 header. csum_off is the offset of the L4
+     * checksum, zero for udp without a checksum. udp, when given, is set
+     * for a udp checksum, which must not be updated to zero
+     *
+     * return false if the packet has no room for the signature inside the
+     * L4 payload
+     */
+    static inline bool get_offset(const uint8_t * pkt, uint32_t len,
+                                  uint16_t & sig_off, uint16_t & csum_off,
+                                  bool * udp = NULL){
+        uint32_t off = 12;
+        uint16_t type;
+        int i;
+        for (i=0; i<3; i++) {
+            if ( off + 2 > len ) {
+                return (false);
+            }
+            type = (pkt[off] << 8) | pkt[off+1];
+            if ( (type != 0x8100) && (type != 0x88a8) ) {
+                break;
+            }
+            off += 4;
+        }
+        off += 2;
+
+        uint32_t l3_end;
+        uint8_t  proto;
+        switch (type) {
+        case 0x0800:
+            if ( (off + 20 > len) || (pkt[off] < 0x45) || ((pkt[off] >> 4) != 4) ) {
+                return (false);
+            }
+            /* a fragment has no L4 header or only a part of the payload */
+            if ( ((pkt[off+6] & 0x3f) | pkt[off+7]) != 0 ) {
+                return (false);
+            }
+            l3_end = off + ((pkt[off+2] << 8) | pkt[off+3]);
+            proto  = pkt[off+9];
+            off   += (pkt[off] & 0xf) * 4;
+            break;
+        case 0x86dd:
+            if ( off + 40 > len ) {
+                return (false);
+            }
+            l3_end = off + 40 + ((pkt[off+4] << 8) | pkt[off+5]);
+            proto  = pkt[off+6];
+            off   += 40;
+            break;
+        default:
+            return (false);
+        }
+
+        switch (proto) {
+        case 17:
+            if ( off + 8 > len ) {
+                return (false);
+            }
+            csum_off = ( (pkt[off+6] | pkt[off+7]) != 0 ) ? (off + 6) : 0;
+            if ( udp ) {
+                *udp = true;
+            }
+            off += 8;
+            break;
+        case 6:
+            if ( (off + 20 > len) || ((pkt[off+12] >> 4) < 5) ) {
+                return (false);
+            }
+            csum_off = off + 16;
+            if ( udp ) {
+                *udp = false;
+            }
+            off += (pkt[off+12] >> 4) * 4;
+            break;
+        default:
+            return (false);
+        }
+
+        if ( (off + sizeof(TrexStreamRxSig) > l3_end) || (l3_end > len) ) {
+            return (false);
+        }
+        sig_off = off;
+        return (true);
+    }
+} __attribute__((packed));
+
+static_assert(sizeof(TrexStreamRxSig) == 16, "sizeof(TrexStreamRxSig) != 16" );
+
+
+/* rx counters of one rx_stats stream_id */
+struct TrexStreamRxCounters {
+    uint64_t m_pkts;
+    uint64_t m_bytes;
+    uint64_t m_seq_drop;   /* sequence numbers that did not arrive */
+    uint64_t m_seq_ooo;    /* arrived after a higher sequence number */
+    uint64_t m_seq_dup;    /* a sequence number that already arrived */
+
+    void Add(const TrexStreamRxCounters & o){
+        m_pkts     += o.m_pkts;
+        m_bytes    += o.m_bytes;
+        m_seq_drop += o.m_seq_drop;
+        m_seq_ooo  += o.m_seq_ooo;
+        m_seq_dup  += o.m_seq_dup;
+    }
+
+    void Sub(const TrexStreamRxCounters & o){
+        m_pkts     -= o.m_pkts;
+        m_bytes    -= o.m_bytes;
+        m_seq_drop -= o.m_seq_drop;
+        m_seq_ooo  -= o.m_seq_ooo;
+        m_seq_dup  -= o.m_seq_dup;
+    }
+};
+
+
+/**
+ * rx counters and latency of the rx_stats packets that one DP core
+ * sent, indexed by the rx_stats stream_id of the signature
+ *
+ * the RX passes the signatures to the DP core that sent them, which is
+ * the only writer. as the latency
+ * histograms the CP reads them while they are written, each counter is
+ * read whole but the counters of an id are not one snapshot
+ */
+class TrexStreamsRxStats {
+
+public:
+    enum {
+        MAX_IDS         = 1024, /* rx_stats stream_id range */
+        MAX_LATENCY_IDS = 32,   /* ids below it have a latency histogram */
+        MAX_TX_CORES    = (TrexStreamRxSig::CORE_MASK + 1)
+    };
+
+    /* hr_freq is the tick rate of the time stamps */
+    void create(hr_time_t hr_freq = os_get_hr_freq()){
+        memset(m_cnt, 0, sizeof(m_cnt));
+        memset(m_next_seq, 0, sizeof(m_next_seq));
+        memset(m_seq_missed, 0, sizeof(m_seq_missed));
+        m_no_sig = 0;
+        int i;
+        for (i=0; i<MAX_LATENCY_IDS; i++) {
+            m_lat[i].m_hist.Reset();
+            m_lat[i].m_jitter.reset();
+        }
+        m_nsec_per_tick = 1000000000.0 / (double)hr_freq;
+    }
+
+    /**************************** DP side ****************************/
+
+    /* one received packet, now is the hr tick of the RX */
+    inline void handle_pkt(const uint8_t * pkt, uint32_t len, hr_time_t now){
+        uint16_t sig_off;
+        uint16_t csum_off;
+        if ( odp_unlikely(!TrexStreamRxSig::get_offset(pkt, len, sig_off, csum_off)) ) {
+            m_no_sig++;
+            return;
+        }
+
+        handle_sig((const TrexStreamRxSig *)(pkt + sig_off), len, now);
+    }
+
+    /* the signature of a packet of len bytes, found by the RX with TrexStreamRxSig::get_offset */
+    inline void handle_sig(const TrexStreamRxSig * sig, uint32_t len, hr_time_t now){
+        if ( odp_unlikely( (sig->m_magic != TrexStreamRxSig::MAGIC) || (sig->m_rx_id >= MAX_IDS) ) ) {
+            m_no_sig++;
+            return;
+        }
+
+        uint16_t id = sig->m_rx_id;
+        TrexStreamRxCounters * c = &m_cnt[id];
+        c->m_pkts++;
+        c->m_bytes += len;
+
+        if ( sig->m_flags & TrexStreamRxSig::F_SEQ ) {
+            uint8_t core = sig->m_flags & TrexStreamRxSig::CORE_MASK;
+            check_seq(c, &m_next_seq[id][core], &m_seq_missed[id][core], sig->m_seq);
+        }
+
+        if ( (sig->m_flags & TrexStreamRxSig::F_LATENCY) && (id < MAX_LATENCY_IDS) ) {
+            int64_t  d    = (int64_t)(now - sig->m_time_stamp);
+            uint64_t nsec = ( d > 0 ) ? (uint64_t)((double)d * m_nsec_per_tick) : 0;
+            m_lat[id].m_hist.Add(nsec);
+            m_lat[id].m_jitter.calc((uint32_t)nsec);
+        }
+    }
+
+    /* packets the RX did not find a signature in */
+    inline void add_no_sig(uint32_t cnt){
+        m_no_sig += cnt;
+    }
+
+    /**************************** CP side ****************************/
+
+    void get_counters(uint16_t id, TrexStreamRxCounters & c) const {
+        c = m_cnt[id];
+    }
+
+    const CHdrHistogram & get_latency(uint16_t id) const {
+        return (m_lat[id].m_hist);
+    }
+
+    uint32_t get_jitter_nsec(uint16_t id) const {
+        CJitterUint j = m_lat[id].m_jitter;
+        return (j.get_jitter());
+    }
+
+    /* packets without a valid signature */
+    uint64_t get_no_sig() const {
+        return (m_no_sig);
+    }
+
+private:
+
+    /**
+     * next holds the next expected sequence + 1, zero before the first
+     * packet. a sequence of zero is a new run of the stream.
+     *
+     * bit i of missed is set when the sequence i+1 before the expected one
+     * was counted as a drop, a late packet clears it. a late packet with
+     * its bit clear is a duplicate. one older than the 64 bits is taken as
+     * out of order
+     */
+    static inline void check_seq(TrexStreamRxCounters * c, uint32_t * next,
+                                 uint64_t * missed, uint32_t seq){
+        uint32_t exp = *next - 1;
+        if ( odp_likely(seq == exp) ) {
+            *missed <<= 1;
+            *next = seq + 2;
+            return;
+        }
+        if ( (*next == 0) || (seq == 0) ) {
+            *missed = 0;
+            *next = seq + 2;
+            return;
+        }
+        if ( (int32_t)(seq - exp) > 0 ) {
+            uint32_t gap = seq - exp;
+            c->m_seq_drop += gap;
+            if ( gap < 63 ) {
+                *missed = (*missed << (gap + 1)) | (((1ULL << gap) - 1) << 1);
+            }else{
+                *missed = ~1ULL;
+            }
+            *next = seq + 2;
+            return;
+        }
+
+        uint32_t age = exp - 1 - seq;
+        if ( age < 64 ) {
+            if ( (*missed & (1ULL << age)) == 0 ) {
+                c->m_seq_dup++;
+                return;
+            }
+            *missed &= ~(1ULL << age);
+        }
+        /* a late packet, it was counted as a drop */
+        c->m_seq_ooo++;
+        if ( c->m_seq_drop ) {
+            c->m_seq_drop--;
+        }
+    }
+
+    struct latency_t {
+        CHdrHistogram  m_hist;    /* nsec */
+        CJitterUint    m_jitter;  /* nsec, up to ~100msec */
+    };
+
+    TrexStreamRxCounters  m_cnt[MAX_IDS] __attribute__ ((aligned (64)));
+    uint32_t              m_next_seq[MAX_IDS][MAX_TX_CORES];
+    uint64_t              m_seq_missed[MAX_IDS][MAX_TX_CORES];
+    latency_t             m_lat[MAX_LATENCY_IDS];
+    uint64_t              m_no_sig;
+    double                m_nsec_per_tick;
+};
+
+#endif /* __TREX_STREAM_RX_STATS_H__ */
@@ -0,0 +1,149 @@
+/*
+Copyright (c) 2015-2015 Cisco Systems, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#ifndef __TREX_STREAM_TX_STATS_H__
+#define __TREX_STREAM_TX_STATS_H__
+
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include <pal_utl.h>
+
+/* tx counters of one stream */
+struct TrexStreamTxCounters {
+    uint64_t m_pkts;
+    uint64_t m_bytes;
+};
+
+/**
+ * tx counters of the streams of one DP core, indexed by the local port
+ * and the compressed DP stream id ( see TrexStream::fix_dp_stream_id )
+ *
+ * the DP core is the only writer, it counts into its own table with
+ * plain adds and publishes a copy every sync ( 1 msec ) under a sequence
+ * lock. the CP copies the published table and retries when the DP was
+ * in the middle of publishing, so neither side ever waits for the other
+ * and the DP never uses an atomic operation
+ *
+ * the counters belong to the run of the port that started with
+ * m_event_id, a CP that started a new run ignores them until the DP
+ * publishes the new run
+ *
+ * a port has MAX_STREAMS counters, the streams past it are counted
+ * together in one more counter, see snapshot()
+ */
+class TrexStreamsTxStats {
+
+public:
+    enum {
+        MAX_STREAMS = 4096,  /* per port, higher ids share the others counter */
+        NUM_PORTS   = 2
+    };
+
+    void create(){
+        memset(this, 0, sizeof(*this));
+        int i;
+        for (i=0; i<NUM_PORTS; i++) {
+            m_dp_event_id[i] = -1;
+            m_event_id[i]    = -1;
+        }
+    }
+
+    /**************************** DP side ****************************/
+
+    /* a new run of the port, zero the counters of its streams */
+    void start_port(uint8_t local_port, int event_id, uint32_t streams){
+        if ( streams > MAX_STREAMS ) {
+            streams = MAX_STREAMS;
+        }
+        memset(&m_dp[local_port][0], 0, sizeof(m_dp[local_port]));
+        m_dp_event_id[local_port] = event_id;
+        m_dp_streams[local_port]  = streams;
+    }
+
+    /* the counters the node of a stream keeps a pointer to */
+    TrexStreamTxCounters * get_counters(uint8_t local_port, uint32_t stream_id){
+        if ( stream_id >= MAX_STREAMS ) {
+            stream_id = MAX_STREAMS;
+        }
+        return (&m_dp[local_port][stream_id]);
+    }
+
+    /* copy the counters to the CP side */
+    void publish(){
+        m_seq++;
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+
+        int i;
+        for (i=0; i<NUM_PORTS; i++) {
+            m_event_id[i] = m_dp_event_id[i];
+            m_streams[i]  = m_dp_streams[i];
+            memcpy(&m_pub[i][0], &m_dp[i][0], sizeof(TrexStreamTxCounters) * m_dp_streams[i]);
+            m_pub[i][MAX_STREAMS] = m_dp[i][MAX_STREAMS];
+        }
+
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+        m_seq++;
+    }
+
+    /**************************** CP side ****************************/
+
+    /**
+     * a consistent copy of the published counters of a port, others gets
+     * the sum of the streams past MAX_STREAMS.
+     * returns false if they belong to another run
+     */
+    bool snapshot(uint8_t local_port,
+                  int event_id,
+                  std::vector<TrexStreamTxCounters> & counters,
+                  TrexStreamTxCounters & others) const {
+        while (true) {
+            uint32_t seq = __atomic_load_n(&m_seq, __ATOMIC_ACQUIRE);
+            if ( seq & 1 ) {
+                /* DP is publishing */
+                rte_pause();
+                continue;
+            }
+
+            bool     valid   = (m_event_id[local_port] == event_id);
+            uint32_t streams = m_streams[local_port];
+            if ( valid ) {
+                counters.resize(streams);
+                memcpy(counters.data(), &m_pub[local_port][0], sizeof(TrexStreamTxCounters) * streams);
+                others = m_pub[local_port][MAX_STREAMS];
+            }
+
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if ( __atomic_load_n(&m_seq, __ATOMIC_RELAXED) == seq ) {
+                return (valid);
+            }
+            rte_pause();
+        }
+    }
+
+private:
+    /* DP private */
+    TrexStreamTxCounters  m_dp[NUM_PORTS][MAX_STREAMS + 1] __attribute__ ((aligned (64)));
+    int                   m_dp_event_id[NUM_PORTS];
+    uint32_t              m_dp_streams[NUM_PORTS];
+
+    /* published, the DP writes them only inside the sequence lock */
+    volatile uint32_t     m_seq __attribute__ ((aligned (64)));
+    int                   m_event_id[NUM_PORTS];
+    uint32_t              m_streams[NUM_PORTS];
+    TrexStreamTxCounters  m_pub[NUM_PORTS][MAX_STREAMS + 1] __attribute__ ((aligned (64)));
+};
+
+#endif /* __TREX_STREAM_TX_STATS_H__ */
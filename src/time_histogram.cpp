@@ -25,6 +25,97 @@ limitations under the License.
 
 
 
+void CHdrHistogram::Reset(){
+    m_total=0;
+    m_sum=0;
+    m_max=0;
+    m_min=UINT64_MAX;
+    memset(&m_cnt[0],0,sizeof(m_cnt));
+}
+
+void CHdrHistogram::Merge(const CHdrHistogram & o){
+    int i;
+    for (i=0; i<BUCKETS; i++) {
+        m_cnt[i]+=o.m_cnt[i];
+    }
+    m_total+=o.m_total;
+    m_sum+=o.m_sum;
+    if ( o.m_max > m_max ) {
+        m_max = o.m_max;
+    }
+    if ( o.m_min < m_min ) {
+        m_min = o.m_min;
+    }
+}
+
+void CHdrHistogram::Sub(const CHdrHistogram & total,const CHdrHistogram & base){
+    int i;
+    int first=-1;
+    int last=-1;
+    for (i=0; i<BUCKETS; i++) {
+        m_cnt[i]=total.m_cnt[i]-base.m_cnt[i];
+        if (m_cnt[i]) {
+            if (first<0) {
+                first=i;
+            }
+            last=i;
+        }
+    }
+    m_total=total.m_total-base.m_total;
+    m_sum=total.m_sum-base.m_sum;
+    /* the exact min/max of the interval are not kept, use the buckets */
+    if ( first<0 ) {
+        m_max=0;
+        m_min=UINT64_MAX;
+    }else{
+        m_min=get_low(first);
+        if (m_min<total.m_min) {
+            m_min=total.m_min;
+        }
+        m_max=get_high(last);
+        if (m_max>total.m_max) {
+            m_max=total.m_max;
+        }
+    }
+}
+
+uint64_t CHdrHistogram::get_percentile(double p) const {
+    if ( m_total==0 ) {
+        return (0);
+    }
+    if ( p>100.0 ) {
+        p=100.0;
+    }
+    uint64_t need=(uint64_t)ceil(p*(double)m_total/100.0);
+    if ( need==0 ) {
+        need=1;
+    }
+    uint64_t sum=0;
+    int i;
+    for (i=0; i<BUCKETS; i++) {
+        sum+=m_cnt[i];
+        if (sum>=need) {
+            /* the highest value of the bucket, but not more than what was seen */
+            uint64_t v=get_high(i);
+            return ( v>m_max ? m_max : v );
+        }
+    }
+    return (m_max);
+}
+
+void CHdrHistogram::Dump(FILE *fd,double scale){
+    fprintf (fd," cnt        : %llu \n",(unsigned long long)m_total);
+    fprintf (fd," min        : %.1f \n",(double)get_min()*scale);
+    fprintf (fd," mean       : %.1f \n",get_mean()*scale);
+    fprintf (fd," max        : %.1f \n",(double)m_max*scale);
+    fprintf (fd," p50        : %.1f \n",(double)get_percentile(50.0)*scale);
+    fprintf (fd," p90        : %.1f \n",(double)get_percentile(90.0)*scale);
+    fprintf (fd," p99        : %.1f \n",(double)get_percentile(99.0)*scale);
+    fprintf (fd," p99.9      : %.1f \n",(double)get_percentile(99.9)*scale);
+    fprintf (fd," p99.99     : %.1f \n",(double)get_percentile(99.99)*scale);
+}
+
+
 void CTimeHistogram::Reset(){
     m_max_dt=0.0;
     m_cnt =0;
@@ -35,20 +126,9 @@ void CTimeHistogram::Reset(){
 	memset(&m_max_ar[0],0,sizeof(m_max_ar));
 	m_win_cnt=0;
 
-    int i;
-    int j;
-    for (i=0;i<HISTOGRAM_SIZE; i++) {
-        for (j=0; j<HISTOGRAM_SIZE_LOG;j++) {
-            m_hcnt[j][i]=0;
-        }
-    }
-    for (i=0;i<HISTOGRAM_SIZE; i++) {
-        for (j=0; j<HISTOGRAM_SIZE_LOG;j++) {
-            m_hcnt_shadow[j][i]=0;
-        }
-    }
-    m_cnt_shadow=0;
-    m_high_cnt_shadow=0;
+    m_hdr.Reset();
+    m_hdr_shadow.Reset();
+    m_hdr_win.Reset();
 }
 
 bool CTimeHistogram::Create(){
@@ -62,6 +142,7 @@ void CTimeHistogram::Delete(){
 bool CTimeHistogram::Add(dsec_t dt){
 
     m_cnt++;
+    m_hdr.Add(get_nsec(dt));
     if (dt < m_min_delta) {
         return false;
     }
@@ -73,33 +154,67 @@ bool CTimeHistogram::Add(dsec_t dt){
 	if ( m_max_win_dt < dt){
 		m_max_win_dt = dt;
 	}
+    return true;
+}
 
-    uint32_t d_10usec=(uint32_t)(dt*100000.0);
-    // 1 10-19 usec
-    //,2 -20-29 usec
-    //,3,
+void CTimeHistogram::merge(const CTimeHistogram & o){
+    m_cnt      += o.m_cnt;
+    m_high_cnt += o.m_high_cnt;
+    if ( m_max_dt < o.m_max_dt ){
+        m_max_dt = o.m_max_dt;
+    }
+    m_hdr.Merge(o.m_hdr);
+}
 
-    int j;
-    for (j=0; j<HISTOGRAM_SIZE_LOG; j++) {
-        uint32_t low  = d_10usec % 10;
-        uint32_t high = d_10usec / 10;
-        if (high == 0 ) {
-            if (low>0) {
-                low=low-1;
+void CTimeHistogram::clear_samples(){
+    m_cnt=0;
+    m_high_cnt=0;
+    m_max_dt=0.0;
+    m_max_win_dt=0.0;
+    m_hdr.Reset();
+}
+
+/* fold the hdr buckets back to the 10/20/../90,100/200.. usec buckets of the json */
+void CTimeHistogram::get_decades(uint64_t hcnt[HISTOGRAM_SIZE_LOG][HISTOGRAM_SIZE]){
+    memset(hcnt,0,sizeof(uint64_t)*HISTOGRAM_SIZE_LOG*HISTOGRAM_SIZE);
+    uint64_t min_nsec=get_nsec(m_min_delta);
+    int i;
+    for (i=0; i<CHdrHistogram::BUCKETS; i++) {
+        uint64_t cnt=m_hdr.get_bucket_cnt(i);
+        if (cnt==0) {
+            continue;
+        }
+        /* middle of the bucket rounded to 2 digits ( about the bucket width ),
+           the bucket edges are not on round usec values */
+        uint64_t v=(CHdrHistogram::get_low(i)+CHdrHistogram::get_high(i))/2;
+        if (v<min_nsec) {
+            continue;
+        }
+        double d=(double)v/10000.0;
+        double r=pow(10.0,floor(log10(d))-1.0);
+        uint64_t d_10usec=(uint64_t)(floor(d/r+0.5)*r+0.5);
+        int j;
+        for (j=0; j<HISTOGRAM_SIZE_LOG; j++) {
+            if (d_10usec<10) {
+                uint64_t low = (d_10usec>0)?(d_10usec-1):0;
+                hcnt[j][low]+=cnt;
+                break;
             }
-            m_hcnt[j][low]++;
-            break;
-        }else{
-            d_10usec =high;
+            d_10usec=d_10usec/10;
         }
     }
-
-    return true;
 }
 
-
 void CTimeHistogram::update(){
 
+    update_average();
+    if ( m_max_win_dt == 0.0 ) {
+        /* built by merge(), the max of the window is in the samples */
+        dsec_t d = (double)m_hdr_win.get_max()/1000000000.0;
+        if ( d >= m_min_delta ) {
+            m_max_win_dt = d;
+        }
+    }
 	m_max_ar[m_win_cnt]=m_max_win_dt;
     m_max_win_last_dt=m_max_win_dt;
 	m_max_win_dt=0.0;
@@ -107,43 +222,13 @@ void CTimeHistogram::update(){
 	if (m_win_cnt==HISTOGRAM_QUEUE_SIZE) {
 		m_win_cnt=0;
 	}
-    update_average();
 }
 
+/* average of the last interval, usec */
 double  CTimeHistogram::get_cur_average(){
-    int i,j;
-    uint64_t d_cnt;
-    uint64_t d_cnt_high;
-
-    d_cnt = m_cnt - m_cnt_shadow;
-    m_cnt_shadow =m_cnt;
-    d_cnt_high   = m_high_cnt - m_high_cnt_shadow;
-    m_high_cnt_shadow =m_high_cnt;
-
-    uint64_t low_events = d_cnt - d_cnt_high;
-    uint64_t sum= low_events;
-    double s = ((double)low_events * 5.0); 
-
-
-    for (j=0; j<HISTOGRAM_SIZE_LOG; j++) {
-        for (i=0; i<HISTOGRAM_SIZE; i++) {
-            uint64_t cnt=m_hcnt[j][i];
-            if (cnt  > 0 ) {
-                uint64_t d= cnt - m_hcnt_shadow[j][i];
-                sum += d;
-                s+= ((double)d)*1.5*get_base_usec(j,i);
-                m_hcnt_shadow[j][i] = cnt;
-            }
-        }
-    }
-
-    double c_average;
-    if ( sum > 0 ) {
-       c_average=s/(double)sum;
-    }else{
-        c_average=0.0;
-    }
-    return c_average;
+    m_hdr_win.Sub(m_hdr,m_hdr_shadow);
+    m_hdr_shadow=m_hdr;
+    return (m_hdr_win.get_mean()/1000.0);
 }
 
 void  CTimeHistogram::update_average(){
@@ -154,7 +239,7 @@ void  CTimeHistogram::update_average(){
 }
 
 dsec_t  CTimeHistogram::get_total_average(){
-    return (get_cur_average());
+    return (m_hdr.get_mean()/1000.0);
 }
 
 dsec_t  CTimeHistogram::get_average_latency(){
@@ -190,6 +275,12 @@ void CTimeHistogram::Dump(FILE *fd){
     fprintf (fd," sliding_average    : %.0f usec\n", get_average_latency());
     fprintf (fd," precent    : %.1f %%\n",(100.0*(double)m_high_cnt/(double)m_cnt));
 
+    fprintf (fd," usec \n");
+    fprintf (fd," -----------\n");
+    m_hdr.Dump(fd,1.0/1000.0);
+
+    uint64_t hcnt[HISTOGRAM_SIZE_LOG][HISTOGRAM_SIZE];
+    get_decades(hcnt);
     fprintf (fd," histogram \n");
     fprintf (fd," -----------\n");
     int i;
@@ -197,14 +288,23 @@ void CTimeHistogram::Dump(FILE *fd){
     int base=10;
     for (j=0; j<HISTOGRAM_SIZE_LOG; j++) {
         for (i=0; i<HISTOGRAM_SIZE; i++) {
-            if (m_hcnt[j][i] >0 ) {
-                fprintf (fd," h[%u]  :  %llu \n",(base*(i+1)),(unsigned long long)m_hcnt[j][i]);
+            if (hcnt[j][i] >0 ) {
+                fprintf (fd," h[%u]  :  %llu \n",(base*(i+1)),(unsigned long long)hcnt[j][i]);
             }
         }
         base=base*10;
     }
 }
 
+/* percentiles in usec */
+void CTimeHistogram::dump_json_percentiles(const CHdrHistogram & h,std::string & json){
+    json+=add_json("p50",(double)h.get_percentile(50.0)/1000.0);
+    json+=add_json("p90",(double)h.get_percentile(90.0)/1000.0);
+    json+=add_json("p99",(double)h.get_percentile(99.0)/1000.0);
+    json+=add_json("p999",(double)h.get_percentile(99.9)/1000.0);
+    json+=add_json("p9999",(double)h.get_percentile(99.99)/1000.0);
+}
+
 /*
  { "histogram" : [ {} ,{} ]  }
 
@@ -221,6 +321,18 @@ void CTimeHistogram::dump_json(std::string name,std::string & json ){
     json+=add_json("cnt",m_cnt);
     //json+=add_json("t_avg",get_total_average());
     json+=add_json("s_avg",get_average_latency());
+    json+=add_json("t_avg",get_total_average());
+    dump_json_percentiles(m_hdr,json);
+
+    json+="\"win\":{";
+    json+=add_json("cnt",m_hdr_win.get_cnt());
+    json+=add_json("avg",m_hdr_win.get_mean()/1000.0);
+    json+=add_json("max_usec",(double)m_hdr_win.get_max()/1000.0);
+    dump_json_percentiles(m_hdr_win,json);
+    json+="\"unknown\":0},";
+
+    uint64_t hcnt[HISTOGRAM_SIZE_LOG][HISTOGRAM_SIZE];
+    get_decades(hcnt);
     int i;
     int j;
     uint32_t base=10;
@@ -229,7 +341,7 @@ void CTimeHistogram::dump_json(std::string name,std::string & json ){
     bool first=true; 
     for (j=0; j<HISTOGRAM_SIZE_LOG; j++) {
         for (i=0; i<HISTOGRAM_SIZE; i++) {
-            if (m_hcnt[j][i] >0 ) {
+            if (hcnt[j][i] >0 ) {
                 if ( first ){
                     first=false;
                 }else{
@@ -237,7 +349,7 @@ void CTimeHistogram::dump_json(std::string name,std::string & json ){
                 }
                 json+="{";
                 json+=add_json("key",(base*(i+1)));
-                json+=add_json("val",m_hcnt[j][i],true);
+                json+=add_json("val",hcnt[j][i],true);
                 json+="}";
             }
         }
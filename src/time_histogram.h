@@ -30,6 +30,105 @@ limitations under the License.
 #include <string>
 
 
+/**
+ * log-linear ( HDR like ) histogram of integer values, nsec for latency.
+ * each power of two is split into 2^(SUB_BITS-1) linear buckets so the
+ * relative error of a bucket is bounded by 2^-(SUB_BITS-1) (<0.8%)
+ * for any value, from 1 nsec to a minute, with a fixed array and no alloc.
+ *
+ * recording is a clz, a shift and an add ( no loop, no divide ).
+ * two histograms with the same layout can be merged ( per core/port )
+ * and subtracted ( interval snapshot ).
+ */
+class CHdrHistogram {
+public:
+    enum {
+        SUB_BITS  = 8,
+        SUB_CNT   = (1<<SUB_BITS),
+        HALF_BITS = (SUB_BITS-1),
+        MAX_BITS  = 36,   /* 2^36 nsec ~ 68 sec, larger values are clamped */
+        BUCKETS   = ((MAX_BITS-SUB_BITS+2)<<HALF_BITS)
+    };
+
+    void Reset();
+
+    inline void Add(uint64_t v){
+        if ( odp_unlikely(v > get_max_trackable()) ) {
+            v = get_max_trackable();
+        }
+        m_cnt[get_index(v)]++;
+        m_total++;
+        m_sum += v;
+        if ( v > m_max ) {
+            m_max = v;
+        }
+        if ( v < m_min ) {
+            m_min = v;
+        }
+    }
+
+    /* add all the values of another histogram */
+    void Merge(const CHdrHistogram & o);
+
+    /* this = total - base, the values added to total since base was copied */
+    void Sub(const CHdrHistogram & total,const CHdrHistogram & base);
+
+    /* smallest value v so that p percent of the values are <= v, p in [0,100] */
+    uint64_t get_percentile(double p) const;
+
+    uint64_t get_cnt() const {
+        return (m_total);
+    }
+
+    uint64_t get_max() const {
+        return (m_max);
+    }
+
+    uint64_t get_min() const {
+        return ( m_total ? m_min : 0 );
+    }
+
+    double get_mean() const {
+        return ( m_total ? ((double)m_sum/(double)m_total) : 0.0 );
+    }
+
+    uint64_t get_bucket_cnt(uint32_t index) const {
+        return (m_cnt[index]);
+    }
+
+    static inline uint64_t get_max_trackable(){
+        return ((1ULL<<MAX_BITS)-1);
+    }
+
+    static inline uint32_t get_index(uint64_t v){
+        uint32_t shift = (63 - __builtin_clzll(v | (SUB_CNT-1))) - HALF_BITS;
+        return ((shift<<HALF_BITS) + (uint32_t)(v>>shift));
+    }
+
+    /* range of values [low,high] that share the bucket */
+    static inline uint64_t get_low(uint32_t index){
+        uint32_t g     = (index>>HALF_BITS);
+        uint32_t shift = ( g ? (g-1) : 0);
+        return ((uint64_t)(index - (shift<<HALF_BITS)) << shift);
+    }
+
+    static inline uint64_t get_high(uint32_t index){
+        uint32_t g     = (index>>HALF_BITS);
+        uint32_t shift = ( g ? (g-1) : 0);
+        return (get_low(index) + (1ULL<<shift) - 1);
+    }
+
+    void Dump(FILE *fd,double scale);
+
+private:
+    uint64_t m_total;
+    uint64_t m_sum;
+    uint64_t m_max;
+    uint64_t m_min;
+    uint64_t m_cnt[BUCKETS] ODP_ALIGNED_CACHE;
+};
+
+
 class CTimeHistogram {
 public:
     enum {
@@ -49,6 +148,11 @@ public:
     /* get average of total data */
     dsec_t get_total_average();
 
+    /* add the samples of another histogram, e.g. of another core/port.
+       the window max of a sum comes from the merged samples at update() */
+    void merge(const CTimeHistogram & o);
+    /* zero the samples, keep the sliding average and the windows of a sum */
+    void clear_samples();
 
     dsec_t  get_max_latency(){
         return (get_usec(m_max_dt));
@@ -58,6 +162,24 @@ public:
         return ( get_usec(m_max_win_last_dt) );
     }
 
+    /* percentile in usec of all the samples, p in [0,100] */
+    dsec_t  get_percentile(double p){
+        return ( (double)m_hdr.get_percentile(p)/1000.0 );
+    }
+
+    /* percentile in usec of the samples of the last update() interval */
+    dsec_t  get_percentile_last_update(double p){
+        return ( (double)m_hdr_win.get_percentile(p)/1000.0 );
+    }
+
+    const CHdrHistogram & get_hdr() const {
+        return (m_hdr);
+    }
+
+    const CHdrHistogram & get_hdr_last_update() const {
+        return (m_hdr_win);
+    }
+
     void  dump_json(std::string name,std::string & json );
 
 
@@ -65,10 +187,11 @@ private:
     uint32_t get_usec(dsec_t d);
     double  get_cur_average();
     void  update_average();
+    void  get_decades(uint64_t hcnt[HISTOGRAM_SIZE_LOG][HISTOGRAM_SIZE]);
+    void  dump_json_percentiles(const CHdrHistogram & h,std::string & json);
 
-    double get_base_usec(int j,int i){
-        double base=pow(10.0,(double)j+1.0);
-        return ( base * ((double)i+1.0) );
+    static inline uint64_t get_nsec(dsec_t d){
+        return ( d > 0.0 ? (uint64_t)(d*1000000000.0+0.5) : 0 );
     }
 
 public:
@@ -83,10 +206,9 @@ public:
     uint32_t m_win_cnt;
     dsec_t   m_max_ar[HISTOGRAM_QUEUE_SIZE];
 
-    uint64_t m_hcnt[HISTOGRAM_SIZE_LOG][HISTOGRAM_SIZE] ODP_ALIGNED_CACHE ;
-    uint64_t m_hcnt_shadow[HISTOGRAM_SIZE_LOG][HISTOGRAM_SIZE] ODP_ALIGNED_CACHE ; // this this contorl side 
-    uint64_t m_cnt_shadow;
-    uint64_t m_high_cnt_shadow;
+    CHdrHistogram m_hdr;        /* all the samples, nsec */
+    CHdrHistogram m_hdr_shadow; /* copy of m_hdr at the last update, control side */
+    CHdrHistogram m_hdr_win;    /* samples of the last update interval */
 };
 
 #endif
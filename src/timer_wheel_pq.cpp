@@ -34,6 +34,7 @@ void CTimerWheel::Dump(FILE *fd){
     DP(m_st_start);
     DP(m_st_stop);
     DP(m_st_handle);
+    DP(m_st_cascade);
     uint64_t m_active=m_st_alloc-m_st_free;
     DP(m_active);
 }
@@ -46,6 +47,7 @@ void CTimerWheel::dump_json(std::string & json ){
     DP_J(m_st_start);
     DP_J(m_st_stop);
     DP_J(m_st_handle);
+    DP_J(m_st_cascade);
     uint64_t m_active=m_st_alloc-m_st_free;
     /* MUST BE LAST */
     DP_J_LAST(m_active);
@@ -54,136 +56,326 @@ void CTimerWheel::dump_json(std::string & json ){
 
 
 
+CTimerWheel::CTimerWheel(double tick_sec){
+    assert(tick_sec > 0.0);
+    m_tick_inv = 1.0 / tick_sec;
+    m_cur_tick = 0;
+    m_active = 0;
+    m_firing = false;
+    int i,j;
+    for (i=0; i<TW_LEVELS; i++) {
+        for (j=0; j<TW_LEVEL_SIZE; j++) {
+            m_buckets[i][j].init_head();
+        }
+        for (j=0; j<TW_LEVEL_WORDS; j++) {
+            m_bitmap[i][j]=0;
+        }
+    }
+    m_st_alloc=0;
+    m_st_free=0;
+    m_st_start=0;
+    m_st_stop=0;
+    m_st_handle=0;
+    m_st_cascade=0;
+}
+
+
+/* move all the timers of a bucket to list */
+static inline void tw_splice(CFlowTimerLink * head,
+                             CFlowTimerLink * list){
+    list->m_next = head->m_next;
+    list->m_prev = head->m_prev;
+    list->m_next->m_prev = list;
+    list->m_prev->m_next = list;
+    head->init_head();
+}
+
+/* take the first timer out of a list without touching the wheel */
+static inline CFlowTimerHandle * tw_pop_front(CFlowTimerLink * list){
+    CFlowTimerLink * l = list->m_next;
+    list->m_next = l->m_next;
+    l->m_next->m_prev = list;
+    return (static_cast<CFlowTimerHandle *>(l));
+}
+
+
+void CTimerWheel::link(CFlowTimerHandle * timer){
+    uint64_t tick = tick_of(timer->m_time);
+    int      level;
+    uint32_t slot;
+
+    if ( m_firing && (tick <= m_cur_tick) ) {
+        /* re-armed by a callback, the bucket being fired must not get it back */
+        tick = m_cur_tick + 1;
+    }
+
+    if ( tick <= m_cur_tick ) {
+        /* already due, goes to the current bucket */
+        level = 0;
+        slot  = (uint32_t)m_cur_tick & TW_LEVEL_MASK;
+    }else{
+        level = (63 - __builtin_clzll(tick ^ m_cur_tick)) / TW_LEVEL_BITS;
+        if ( level >= TW_LEVELS ) {
+            /* beyond the wheel, the top level wraps around */
+            level = TW_LEVELS - 1;
+        }
+        slot = (uint32_t)(tick >> (TW_LEVEL_BITS * level)) & TW_LEVEL_MASK;
+    }
+    link_bucket(timer, level, slot);
+}
+
+
+void CTimerWheel::link_bucket(CFlowTimerHandle * timer, int level, uint32_t slot){
+    CFlowTimerLink * head = &m_buckets[level][slot];
+    timer->m_next = head;
+    timer->m_prev = head->m_prev;
+    head->m_prev->m_next = timer;
+    head->m_prev = timer;
+    m_bitmap[level][slot >> 6] |= (1ULL << (slot & 63));
+    timer->m_level = (uint8_t)level;
+    timer->m_slot  = (uint8_t)slot;
+}
+
+
+void CTimerWheel::unlink(CFlowTimerHandle * timer){
+    timer->m_prev->m_next = timer->m_next;
+    timer->m_next->m_prev = timer->m_prev;
+    timer->m_next = 0;
+    timer->m_prev = 0;
+
+    CFlowTimerLink * head = &m_buckets[timer->m_level][timer->m_slot];
+    if ( head->is_empty_head() ) {
+        m_bitmap[timer->m_level][timer->m_slot >> 6] &= ~(1ULL << (timer->m_slot & 63));
+    }
+}
+
+
 void CTimerWheel::restart_timer(CFlowTimerHandle *  timer, 
 	double new_time){
 
-
     m_st_start++;
-	if (timer->m_timer == 0){
-		/* first time add the new time*/
-		CFlowTimer * t = new CFlowTimer();
+    if ( timer->is_running() ) {
+        unlink(timer);
+    }else{
+        m_active++;
         m_st_alloc++;
-		t->m_time = new_time;
-		t->m_flow = timer;
-		timer->m_timer = t;
-		m_pq.push(t);
-	}
-	else{
-		CFlowTimer * t = timer->m_timer;
-		if (new_time > t->m_time){
-			t->m_updated_time = new_time;
-		}else{
-			t->m_flow = 0;/* kill old when it timout  */
-			CFlowTimer * t = new CFlowTimer(); /* alloc new one */
-            m_st_alloc++;
-			t->m_time = new_time;
-			t->m_flow = timer;
-			timer->m_timer = t;
-			m_pq.push(t);
-		}
-   }
+    }
+    timer->m_time = new_time;
+    link(timer);
 }
 
 void CTimerWheel::stop_timer(CFlowTimerHandle *  timer){
 
-	CFlowTimer * t = timer->m_timer;
-	if (t){
+	if ( timer->is_running() ){
         m_st_stop++;
-		t->m_flow = 0; 
-		timer->m_timer = 0;
+        unlink(timer);
+        m_active--;
+        m_st_free++;
 	}
-};
+}
 
 
+void CTimerWheel::fire(CFlowTimerHandle * timer){
+    unlink(timer);
+    m_active--;
+    m_st_free++;
+    m_st_handle++;
+    if ( timer->m_callback ){
+        timer->m_callback(timer);
+    }
+}
 
-bool  CTimerWheel::peek_top_time(double & time){
 
-	while (!m_pq.empty()) {
-		CFlowTimer * timer = m_pq.top();
-		if (!timer->is_valid()){
-			m_pq.pop();
-            m_st_free++;
-			delete timer;
-		}
-		else{
-			if (timer->m_updated_time > 0.0 && (timer->m_updated_time > timer->m_time )) {
-				timer->m_time = timer->m_updated_time;
-				m_pq.pop();
-				m_pq.push(timer);
-
-			} else{
-				assert(timer->m_flow);
-                time=   timer->m_time;
-                return (true);
-			}
-		}
-	}
+/* first non empty bucket >= start, when wrap is set continue from zero up to start */
+bool CTimerWheel::find_slot(int level, uint32_t start, bool wrap, uint32_t & slot){
+    uint32_t w    = start >> 6;
+    uint64_t bits = m_bitmap[level][w] & (~0ULL << (start & 63));
+    int i;
+
+    for (i=0; i<TW_LEVEL_WORDS; i++) {
+        if ( bits ) {
+            slot = (w << 6) + __builtin_ctzll(bits);
+            return (true);
+        }
+        if ( ++w == TW_LEVEL_WORDS ) {
+            if ( !wrap ) {
+                return (false);
+            }
+            w = 0;
+        }
+        bits = m_bitmap[level][w];
+    }
+    /* back to the first word, only the bits before start */
+    bits &= ~(~0ULL << (start & 63));
+    if ( bits ) {
+        slot = (w << 6) + __builtin_ctzll(bits);
+        return (true);
+    }
     return (false);
 }
 
-void CTimerWheel::drain_all(void){
 
-    double tw_time;
-    while (true) {
-        if ( peek_top_time(tw_time) ){
-                handle();
-        }else{
-            break;
-        }
+/* the current tick got to this bucket, spread its timers to the lower levels */
+void CTimerWheel::cascade(int level, uint32_t slot){
+    CFlowTimerLink list;
+
+    tw_splice(&m_buckets[level][slot], &list);
+    m_bitmap[level][slot >> 6] &= ~(1ULL << (slot & 63));
+
+    while ( !list.is_empty_head() ) {
+        link(tw_pop_front(&list));
+        m_st_cascade++;
     }
 }
 
 
-void CTimerWheel::try_handle_events(double now){
-    double min_time;
-    while (true) {
-        if ( peek_top_time(min_time) ){
-            if (min_time < now ) {
-                handle();
-            }else{
+/**
+ * advance the current tick to the first level 0 bucket that has timers,
+ * cascading the higher levels on the way, but not beyond limit.
+ * return true and its tick if there is one
+ */
+bool CTimerWheel::next_due_tick(uint64_t limit, uint64_t & tick){
+    uint32_t slot;
+
+    while ( m_active ) {
+
+        if ( find_slot(0, (uint32_t)m_cur_tick & TW_LEVEL_MASK, false, slot) ) {
+            tick = (m_cur_tick & ~(uint64_t)TW_LEVEL_MASK) | slot;
+            return ( tick <= limit );
+        }
+
+        int      level;
+        uint64_t next = 0;
+        for (level=1; level<TW_LEVELS; level++) {
+            int      shift    = TW_LEVEL_BITS * level;
+            uint32_t cur_slot = (uint32_t)(m_cur_tick >> shift) & TW_LEVEL_MASK;
+            bool     top      = (level == TW_LEVELS - 1);
+
+            if ( !top && (cur_slot == TW_LEVEL_MASK) ) {
+                continue;
+            }
+            if ( find_slot(level, (cur_slot + 1) & TW_LEVEL_MASK, top, slot) ) {
+                uint64_t base = m_cur_tick >> (shift + TW_LEVEL_BITS);
+                if ( slot <= cur_slot ) {
+                    /* top level wrapped */
+                    base++;
+                }
+                next = (base << (shift + TW_LEVEL_BITS)) | ((uint64_t)slot << shift);
                 break;
             }
+        }
+        assert(level < TW_LEVELS);
+        if ( level == TW_LEVELS ) {
+            return (false);
+        }
+
+        if ( next > limit ) {
+            return (false);
+        }
+        m_cur_tick = next;
+        cascade(level, slot);
+    }
+    return (false);
+}
+
+
+/* expire the current bucket, all of it or only the timers before now.
+ * the bucket is detached before the walk, a callback that re-arms a timer
+ * at or before the current tick gets it on the next tick, see link()
+ */
+void CTimerWheel::fire_slot(double now, bool all){
+    uint32_t         slot = (uint32_t)m_cur_tick & TW_LEVEL_MASK;
+    CFlowTimerLink * head = &m_buckets[0][slot];
+
+    if ( head->is_empty_head() ) {
+        return;
+    }
+    CFlowTimerLink list;
+    tw_splice(head, &list);
+    m_bitmap[0][slot >> 6] &= ~(1ULL << (slot & 63));
+
+    m_firing = true;
+    while ( !list.is_empty_head() ) {
+        CFlowTimerHandle * timer = static_cast<CFlowTimerHandle *>(list.m_next);
+        if ( all || (timer->m_time < now) ) {
+            fire(timer);
         }else{
-            break;
+            /* not due yet, back to this bucket */
+            link_bucket(tw_pop_front(&list), 0, slot);
         }
     }
+    m_firing = false;
 }
 
 
-bool CTimerWheel::handle(){
+CFlowTimerHandle * CTimerWheel::top_timer(){
+    uint64_t tick;
 
-    while (!m_pq.empty()) {
-        CFlowTimer * timer = m_pq.top();
-        if (!timer->is_valid()){
-            m_pq.pop();
-            m_st_free++;
-            delete timer;
+    if ( !next_due_tick(UINT64_MAX, tick) ) {
+        return ((CFlowTimerHandle *)0);
+    }
+    m_cur_tick = tick;
+
+    CFlowTimerLink * head = &m_buckets[0][(uint32_t)m_cur_tick & TW_LEVEL_MASK];
+    CFlowTimerHandle * top = static_cast<CFlowTimerHandle *>(head->m_next);
+    CFlowTimerLink * l;
+    for (l = top->m_next; l != head; l = l->m_next) {
+        CFlowTimerHandle * timer = static_cast<CFlowTimerHandle *>(l);
+        if ( timer->m_time < top->m_time ) {
+            top = timer;
         }
-        else{
-            if (timer->m_updated_time > 0.0 && (timer->m_updated_time > timer->m_time ) ) {
-                timer->m_time = timer->m_updated_time;
-                m_pq.pop();
-                m_pq.push(timer);
-
-            } else{
-                assert(timer->m_flow);
-                CFlowTimerHandle *	flow =timer->m_flow;
-                m_st_handle++;
-
-                timer->m_flow=0;/* stop the timer */
-                flow->m_timer=0;
-
-                if ( flow->m_callback ){
-                    flow->m_callback(flow);
-                }
+    }
+    return (top);
+}
 
-                m_pq.pop();
-                m_st_free++;
-                delete timer;
-                return(true);
-            }
+
+bool  CTimerWheel::peek_top_time(double & time){
+    CFlowTimerHandle * top = top_timer();
+    if ( top ) {
+        time = top->m_time;
+        return (true);
+    }
+    return (false);
+}
+
+void CTimerWheel::drain_all(void){
+    uint64_t tick;
+
+    while ( next_due_tick(UINT64_MAX, tick) ) {
+        m_cur_tick = tick;
+        fire_slot(0.0, true);
+    }
+}
+
+
+void CTimerWheel::try_handle_events(double now){
+    uint64_t target = tick_of(now);
+    uint64_t tick;
+
+    if ( target <= m_cur_tick ) {
+        fire_slot(now, false);
+        return;
+    }
+
+    while ( next_due_tick(target, tick) ) {
+        m_cur_tick = tick;
+        if ( tick < target ) {
+            fire_slot(now, true);
+        }else{
+            fire_slot(now, false);
+            return;
         }
     }
+    m_cur_tick = target;
+}
+
+
+bool CTimerWheel::handle(){
+    CFlowTimerHandle * top = top_timer();
+    if ( top ) {
+        fire(top);
+        return (true);
+    }
     return(false);
 }
 
@@ -33,79 +33,77 @@ limitations under the License.
 
 
 class CFlowTimerHandle;
+typedef void(*CallbackType_t)(CFlowTimerHandle * timer_handle);
 
-struct CFlowTimer  {
-public:
-	CFlowTimer(){
-		m_updated_time = -1.0;
-
-	}
-	/* C1 */
-    /* time to expire */
-	double              m_time;
-    /* time when timer was updated */
-	double              m_updated_time;
-
-	CFlowTimerHandle *	m_flow; /* back pointer to the flow */
-
-	bool is_valid(){
-		return (m_flow ? true : false);
-	}
-
-public:
-	bool operator <(const CFlowTimer * rsh) const {
-		return (m_time<rsh->m_time);
-	}
-	bool operator ==(const CFlowTimer * rsh) const {
-		return (m_time == rsh->m_time);
-	}
-	bool operator >(const CFlowTimer * rsh) const {
-		return (m_time>rsh->m_time);
-	}
-
-};
+/* intrusive double link list, a bucket head points to itself when empty */
+struct CFlowTimerLink {
+    CFlowTimerLink *    m_next;
+    CFlowTimerLink *    m_prev;
 
-struct CFlowTimerCompare
-{
-	bool operator() (const CFlowTimer * lhs, const CFlowTimer * rhs)
-	{
-		return lhs->m_time > rhs->m_time;
-	}
+    void init_head(){
+        m_next = this;
+        m_prev = this;
+    }
+    bool is_empty_head() const {
+        return (m_next == this);
+    }
 };
 
-class CFlowTimerHandle;
-typedef void(*CallbackType_t)(CFlowTimerHandle * timer_handle);
-
-class CFlowTimerHandle {
+class CFlowTimerHandle : public CFlowTimerLink {
 public:
 	CFlowTimerHandle(){
-		m_timer = 0;
+        m_next = 0;
+        m_prev = 0;
+        m_time = 0.0;
 		m_object = 0;
         m_object1=0;
 		m_callback = 0;
 		m_id = 0;
+        m_level = 0;
+        m_slot = 0;
 	}
-	CFlowTimer *	m_timer;
+
+    /* linked into the wheel */
+    bool is_running() const {
+        return (m_next ? true : false);
+    }
+
+	double          m_time;  /* time to expire */
 	void *			m_object;
     void *			m_object1;
 	CallbackType_t  m_callback; 
 	uint32_t		m_id;
+    uint8_t         m_level; /* bucket of the wheel, valid while running */
+    uint8_t         m_slot;
 };
 
-typedef CFlowTimer * timer_handle_t;
-
-typedef std::priority_queue<CFlowTimer *, std::vector<CFlowTimer *>, CFlowTimerCompare> tw_pqueue_t;
-
+#define TW_DEFAULT_TICK_SEC  (0.001)
+
+/**
+ * hierarchical timer wheel
+ *
+ * time is cut into ticks, level k has a bucket per 2^(8*k) ticks. a timer
+ * is linked into the level of the highest byte its tick differs from the
+ * current tick, so start/stop/restart are O(1). when the current tick gets
+ * to a bucket of level k > 0 the bucket is cascaded into the lower levels.
+ * bitmaps of the non empty buckets are used to skip idle ticks.
+ *
+ * timers in the same tick expire together, in no specific order.
+ * peek_top_time/handle scan the first bucket for the exact earliest timer
+ */
 class CTimerWheel {
 
 public:
-    CTimerWheel(){
-      m_st_alloc=0;
-      m_st_free=0;
-      m_st_start=0;
-      m_st_stop=0;
-      m_st_handle=0;
-    }
+    enum {
+        TW_LEVELS      = 4,
+        TW_LEVEL_BITS  = 8,
+        TW_LEVEL_SIZE  = (1 << TW_LEVEL_BITS),
+        TW_LEVEL_MASK  = (TW_LEVEL_SIZE - 1),
+        TW_LEVEL_WORDS = (TW_LEVEL_SIZE / 64)
+    };
+
+    CTimerWheel(double tick_sec = TW_DEFAULT_TICK_SEC);
+
 public:
 	void restart_timer(CFlowTimerHandle *  timer,double new_time);
 	void stop_timer(CFlowTimerHandle *  timer);
@@ -119,14 +117,37 @@ public:
     void dump_json(std::string & json );
 
 private:
-	tw_pqueue_t   m_pq;
+    inline uint64_t tick_of(double time) const {
+        return ( time > 0.0 ? (uint64_t)(time * m_tick_inv) : 0 );
+    }
+
+    void link(CFlowTimerHandle * timer);
+    void link_bucket(CFlowTimerHandle * timer, int level, uint32_t slot);
+    void unlink(CFlowTimerHandle * timer);
+    void fire(CFlowTimerHandle * timer);
+    bool find_slot(int level, uint32_t start, bool wrap, uint32_t & slot);
+    void cascade(int level, uint32_t slot);
+    bool next_due_tick(uint64_t limit, uint64_t & tick);
+    void fire_slot(double now, bool all);
+    CFlowTimerHandle * top_timer();
+
+private:
+    double          m_tick_inv;
+    uint64_t        m_cur_tick;
+    CFlowTimerLink  m_buckets[TW_LEVELS][TW_LEVEL_SIZE];
+    uint64_t        m_bitmap[TW_LEVELS][TW_LEVEL_WORDS];
+    uint32_t        m_active;  /* timers linked into the wheel, the m_st_* are only statistics */
+    bool            m_firing;  /* in a callback of fire_slot, due timers go to the next tick */
+
 public:
 
+    /* alloc/free count timers linked into/out of the wheel */
     uint32_t   m_st_alloc;
     uint32_t   m_st_free;
     uint32_t   m_st_start;
     uint32_t   m_st_stop;
     uint32_t   m_st_handle;
+    uint32_t   m_st_cascade;
 
 };
 
@@ -52,6 +52,126 @@ void CServerPool::Create(IP_DIST_t  dist_value,
 
 
 
+void CClientPortAlloc::Create(uint32_t num_clients, bool is_tracking) {
+    Delete();
+    m_num = num_clients;
+    m_is_tracking = is_tracking;
+    if (is_tracking) {
+        m_range = MAX_PORT - MIN_PORT;
+        m_base.resize(num_clients, 0);
+        m_inuse.resize(num_clients, 0);
+        m_window.resize(num_clients, 0);
+        m_block.resize(num_clients, PA_NO_BLOCK);
+    } else {
+        m_range = MAX_PORT - MIN_PORT + 1;
+    }
+    m_head.resize(num_clients, 0);
+}
+
+void CClientPortAlloc::Delete() {
+    for (int i=0; i<m_blocks.size(); i++) {
+        delete [] m_blocks[i];
+    }
+    m_blocks.clear();
+    m_free_blocks.clear();
+    m_head.clear();
+    m_base.clear();
+    m_inuse.clear();
+    m_window.clear();
+    m_block.clear();
+    m_num = 0;
+}
+
+void CClientPortAlloc::return_all_ports() {
+    std::fill(m_head.begin(), m_head.end(), 0);
+    if (!m_is_tracking) {
+        return;
+    }
+    for (uint32_t c=0; c<m_num; c++) {
+        if (m_block[c] != PA_NO_BLOCK) {
+            release(c);
+        }
+    }
+    std::fill(m_inuse.begin(), m_inuse.end(), 0);
+    std::fill(m_window.begin(), m_window.end(), 0);
+}
+
+/* move the window of client c to a bitmap block */
+void CClientPortAlloc::promote(uint32_t c) {
+    uint32_t id;
+    if (m_free_blocks.size()) {
+        id = m_free_blocks.back();
+        m_free_blocks.pop_back();
+    } else {
+        id = m_blocks.size();
+        m_blocks.push_back(new uint64_t[PA_BLK_WORDS]);
+    }
+    uint64_t * l0 = m_blocks[id];
+    uint64_t * l1 = l0 + PA_L0_WORDS;
+    memset(l0, 0, sizeof(uint64_t) * PA_BLK_WORDS);
+    /* words past the last one are marked full */
+    for (uint32_t w = PA_L0_WORDS; w < PA_L1_WORDS * 64; w++) {
+        l1[w >> 6] |= (1ULL << (w & 63));
+    }
+
+    uint64_t win = m_window[c];
+    while (win) {
+        uint32_t b = __builtin_ctzll(win);
+        win &= win - 1;
+        uint16_t p = wrap(m_base[c] + b);
+        l0[p >> 6] |= (1ULL << (p & 63));
+    }
+    for (uint32_t w = 0; w < PA_L0_WORDS; w++) {
+        if (l0[w] == ~0ULL) {
+            l1[w >> 6] |= (1ULL << (w & 63));
+        }
+    }
+    m_window[c] = 0;
+    m_block[c] = id;
+}
+
+/* client c has no ports in use, back to the window */
+void CClientPortAlloc::release(uint32_t c) {
+    m_free_blocks.push_back(m_block[c]);
+    m_block[c] = PA_NO_BLOCK;
+    m_window[c] = 0;
+}
+
+/* first free port at or after start, wrapping around */
+uint16_t CClientPortAlloc::alloc_block(uint32_t c, uint16_t start) {
+    uint64_t * l0 = m_blocks[m_block[c]];
+    uint64_t * l1 = l0 + PA_L0_WORDS;
+    uint32_t w = start >> 6;
+    uint64_t bits = ~l0[w] & (~0ULL << (start & 63));
+
+    if (!bits) {
+        /* next word that is not full, the search wraps back to w */
+        uint32_t from = w + 1;
+        uint32_t k = from >> 6;
+        uint64_t m = (k < PA_L1_WORDS) ? (~l1[k] & (~0ULL << (from & 63))) : 0;
+        uint32_t i;
+        for (i = 0; (m == 0) && (i < PA_L1_WORDS); i++) {
+            k = (k + 1) % PA_L1_WORDS;
+            m = ~l1[k];
+        }
+        if (m == 0) {
+            m_head[c] = 0;
+            return (ILLEGAL_PORT);
+        }
+        w = (k << 6) + __builtin_ctzll(m);
+        bits = ~l0[w];
+    }
+
+    uint16_t p = (w << 6) + __builtin_ctzll(bits);
+    l0[w] |= (1ULL << (p & 63));
+    if (l0[w] == ~0ULL) {
+        l1[w >> 6] |= (1ULL << (w & 63));
+    }
+    m_inuse[c]++;
+    m_head[c] = next(p);
+    return (p + MIN_PORT);
+}
+
 void CClientPool::Create(IP_DIST_t  dist_value,
             uint32_t min_ip,
             uint32_t max_ip,
@@ -73,54 +193,46 @@ void CClientPool::Create(IP_DIST_t  dist_value,
                 avail_ip--;
             }
         }
-    }
-    if (avail_ip!=0) {
-        m_ip_info.resize(avail_ip);
     } else {
+        has_mac_map = false;
+    }
+    if (avail_ip==0) {
         printf("\n Error, empty mac file is configured.\n"
                "Will ignore the mac file configuration.\n");
-        m_ip_info.resize(total_ip);
+        has_mac_map = false;
+        avail_ip = total_ip;
     }
 
-    if (total_ip > ((l_flow*t_cps/MAX_PORT))) {
-        if (has_mac_map) {
-            for(int idx=0;idx<total_ip;idx++){
-                mac_addr_align_t *mac_adr = NULL;
-                mac_adr = mac_info->get_mac_addr_by_ip( min_ip+idx);
-                if (mac_adr != NULL) {
-                    m_ip_info[idx] = new CClientInfoL(has_mac_map);
-                    m_ip_info[idx]->set_ip(min_ip+idx);
-                    m_ip_info[idx]->set_mac(mac_adr);
-                }
-            }
-        } else {
-            for(int idx=0;idx<total_ip;idx++){
-                m_ip_info[idx] = new CClientInfoL(has_mac_map);
-                m_ip_info[idx]->set_ip(min_ip+idx);
+    m_ips.reserve(avail_ip);
+    if (has_mac_map) {
+        m_macs.reserve(avail_ip);
+        for(int idx=0;idx<total_ip;idx++){
+            mac_addr_align_t *mac_adr = NULL;
+            mac_adr = mac_info->get_mac_addr_by_ip(min_ip+idx);
+            if (mac_adr != NULL) {
+                m_ips.push_back(min_ip+idx);
+                m_macs.push_back(*mac_adr);
             }
-        } 
+        }
     } else {
-        if (has_mac_map) {
-            for(int idx=0;idx<total_ip;idx++){
-                mac_addr_align_t *mac_adr = NULL;
-                mac_adr = mac_info->get_mac_addr_by_ip(min_ip+idx);
-                if (mac_adr != NULL) {
-                    m_ip_info[idx] = new CClientInfo(has_mac_map);
-                    m_ip_info[idx]->set_ip(min_ip+idx);
-                    m_ip_info[idx]->set_mac(mac_adr);
-                }
-            }
-        } else {
-            for(int idx=0;idx<total_ip;idx++){
-                m_ip_info[idx] = new CClientInfo(has_mac_map);
-                m_ip_info[idx]->set_ip(min_ip+idx);
-            }
-        } 
- 
+        for(int idx=0;idx<total_ip;idx++){
+            m_ips.push_back(min_ip+idx);
+        }
     }
+
+    /* type 2 when there are enough clients, see TYPE1/TYPE2 */
+    bool is_tracking = !(total_ip > ((l_flow*t_cps/MAX_PORT)));
+    m_ports.Create(m_ips.size(), is_tracking);
+
     m_tcp_aging = tcp_aging;
     m_udp_aging = udp_aging;
-    CreateBase();
+    CreateIdx(m_ips.size());
+}
+
+void CClientPool::Delete() {
+    m_ports.Delete();
+    m_ips.clear();
+    m_macs.clear();
 }
 
 
@@ -200,7 +312,7 @@ void CTupleGenPoolYaml::Dump(FILE *fd){
     fprintf(fd,"  udp aging       : %d sec \n",m_udp_aging_sec);
 }
 
-bool CTupleGenPoolYaml::is_valid(uint32_t num_threads,bool is_plugins){
+bool CTupleGenPoolYaml::is_valid(uint32_t num_threads,bool is_plugins,uint32_t max_ips){
     if ( m_ip_start > m_ip_end ){
         printf(" ERROR The ip_start must be bigger than ip_end \n");
         return(false);
@@ -212,8 +324,8 @@ bool CTupleGenPoolYaml::is_valid(uint32_t num_threads,bool is_plugins){
         return (false);
     }
 
-    if (ips > 1000000) {
-        printf("  The number of clients requested is %d maximum supported : %d \n",ips,1000000);
+    if (ips > max_ips) {
+        printf("  The number of ips requested is %d maximum supported : %d \n",ips,max_ips);
         return (false);
     }
     return (true);
@@ -337,11 +449,11 @@ void operator >> (const YAML::Node& node, CTupleGenYamlInfo & fi) {
 
 bool CTupleGenYamlInfo::is_valid(uint32_t num_threads,bool is_plugins){
     for (int i=0;i<m_client_pool.size();i++) {
-        if (m_client_pool[i].is_valid(num_threads, is_plugins)==false) 
+        if (m_client_pool[i].is_valid(num_threads, is_plugins, MAX_CLIENTS)==false) 
             return false;
     }
     for (int i=0;i<m_server_pool.size();i++) {
-        if (m_server_pool[i].is_valid(num_threads, is_plugins)==false) 
+        if (m_server_pool[i].is_valid(num_threads, is_plugins, MAX_SERVERS)==false) 
             return false;
     }
 
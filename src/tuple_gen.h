@@ -39,7 +39,7 @@ limitations under the License.
 #include <yaml-cpp/yaml.h>
 #include <mac_mapping.h>
 
-#include <random>
+#include "utl_rand.h"
 
 class CTupleBase {
 public:
@@ -133,7 +133,10 @@ private:
 /*
  * Class that handle the client info
  */
-#define MAX_CLIENTS 1000000
+/* a client is ~20 bytes of CClientPortAlloc arrays, a server is still a
+ * CIpInfoBase object */
+#define MAX_CLIENTS 10000000
+#define MAX_SERVERS 1000000
 #define MAX_PORT (64000)
 #define MIN_PORT (1024)
 #define ILLEGAL_PORT (0)
@@ -385,10 +388,219 @@ class CServerInfoL : public CIpInfoL {
     }
 };
 
+/*
+ * port allocator for all the clients of a pool, a struct of arrays keyed by
+ * the client index instead of an object ( and a 64K bitmap ) per client.
+ *
+ * in tracking mode ( type 1 ) each client keeps a 64 port window starting
+ * at its oldest port in use, ports are allocated from the head and the window
+ * slides when the oldest ports are returned. a client that has more than 64
+ * ports in flight ( or a hole older than 64 ports ) is promoted to a
+ * two level bitmap block, scanned with ctz, that goes back to a shared free
+ * list when the client has no ports in use. memory is ~20 bytes per client
+ * plus ~8KB per promoted client.
+ *
+ * in counter mode ( type 2 ) only the head is kept, like CIpInfoL
+ */
+class CClientPortAlloc {
+public:
+    enum {
+        PA_WIN_BITS   = 64,
+        PA_L0_WORDS   = ((MAX_PORT - MIN_PORT) + 63) / 64,
+        PA_L1_WORDS   = (PA_L0_WORDS + 63) / 64,
+        PA_BLK_WORDS  = PA_L0_WORDS + PA_L1_WORDS,
+        PA_NO_BLOCK   = 0xffffffff
+    };
+
+    CClientPortAlloc(){
+        m_num = 0;
+        m_is_tracking = false;
+        m_range = 0;
+    }
+    ~CClientPortAlloc(){
+        Delete();
+    }
+
+    void Create(uint32_t num_clients, bool is_tracking);
+    void Delete();
+
+    inline uint16_t get_new_free_port(uint32_t c){
+        uint16_t h = m_head[c];
+        if ( !m_is_tracking ) {
+            m_head[c] = next(h);
+            return (h + MIN_PORT);
+        }
+        if ( m_block[c] != PA_NO_BLOCK ) {
+            return (alloc_block(c, h));
+        }
+        if ( m_inuse[c] == 0 ) {
+            m_base[c]   = h;
+            m_window[c] = 1;
+            m_inuse[c]  = 1;
+            m_head[c]   = next(h);
+            return (h + MIN_PORT);
+        }
 
+        uint64_t w   = m_window[c];
+        uint32_t off = dist(m_base[c], h);
+        if ( off >= PA_WIN_BITS ) {
+            /* slide the window to the oldest port in use */
+            uint32_t s = __builtin_ctzll(w);
+            w >>= s;
+            off -= s;
+            m_base[c]   = wrap(m_base[c] + s);
+            m_window[c] = w;
+        }
+        if ( off < PA_WIN_BITS ) {
+            uint64_t free_bits = ~w & (~0ULL << off);
+            if ( free_bits ) {
+                uint32_t b = __builtin_ctzll(free_bits);
+                m_window[c] = w | (1ULL << b);
+                m_inuse[c]++;
+                uint16_t port = wrap(m_base[c] + b);
+                m_head[c] = next(port);
+                return (port + MIN_PORT);
+            }
+        }
+        promote(c);
+        return (alloc_block(c, h));
+    }
 
+    inline void return_port(uint32_t c, uint16_t port){
+        if ( !m_is_tracking ) {
+            return;
+        }
+        assert(is_port_legal(port));
+        assert(m_inuse[c] > 0);
+        uint16_t p = port - MIN_PORT;
+
+        if ( m_block[c] != PA_NO_BLOCK ) {
+            uint64_t * l0 = m_blocks[m_block[c]];
+            uint64_t * l1 = l0 + PA_L0_WORDS;
+            assert(l0[p >> 6] & (1ULL << (p & 63)));
+            l0[p >> 6] &= ~(1ULL << (p & 63));
+            l1[p >> 12] &= ~(1ULL << ((p >> 6) & 63));
+            if ( --m_inuse[c] == 0 ) {
+                release(c);
+            }
+            return;
+        }
+        uint32_t off = dist(m_base[c], p);
+        assert(off < PA_WIN_BITS);
+        assert(m_window[c] & (1ULL << off));
+        m_window[c] &= ~(1ULL << off);
+        m_inuse[c]--;
+    }
+
+    void return_all_ports();
+
+    bool is_port_legal(uint16_t port) {
+        return ((port >= MIN_PORT) && (port < MIN_PORT + m_range));
+    }
+
+    uint16_t get_ports_in_use(uint32_t c) {
+        return (m_is_tracking ? m_inuse[c] : 0);
+    }
+
+    uint32_t get_blocks() {
+        return (m_blocks.size());
+    }
+
+    uint32_t get_free_blocks() {
+        return (m_free_blocks.size());
+    }
+
+private:
+    inline uint16_t next(uint16_t p){
+        return ((p + 1 == m_range) ? 0 : p + 1);
+    }
+    inline uint16_t wrap(uint32_t p){
+        return ((p >= m_range) ? p - m_range : p);
+    }
+    /* distance from base to p going up */
+    inline uint32_t dist(uint16_t base, uint16_t p){
+        return ((p >= base) ? p - base : p + m_range - base);
+    }
+
+    uint16_t alloc_block(uint32_t c, uint16_t start);
+    void promote(uint32_t c);
+    void release(uint32_t c);
+
+private:
+    uint32_t                m_num;
+    bool                    m_is_tracking;
+    uint16_t                m_range;    /* number of ports */
+    std::vector<uint16_t>   m_head;     /* next port to try */
+    std::vector<uint16_t>   m_base;     /* first port of the window */
+    std::vector<uint16_t>   m_inuse;
+    std::vector<uint64_t>   m_window;
+    std::vector<uint32_t>   m_block;    /* bitmap block or PA_NO_BLOCK */
+    std::vector<uint64_t *> m_blocks;
+    std::vector<uint32_t>   m_free_blocks;
+};
+
+
+
+
+/* client/server index selection of a pool */
+class CIpPoolBase {
+    public:
+        void inc_cur_idx() {
+            switch (m_dist) {
+            case cdRANDOM_DIST: 
+                m_cur_idx = get_random_idx();
+                break;
+            case cdSEQ_DIST :
+            default:
+                m_cur_idx++;
+                if (m_cur_idx >= m_total_ips)
+                    m_cur_idx = 0;
+            }
+        }
+        //return a valid client idx in this pool
+        uint32_t generate_ip() {
+            uint32_t res_idx = m_cur_idx;
+            inc_cur_idx();
+            return res_idx;
+        }
+
+        void set_dist(IP_DIST_t dist) {
+            if (dist>=cdMAX_DIST) {
+                m_dist = cdSEQ_DIST;
+            } else {
+                m_dist = dist;
+            }
+        }
 
-class CIpPool {
+    public:
+        IP_DIST_t  m_dist;
+        uint32_t m_cur_idx;
+        uint32_t m_total_ips;
+        uint32_t m_active_alloc;
+        uint32_t m_port_allocation_error;
+        uint64_t m_rand_state; /* random distribution, seeded from the run seed */
+        void CreateIdx(uint32_t total_ips) {
+            m_total_ips = total_ips;
+            switch (m_dist) {
+            case cdRANDOM_DIST:
+                utl_srand(m_rand_state, utl_rand_new_seed());
+                break;
+            default:
+                break;
+            }
+            m_cur_idx = 0;
+            m_active_alloc = 0;
+            m_port_allocation_error = 0;
+        }
+        uint32_t get_random_idx() {
+            return (utl_rand_range32(m_rand_state, m_total_ips));
+        }
+        bool IsFreePortRequired(void){
+            return(true);
+        }
+};
+
+class CIpPool : public CIpPoolBase {
     public:
        uint16_t GenerateOnePort(uint32_t idx) {
             CIpInfoBase* ip_info = m_ip_info[idx];
@@ -426,34 +638,6 @@ class CIpPool {
             return m_ip_info[idx];
         }
 
-        void inc_cur_idx() {
-            switch (m_dist) {
-            case cdRANDOM_DIST: 
-                m_cur_idx = get_random_idx();
-                break;
-            case cdSEQ_DIST :
-            default:
-                m_cur_idx++;
-                if (m_cur_idx >= m_ip_info.size())
-                    m_cur_idx = 0;
-            }
-        }
-        //return a valid client idx in this pool
-        uint32_t generate_ip() {
-            uint32_t res_idx = m_cur_idx;
-            inc_cur_idx();
-            return res_idx;
-        }
-
-            
-
-        void set_dist(IP_DIST_t dist) {
-            if (dist>=cdMAX_DIST) {
-                m_dist = cdSEQ_DIST;
-            } else {
-                m_dist = dist;
-            }
-        }
         void Delete() {
             FOREACH(m_ip_info) {
                 delete m_ip_info[i];
@@ -484,43 +668,19 @@ class CIpPool {
  
     public:
         std::vector<CIpInfoBase*> m_ip_info;
-        IP_DIST_t  m_dist;
-        uint32_t m_cur_idx;
-        uint32_t m_active_alloc;
-        uint32_t m_port_allocation_error;
-        std::default_random_engine generator;
-        std::uniform_int_distribution<int> *rand_dis;
         void CreateBase() {
-            switch (m_dist) {
-            case cdRANDOM_DIST:
-                rand_dis = new std::uniform_int_distribution<int>
-                    (0,get_total_ips()-1);
-                break;
-            default:
-                break;
-            }
-            m_cur_idx = 0;
-            m_active_alloc = 0;
-            m_port_allocation_error = 0;
+            CreateIdx(m_ip_info.size());
         }
-        uint32_t get_random_idx() {
-            uint32_t res =  (*rand_dis)(generator);
-            return (res);
-        }
-        bool IsFreePortRequired(void){
-            return(true);
-        }
-
-
 };
 
-class CClientPool : public CIpPool {
+/* clients are kept as arrays keyed by the client index, see CClientPortAlloc */
+class CClientPool : public CIpPoolBase {
 public:
 
     uint32_t GenerateTuple(CTupleBase & tuple) {
         uint32_t idx = generate_ip();
-        CIpInfoBase* ip_info = m_ip_info[idx];
-        ip_info->generate_tuple(tuple);
+        tuple.setClientTuple(m_ips[idx], get_mac(idx),
+                             m_ports.get_new_free_port(idx));
 
         tuple.setClientId(idx);
         if (tuple.getClientPort()==ILLEGAL_PORT) {
@@ -530,6 +690,55 @@ public:
         return idx;
     }
 
+    uint16_t GenerateOnePort(uint32_t idx) {
+        uint16_t port = m_ports.get_new_free_port(idx);
+        if (port==ILLEGAL_PORT) {
+            m_port_allocation_error++;
+        }
+        m_active_alloc++;
+        return (port);
+    }
+
+    void FreePort(uint32_t id, uint16_t port) {
+        m_active_alloc--;
+        m_ports.return_port(id, port);
+    }
+
+    void return_all_ports() {
+        m_ports.return_all_ports();
+    }
+
+    bool is_valid_ip(uint32_t ip){
+        if ((ip>=m_ips.front()) && (ip<=m_ips.back())) {
+            return(true);
+        }
+        printf("invalid ip:%x, min_ip:%x, max_ip:%x, this:%p\n", 
+               ip, m_ips.front(), m_ips.back(), this);
+        return(false);
+    }
+
+    uint32_t get_curr_ip() {
+        return m_ips[m_cur_idx];
+    }
+    uint32_t get_ip(uint32_t idx) {
+        return m_ips[idx];
+    }
+    mac_addr_align_t * get_curr_mac() {
+        return get_mac(m_cur_idx);
+    }
+    mac_addr_align_t *get_mac(uint32_t idx) {
+        if (m_macs.empty()) {
+            return NULL;
+        }
+        return &m_macs[idx];
+    }
+    uint32_t get_total_ips() {
+        return m_ips.size();
+    }
+    CClientPortAlloc * get_port_alloc() {
+        return &m_ports;
+    }
+
     uint16_t get_tcp_aging() {
         return m_tcp_aging;
     }
@@ -545,10 +754,15 @@ public:
                 bool has_mac_map, 
                 uint16_t tcp_aging,
                 uint16_t udp_aging); 
+    void Delete();
 
 public: 
     uint16_t m_tcp_aging;
     uint16_t m_udp_aging;
+private:
+    std::vector<uint32_t>         m_ips;
+    std::vector<mac_addr_align_t> m_macs;   /* empty when there is no mac map */
+    CClientPortAlloc              m_ports;
 };
 
 class CServerPoolBase {
@@ -868,7 +1082,7 @@ struct CTupleGenPoolYaml {
     uint32_t get_ip_start() {
         return m_ip_start;
     }
-    bool is_valid(uint32_t num_threads,bool is_plugins);
+    bool is_valid(uint32_t num_threads,bool is_plugins,uint32_t max_ips);
     void Dump(FILE *fd);
 };
    
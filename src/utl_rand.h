@@ -0,0 +1,197 @@
+#ifndef  UTL_RAND_H
+#define  UTL_RAND_H
+/*
+ Hanoh Haim
+ Cisco Systems, Inc.
+*/
+
+/*
+Copyright (c) 2015-2015 Cisco Systems, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include <stdint.h>
+
+/**
+ * xorshift64* generator, 8 bytes of state and a few instructions per value.
+ * the state is owned by the user ( a thread, the bss of a stream, a pool )
+ * so there is no lock and no sharing between cores. a state must be set
+ * by utl_srand, a zero state stays zero
+ *
+ * bounded values use Lemire's multiply and shift, there is no bias and
+ * in most cases no division
+ *
+ * all the states are derived from the seed of the run ( --seed ), the
+ * same seed gives the same values
+ */
+
+#define UTL_RAND_DEFAULT_SEED   (0x5eed5eed5eed5eedULL)
+
+/* splitmix64, spreads a seed or a counter over the whole state */
+static inline uint64_t utl_rand_mix64(uint64_t z){
+    z += 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return (z ^ (z >> 31));
+}
+
+/* any seed, including zero, gives a valid ( non zero ) state */
+static inline void utl_srand(uint64_t & state, uint64_t seed){
+    state = utl_rand_mix64(seed);
+    if ( state == 0 ) {
+        state = 0x9e3779b97f4a7c15ULL;
+    }
+}
+
+static inline uint64_t utl_rand64(uint64_t & state){
+    uint64_t x = state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    state = x;
+    return (x * 0x2545f4914f6cdd1dULL);
+}
+
+/* the high bits are the better ones */
+static inline uint32_t utl_rand32(uint64_t & state){
+    return ((uint32_t)(utl_rand64(state) >> 32));
+}
+
+/* uniform in [0,range), range of zero is the whole 2^32 */
+static inline uint32_t utl_rand_range32(uint64_t & state, uint32_t range){
+    if ( range == 0 ) {
+        return (utl_rand32(state));
+    }
+    uint64_t m = (uint64_t)utl_rand32(state) * range;
+    uint32_t l = (uint32_t)m;
+
+    if ( l < range ) {
+        /* reject the 2^32 % range low values that would bias the result */
+        uint32_t t = (uint32_t)(-range) % range;
+        while ( l < t ) {
+            m = (uint64_t)utl_rand32(state) * range;
+            l = (uint32_t)m;
+        }
+    }
+    return ((uint32_t)(m >> 32));
+}
+
+/* uniform in [0,range), range of zero is the whole 2^64 */
+static inline uint64_t utl_rand_range64(uint64_t & state, uint64_t range){
+    if ( range == 0 ) {
+        return (utl_rand64(state));
+    }
+    __uint128_t m = (__uint128_t)utl_rand64(state) * range;
+    uint64_t l = (uint64_t)m;
+
+    if ( l < range ) {
+        uint64_t t = (uint64_t)(-range) % range;
+        while ( l < t ) {
+            m = (__uint128_t)utl_rand64(state) * range;
+            l = (uint64_t)m;
+        }
+    }
+    return ((uint64_t)(m >> 64));
+}
+
+/* n values in [0,range), the same values as n calls of utl_rand_range32 */
+static inline void utl_rand_fill32(uint64_t & state, uint32_t * v, uint32_t n, uint32_t range){
+    uint64_t s = state;
+    uint32_t i;
+    for (i=0; i<n; i++) {
+        v[i] = utl_rand_range32(s, range);
+    }
+    state = s;
+}
+
+
+/* seed of the run, one per process */
+inline uint64_t & utl_rand_run_seed(){
+    static uint64_t seed = UTL_RAND_DEFAULT_SEED;
+    return (seed);
+}
+
+/* number of seeds that were given since the run seed was set */
+inline uint64_t & utl_rand_seed_cnt(){
+    static uint64_t cnt = 0;
+    return (cnt);
+}
+
+/* set the seed of the run, should be called before any generator is created */
+inline void utl_rand_set_seed(uint64_t seed){
+    utl_rand_run_seed() = seed;
+    __atomic_store_n(&utl_rand_seed_cnt(), 0, __ATOMIC_RELAXED);
+}
+
+inline uint64_t utl_rand_get_seed(){
+    return (utl_rand_run_seed());
+}
+
+/**
+ * a seed for a new generator, the n-th call after the run seed was set
+ * always returns the same value. safe to call from any thread
+ */
+inline uint64_t utl_rand_new_seed(){
+    uint64_t n = __atomic_fetch_add(&utl_rand_seed_cnt(), 1, __ATOMIC_RELAXED);
+    return (utl_rand_mix64(utl_rand_run_seed() ^ utl_rand_mix64(n)));
+}
+
+/* generator of the calling thread, seeded on the first use */
+inline uint64_t & utl_rand_thread_state(){
+    static __thread uint64_t state = 0;
+    if ( state == 0 ) {
+        utl_srand(state, utl_rand_new_seed());
+    }
+    return (state);
+}
+
+
+class CRandGen {
+
+public:
+    CRandGen(){
+        seed(utl_rand_new_seed());
+    }
+
+    void seed(uint64_t seed){
+        utl_srand(m_state, seed);
+    }
+
+    inline uint32_t rand32(){
+        return (utl_rand32(m_state));
+    }
+
+    inline uint64_t rand64(){
+        return (utl_rand64(m_state));
+    }
+
+    /* [0,range) */
+    inline uint32_t range32(uint32_t range){
+        return (utl_rand_range32(m_state, range));
+    }
+
+    inline uint64_t range64(uint64_t range){
+        return (utl_rand_range64(m_state, range));
+    }
+
+    inline void fill32(uint32_t * v, uint32_t n, uint32_t range){
+        utl_rand_fill32(m_state, v, n, range);
+    }
+
+private:
+    uint64_t m_state;
+};
+
+#endif